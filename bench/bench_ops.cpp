@@ -0,0 +1,672 @@
+// Micro-benchmarks of the CPU kernels at Qwen2 shapes.
+//
+//   xmake build llaisys-bench && xmake run llaisys-bench [options] > ops.json
+//
+// Every case calls an ops::cpu kernel directly (no tensor checks, no ctypes) and reports the
+// median time per call together with the bytes it must move and the FLOPs it must do. Those
+// are set against a roofline of this machine, measured at startup for each thread count: the
+// bandwidth of a streaming read larger than the last-level cache, and the throughput of
+// independent fp32 FMA chains. `roofline` is the attainable time over the measured time,
+// so 1.0 means the kernel runs at the machine's limit; values above 1 mean the working set
+// stayed in cache. The JSON report goes to stdout (or --json), a readable table to stderr.
+
+#include "../src/ops/argmax/cpu/argmax_cpu.hpp"
+#include "../src/ops/embedding/cpu/embedding_cpu.hpp"
+#include "../src/ops/linear/cpu/linear_cpu.hpp"
+#include "../src/ops/quantize/cpu/quantize_cpu.hpp"
+#include "../src/ops/rearrange/cpu/rearrange_cpu.hpp"
+#include "../src/ops/rms_norm/cpu/rms_norm_cpu.hpp"
+#include "../src/ops/rope/cpu/rope_cpu.hpp"
+#include "../src/ops/self_attention/cpu/self_attention_cpu.hpp"
+#include "../src/ops/swiglu/cpu/swiglu_cpu.hpp"
+#include "../src/utils.hpp"
+#include "../src/utils/cpu_features.hpp"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+using namespace llaisys;
+
+struct ModelShape {
+    const char *name;
+    size_t hs, nh, nkvh, dh, di, voc;
+};
+
+const ModelShape kModels[] = {
+    {"qwen2-0.5b", 896, 14, 2, 64, 4864, 151936},
+    {"qwen2-1.5b", 1536, 12, 2, 128, 8960, 151936},
+    {"qwen2-7b", 3584, 28, 4, 128, 18944, 152064},
+};
+
+struct Options {
+    std::vector<std::string> models{"qwen2-0.5b"};
+    std::vector<std::string> dtypes{"f32", "bf16"};
+    std::vector<std::string> wtypes{"same", "q8", "q4_32"};
+    std::vector<std::string> ops;
+    std::vector<int> threads;
+    size_t prefill = 128;
+    size_t context = 1024;
+    double min_time = 0.1;
+    size_t bw_mb = 512;
+    std::string json;
+};
+
+// 64-byte aligned scratch memory.
+class Buffer {
+public:
+    explicit Buffer(size_t bytes) : _bytes(bytes) {
+        const size_t size = (std::max<size_t>(bytes, 1) + 63) / 64 * 64;
+        _data.reset(static_cast<std::byte *>(std::aligned_alloc(64, size)));
+        if (!_data) throw std::bad_alloc();
+    }
+    std::byte *data() const { return _data.get(); }
+    size_t bytes() const { return _bytes; }
+
+private:
+    struct Free {
+        void operator()(std::byte *p) const { std::free(p); }
+    };
+    std::unique_ptr<std::byte[], Free> _data;
+    size_t _bytes;
+};
+
+using buffer_t = std::shared_ptr<Buffer>;
+
+uint64_t g_seed = 0x9E3779B97F4A7C15ull;
+
+float next_uniform() {
+    g_seed ^= g_seed << 13;
+    g_seed ^= g_seed >> 7;
+    g_seed ^= g_seed << 17;
+    return static_cast<float>(g_seed >> 40) / static_cast<float>(1 << 24);
+}
+
+// `n` values uniform in [-scale, scale) stored as `dtype`.
+buffer_t random_buffer(llaisysDataType_t dtype, size_t n, float scale = 1.0f) {
+    auto buf = std::make_shared<Buffer>(n * utils::dsize(dtype));
+    auto fill = [&](auto *p) {
+        using T = std::remove_pointer_t<decltype(p)>;
+        for (size_t i = 0; i < n; ++i) p[i] = utils::cast<T>((2.0f * next_uniform() - 1.0f) * scale);
+    };
+    switch (dtype) {
+    case LLAISYS_DTYPE_F32:
+        fill(reinterpret_cast<float *>(buf->data()));
+        break;
+    case LLAISYS_DTYPE_BF16:
+        fill(reinterpret_cast<bf16_t *>(buf->data()));
+        break;
+    case LLAISYS_DTYPE_F16:
+        fill(reinterpret_cast<fp16_t *>(buf->data()));
+        break;
+    default:
+        EXCEPTION_UNSUPPORTED_DATATYPE(dtype);
+    }
+    return buf;
+}
+
+buffer_t index_buffer(size_t n, size_t bound) {
+    auto buf = std::make_shared<Buffer>(n * sizeof(int64_t));
+    auto *p = reinterpret_cast<int64_t *>(buf->data());
+    for (size_t i = 0; i < n; ++i) p[i] = static_cast<int64_t>(next_uniform() * bound) % static_cast<int64_t>(bound);
+    return buf;
+}
+
+// [rows, cols] in `qtype`, quantized from random `dtype` values.
+buffer_t quantized_buffer(llaisysDataType_t qtype, llaisysDataType_t dtype, size_t rows, size_t cols) {
+    auto src = random_buffer(dtype, rows * cols, 0.05f);
+    auto buf = std::make_shared<Buffer>(rows * utils::row_bytes(qtype, cols));
+    ops::cpu::quantize(buf->data(), src->data(), qtype, dtype, rows, cols);
+    return buf;
+}
+
+llaisysDataType_t parse_dtype(const std::string &s) {
+    if (s == "f32") return LLAISYS_DTYPE_F32;
+    if (s == "bf16") return LLAISYS_DTYPE_BF16;
+    if (s == "f16") return LLAISYS_DTYPE_F16;
+    if (s == "q8") return LLAISYS_DTYPE_Q8;
+    if (s == "q4_32") return LLAISYS_DTYPE_Q4_32;
+    if (s == "q4_64") return LLAISYS_DTYPE_Q4_64;
+    throw std::invalid_argument("unknown dtype: " + s);
+}
+
+const char *dtype_name(llaisysDataType_t t) {
+    switch (t) {
+    case LLAISYS_DTYPE_F32:
+        return "f32";
+    case LLAISYS_DTYPE_BF16:
+        return "bf16";
+    case LLAISYS_DTYPE_F16:
+        return "f16";
+    case LLAISYS_DTYPE_Q8:
+        return "q8";
+    case LLAISYS_DTYPE_Q4_32:
+        return "q4_32";
+    case LLAISYS_DTYPE_Q4_64:
+        return "q4_64";
+    default:
+        return "?";
+    }
+}
+
+// ---- roofline probes ----
+
+int max_threads() {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+void set_threads(int n) {
+#ifdef _OPENMP
+    omp_set_num_threads(n);
+#else
+    (void)n;
+#endif
+}
+
+double seconds_since(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// Streaming read of a buffer larger than the caches, in GB/s.
+double probe_bandwidth(const Buffer &buf) {
+    const auto *p = reinterpret_cast<const float *>(buf.data());
+    const auto n = static_cast<ptrdiff_t>(buf.bytes() / sizeof(float));
+    double best = 0;
+    volatile float sink = 0;
+    for (int rep = 0; rep < 5; ++rep) {
+        const auto t0 = std::chrono::steady_clock::now();
+        float sum = 0;
+#pragma omp parallel for simd reduction(+ : sum) schedule(static)
+        for (ptrdiff_t i = 0; i < n; ++i) sum += p[i];
+        const double dt = seconds_since(t0);
+        sink = sink + sum;
+        best = std::max(best, static_cast<double>(buf.bytes()) / dt / 1e9);
+    }
+    return best;
+}
+
+// W independent multiply-add chains; enough of them to cover the FMA latency of every port.
+template <size_t W>
+[[gnu::always_inline]] inline float fma_chains(size_t iters) {
+    float acc[W];
+    for (size_t j = 0; j < W; ++j) acc[j] = 1.0f + static_cast<float>(j) * 1e-3f;
+    const float a = 0.999999f, b = 1e-7f;
+    for (size_t i = 0; i < iters; ++i) {
+#pragma omp simd
+        for (size_t j = 0; j < W; ++j) acc[j] = acc[j] * a + b;
+    }
+    float s = 0;
+    for (size_t j = 0; j < W; ++j) s += acc[j];
+    return s;
+}
+
+constexpr size_t kFmaIters = size_t(1) << 22;
+
+float fma_generic() {
+    return fma_chains<16>(kFmaIters);
+}
+
+#if LLAISYS_X86_SIMD
+LLAISYS_TARGET("avx2,fma")
+float fma_avx2() {
+    return fma_chains<64>(kFmaIters);
+}
+
+LLAISYS_TARGET("avx512f")
+float fma_avx512() {
+    return fma_chains<128>(kFmaIters);
+}
+#endif
+
+// Peak fp32 multiply-add throughput in GFLOP/s, every thread running its own chains.
+double probe_flops() {
+    float (*fn)() = &fma_generic;
+    size_t width = 16;
+#if LLAISYS_X86_SIMD
+    const auto &features = utils::cpu_features();
+    if (features.avx512f) {
+        fn = &fma_avx512;
+        width = 128;
+    } else if (features.avx2 && features.fma) {
+        fn = &fma_avx2;
+        width = 64;
+    }
+#endif
+    double best = 0;
+    volatile float sink = 0;
+    for (int rep = 0; rep < 3; ++rep) {
+        int nthread = 1;
+        const auto t0 = std::chrono::steady_clock::now();
+#pragma omp parallel
+        {
+#ifdef _OPENMP
+#pragma omp single
+            nthread = omp_get_num_threads();
+#endif
+            const float s = fn();
+#pragma omp critical
+            sink = sink + s;
+        }
+        const double dt = seconds_since(t0);
+        best = std::max(best, 2.0 * width * kFmaIters * nthread / dt / 1e9);
+    }
+    return best;
+}
+
+struct Roofline {
+    int threads;
+    double gbps;
+    double gflops;
+};
+
+// ---- cases ----
+
+struct Case {
+    std::string op;
+    std::string name; // model/phase/what
+    std::string dtype;
+    std::string wtype; // weight / cache dtype where it differs from dtype
+    std::string shape;
+    uint64_t bytes;
+    uint64_t flops;
+    // Allocates and fills the operands, returns the call to time.
+    std::function<std::function<void()>()> setup;
+};
+
+struct Timing {
+    size_t reps;
+    double median_s;
+    double min_s;
+};
+
+Timing time_call(const std::function<void()> &fn, double min_time) {
+    fn(); // warm up caches, lazily built tables and the thread pool
+    fn();
+    std::vector<double> samples;
+    const auto begin = std::chrono::steady_clock::now();
+    while (samples.size() < 5 || (seconds_since(begin) < min_time && samples.size() < 100000)) {
+        const auto t0 = std::chrono::steady_clock::now();
+        fn();
+        samples.push_back(seconds_since(t0));
+    }
+    std::sort(samples.begin(), samples.end());
+    return {samples.size(), samples[samples.size() / 2], samples.front()};
+}
+
+std::string dims(std::initializer_list<size_t> d) {
+    std::string s;
+    for (size_t v : d) s += (s.empty() ? "" : "x") + std::to_string(v);
+    return s;
+}
+
+void add_cases(std::vector<Case> &cases, const ModelShape &m, llaisysDataType_t dt, const Options &opt) {
+    const std::string model = m.name;
+    const std::string dts = dtype_name(dt);
+    const uint64_t es = utils::dsize(dt);
+    const size_t phases[][2] = {{1, opt.context}, {opt.prefill, opt.prefill}}; // {tokens, kv length}
+    auto phase_name = [](size_t tokens) { return tokens == 1 ? std::string("decode") : std::string("prefill"); };
+
+    // linear: the projections of one layer and the LM head, with dense and quantized weights
+    struct Proj {
+        const char *name;
+        size_t n, k;
+        bool decode_only;
+    };
+    const Proj projs[] = {
+        {"q_proj", m.nh * m.dh, m.hs, false},
+        {"o_proj", m.hs, m.nh * m.dh, false},
+        {"gate_proj", m.di, m.hs, false},
+        {"down_proj", m.hs, m.di, false},
+        {"lm_head", m.voc, m.hs, true},
+    };
+    for (const auto &wname : opt.wtypes) {
+        const llaisysDataType_t wt = wname == "same" ? dt : parse_dtype(wname);
+        const bool quant = utils::is_quantized(wt);
+        if (!quant && wt != dt) continue;
+        for (const auto &p : projs) {
+            if (quant && p.k % utils::quant_group(wt) != 0) continue;
+            for (const auto &ph : phases) {
+                const size_t rows = ph[0];
+                if (p.decode_only && rows != 1) continue;
+                const size_t n = p.n, k = p.k;
+                const uint64_t wbytes = n * utils::row_bytes(wt, k);
+                cases.push_back({"linear", model + "/" + phase_name(rows) + "/" + p.name, dts, dtype_name(wt),
+                                 dims({rows, n, k}), wbytes + (rows * k + rows * n) * es, 2ull * rows * n * k,
+                                 [=] {
+                                     auto x = random_buffer(dt, rows * k);
+                                     auto y = std::make_shared<Buffer>(rows * n * es);
+                                     auto w = quant ? quantized_buffer(wt, dt, n, k) : random_buffer(dt, n * k, 0.05f);
+                                     return std::function<void()>([=] {
+                                         if (quant) {
+                                             ops::cpu::linear_quant(y->data(), x->data(), w->data(), nullptr, dt, wt, rows, n, k, n, k);
+                                         } else {
+                                             ops::cpu::linear(y->data(), x->data(), w->data(), nullptr, dt, rows, n, k, n, k);
+                                         }
+                                     });
+                                 }});
+            }
+        }
+    }
+
+    // self_attention over a dense cache, and over a q8 cache for decode
+    for (const auto &ph : phases) {
+        const size_t qlen = ph[0], kvlen = ph[1];
+        const size_t nh = m.nh, nkvh = m.nkvh, dh = m.dh;
+        const uint64_t causal = qlen == 1 ? kvlen : (kvlen * (kvlen + 1)) / 2;
+        cases.push_back({"self_attention", model + "/" + phase_name(qlen) + "/attn", dts, dts,
+                         dims({qlen, kvlen, nh, nkvh, dh}), (2 * qlen * nh * dh + 2 * kvlen * nkvh * dh) * es,
+                         4ull * causal * nh * dh, [=] {
+                             auto q = random_buffer(dt, qlen * nh * dh);
+                             auto k = random_buffer(dt, kvlen * nkvh * dh);
+                             auto v = random_buffer(dt, kvlen * nkvh * dh);
+                             auto o = std::make_shared<Buffer>(qlen * nh * dh * es);
+                             const float scale = 1.0f / std::sqrt(static_cast<float>(dh));
+                             const auto qs = ops::dense_head_strides(nh, dh);
+                             const auto ks = ops::dense_head_strides(nkvh, dh);
+                             return std::function<void()>([=] {
+                                 ops::cpu::self_attention(o->data(), q->data(), k->data(), v->data(), dt, qlen, kvlen, nh,
+                                                          nkvh, dh, dh, scale, qs, qs, ks, ks);
+                             });
+                         }});
+        if (qlen != 1) continue;
+        const llaisysDataType_t kvt = LLAISYS_DTYPE_Q8;
+        cases.push_back({"self_attention", model + "/decode/attn_q8_cache", dts, dtype_name(kvt),
+                         dims({qlen, kvlen, nh, nkvh, dh}),
+                         2 * qlen * nh * dh * es + 2 * kvlen * nkvh * utils::row_bytes(kvt, dh), 4ull * kvlen * nh * dh,
+                         [=] {
+                             auto q = random_buffer(dt, qlen * nh * dh);
+                             auto k = quantized_buffer(kvt, dt, kvlen * nkvh, dh);
+                             auto v = quantized_buffer(kvt, dt, kvlen * nkvh, dh);
+                             auto o = std::make_shared<Buffer>(qlen * nh * dh * es);
+                             const float scale = 1.0f / std::sqrt(static_cast<float>(dh));
+                             return std::function<void()>([=] {
+                                 ops::cpu::self_attention_quant(o->data(), q->data(), k->data(), v->data(), dt, kvt, qlen,
+                                                                kvlen, nh, nkvh, dh, dh, scale);
+                             });
+                         }});
+    }
+
+    for (const auto &ph : phases) {
+        const size_t rows = ph[0];
+        const std::string prefix = model + "/" + phase_name(rows) + "/";
+
+        const size_t hs = m.hs;
+        cases.push_back({"rms_norm", prefix + "hidden", dts, dts, dims({rows, hs}), (2 * rows * hs + hs) * es,
+                         4ull * rows * hs, [=] {
+                             auto x = random_buffer(dt, rows * hs);
+                             auto w = random_buffer(dt, hs);
+                             auto y = std::make_shared<Buffer>(rows * hs * es);
+                             return std::function<void()>([=] {
+                                 ops::cpu::rms_norm(y->data(), x->data(), w->data(), dt, rows, hs, 1e-6f, hs, hs);
+                             });
+                         }});
+
+        const size_t nh = m.nh, dh = m.dh;
+        cases.push_back({"rope", prefix + "q", dts, dts, dims({rows, nh, dh}), 2 * rows * nh * dh * es + rows * 8,
+                         3ull * rows * nh * dh, [=] {
+                             auto x = random_buffer(dt, rows * nh * dh);
+                             auto y = std::make_shared<Buffer>(rows * nh * dh * es);
+                             auto pos = index_buffer(rows, 32768);
+                             const auto s = ops::dense_head_strides(nh, dh);
+                             return std::function<void()>([=] {
+                                 ops::cpu::rope(y->data(), x->data(), pos->data(), dt, rows, nh, dh, 1e6f, s, s);
+                             });
+                         }});
+
+        const size_t numel = rows * m.di;
+        cases.push_back({"swiglu", prefix + "mlp", dts, dts, dims({rows, m.di}), 3 * numel * es, 4ull * numel, [=] {
+                             auto gate = random_buffer(dt, numel);
+                             auto up = random_buffer(dt, numel);
+                             auto out = std::make_shared<Buffer>(numel * es);
+                             return std::function<void()>(
+                                 [=] { ops::cpu::swiglu(out->data(), gate->data(), up->data(), dt, numel); });
+                         }});
+
+        // rows are gathered at random from a table too large to stay cached
+        const size_t table = std::min<size_t>(m.voc, 32768);
+        cases.push_back({"embedding", prefix + "tokens", dts, dts, dims({rows, hs}), 2 * rows * hs * es + rows * 8, 0,
+                         [=] {
+                             auto w = random_buffer(dt, table * hs);
+                             auto idx = index_buffer(rows, table);
+                             auto out = std::make_shared<Buffer>(rows * hs * es);
+                             return std::function<void()>(
+                                 [=] { ops::cpu::embedding(out->data(), idx->data(), w->data(), dt, rows, hs, table); });
+                         }});
+
+        // [seq, head, dim] -> [head, seq, dim]
+        if (rows == 1) continue;
+        cases.push_back({"rearrange", prefix + "heads_major", dts, dts, dims({rows, nh, dh}), 2 * rows * nh * dh * es, 0,
+                         [=] {
+                             auto in = random_buffer(dt, rows * nh * dh);
+                             auto out = std::make_shared<Buffer>(rows * nh * dh * es);
+                             auto shape = std::make_shared<std::vector<size_t>>(std::vector<size_t>{rows, nh, dh});
+                             auto out_st = std::make_shared<std::vector<ptrdiff_t>>(std::vector<ptrdiff_t>{
+                                 static_cast<ptrdiff_t>(dh), static_cast<ptrdiff_t>(rows * dh), 1});
+                             auto in_st = std::make_shared<std::vector<ptrdiff_t>>(std::vector<ptrdiff_t>{
+                                 static_cast<ptrdiff_t>(nh * dh), static_cast<ptrdiff_t>(dh), 1});
+                             return std::function<void()>([=] {
+                                 ops::cpu::rearrange(out->data(), in->data(), shape->data(), out_st->data(),
+                                                     in_st->data(), 3, es);
+                             });
+                         }});
+    }
+
+    // greedy sampling over the logits
+    const size_t voc = m.voc;
+    cases.push_back({"argmax", model + "/decode/logits", dts, dts, dims({voc}), voc * es, voc, [=] {
+                         auto vals = random_buffer(dt, voc);
+                         auto idx = std::make_shared<Buffer>(sizeof(int64_t));
+                         auto val = std::make_shared<Buffer>(es);
+                         return std::function<void()>(
+                             [=] { ops::cpu::argmax(idx->data(), val->data(), vals->data(), dt, voc); });
+                     }});
+}
+
+// ---- report ----
+
+std::string json_escape(const std::string &s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+std::vector<std::string> split(const std::string &s) {
+    std::vector<std::string> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) out.push_back(item);
+    }
+    return out;
+}
+
+void usage() {
+    std::cerr << "usage: llaisys-bench [options]\n"
+                 "  --model LIST     qwen2-0.5b,qwen2-1.5b,qwen2-7b (default qwen2-0.5b)\n"
+                 "  --dtype LIST     f32,bf16,f16 (default f32,bf16)\n"
+                 "  --wtype LIST     linear weight types: same,q8,q4_32,q4_64 (default same,q8,q4_32)\n"
+                 "  --op LIST        only these ops (default all)\n"
+                 "  --threads LIST   thread counts (default 1 and the OpenMP maximum)\n"
+                 "  --prefill N      prefill length (default 128)\n"
+                 "  --context N      KV length for decode attention (default 1024)\n"
+                 "  --min-time SEC   time per case and thread count (default 0.1)\n"
+                 "  --bw-mb MB       bandwidth probe buffer (default 512)\n"
+                 "  --json PATH      write the JSON report to PATH instead of stdout\n";
+}
+
+Options parse(int argc, char **argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            usage();
+            std::exit(0);
+        }
+        if (i + 1 >= argc) {
+            usage();
+            throw std::invalid_argument("missing value for " + arg);
+        }
+        const std::string val = argv[++i];
+        if (arg == "--model") {
+            opt.models = split(val);
+        } else if (arg == "--dtype") {
+            opt.dtypes = split(val);
+        } else if (arg == "--wtype") {
+            opt.wtypes = split(val);
+        } else if (arg == "--op") {
+            opt.ops = split(val);
+        } else if (arg == "--threads") {
+            for (const auto &t : split(val)) opt.threads.push_back(std::stoi(t));
+        } else if (arg == "--prefill") {
+            opt.prefill = std::stoul(val);
+        } else if (arg == "--context") {
+            opt.context = std::stoul(val);
+        } else if (arg == "--min-time") {
+            opt.min_time = std::stod(val);
+        } else if (arg == "--bw-mb") {
+            opt.bw_mb = std::stoul(val);
+        } else if (arg == "--json") {
+            opt.json = val;
+        } else {
+            usage();
+            throw std::invalid_argument("unknown option " + arg);
+        }
+    }
+    if (opt.threads.empty()) {
+        opt.threads.push_back(1);
+        if (max_threads() > 1) opt.threads.push_back(max_threads());
+    }
+    return opt;
+}
+
+int run(int argc, char **argv) {
+    const Options opt = parse(argc, argv);
+
+    std::vector<Case> cases;
+    for (const auto &name : opt.models) {
+        const ModelShape *model = nullptr;
+        for (const auto &m : kModels) {
+            if (name == m.name) model = &m;
+        }
+        if (!model) throw std::invalid_argument("unknown model " + name);
+        for (const auto &d : opt.dtypes) add_cases(cases, *model, parse_dtype(d), opt);
+    }
+    if (!opt.ops.empty()) {
+        cases.erase(std::remove_if(cases.begin(), cases.end(),
+                                   [&](const Case &c) {
+                                       return std::find(opt.ops.begin(), opt.ops.end(), c.op) == opt.ops.end();
+                                   }),
+                    cases.end());
+    }
+
+    std::vector<Roofline> roofs;
+    {
+        Buffer probe(opt.bw_mb << 20);
+        std::memset(probe.data(), 0, probe.bytes());
+        for (int t : opt.threads) {
+            set_threads(t);
+            roofs.push_back({t, probe_bandwidth(probe), probe_flops()});
+            std::fprintf(stderr, "roofline threads=%d: %.1f GB/s, %.1f GFLOP/s\n", t, roofs.back().gbps,
+                         roofs.back().gflops);
+        }
+    }
+
+    std::ostringstream js;
+    const auto &features = utils::cpu_features();
+    js << "{\n  \"schema\": 1,\n  \"machine\": {\"max_threads\": " << max_threads() << ", \"avx2\": " << features.avx2
+       << ", \"fma\": " << features.fma << ", \"avx512f\": " << features.avx512f
+       << ", \"avx512bf16\": " << features.avx512bf16 << ", \"roofline\": [";
+    for (size_t i = 0; i < roofs.size(); ++i) {
+        js << (i ? ", " : "") << "{\"threads\": " << roofs[i].threads << ", \"gbps\": " << roofs[i].gbps
+           << ", \"gflops\": " << roofs[i].gflops << "}";
+    }
+    js << "]},\n  \"results\": [";
+
+    std::fprintf(stderr, "%-15s %-34s %-5s %-6s %3s %11s %9s %9s %8s %5s\n", "op", "case", "dtype", "wtype", "thr",
+                 "median(us)", "GB/s", "GFLOP/s", "roofline", "bound");
+    bool first = true;
+    for (const Case &c : cases) {
+        std::function<void()> fn;
+        std::string error;
+        try {
+            fn = c.setup();
+        } catch (const std::exception &e) {
+            error = e.what();
+        }
+        for (const Roofline &roof : roofs) {
+            set_threads(roof.threads);
+            js << (first ? "\n" : ",\n") << "    {\"op\": \"" << c.op << "\", \"case\": \"" << json_escape(c.name)
+               << "\", \"dtype\": \"" << c.dtype << "\", \"wtype\": \"" << c.wtype << "\", \"shape\": \"" << c.shape
+               << "\", \"threads\": " << roof.threads << ", \"bytes\": " << c.bytes << ", \"flops\": " << c.flops;
+            first = false;
+            if (!error.empty()) {
+                js << ", \"error\": \"" << json_escape(error) << "\"}";
+                continue;
+            }
+            Timing t{};
+            try {
+                t = time_call(fn, opt.min_time);
+            } catch (const std::exception &e) {
+                js << ", \"error\": \"" << json_escape(e.what()) << "\"}";
+                continue;
+            }
+            const double mem_s = c.bytes / (roof.gbps * 1e9);
+            const double cmp_s = c.flops / (roof.gflops * 1e9);
+            const double roofline = std::max(mem_s, cmp_s) / t.median_s;
+            const char *bound = mem_s >= cmp_s ? "memory" : "compute";
+            const double gbps = c.bytes / t.median_s / 1e9;
+            const double gflops = c.flops / t.median_s / 1e9;
+            js << ", \"reps\": " << t.reps << ", \"median_us\": " << t.median_s * 1e6 << ", \"min_us\": " << t.min_s * 1e6
+               << ", \"gbps\": " << gbps << ", \"gflops\": " << gflops << ", \"roofline\": " << roofline
+               << ", \"bound\": \"" << bound << "\"}";
+            std::fprintf(stderr, "%-15s %-34s %-5s %-6s %3d %11.2f %9.2f %9.2f %8.3f %5s\n", c.op.c_str(),
+                         c.name.c_str(), c.dtype.c_str(), c.wtype.c_str(), roof.threads, t.median_s * 1e6, gbps, gflops,
+                         roofline, mem_s >= cmp_s ? "mem" : "cmp");
+        }
+    }
+    js << "\n  ]\n}\n";
+
+    if (opt.json.empty()) {
+        std::cout << js.str();
+    } else {
+        FILE *f = std::fopen(opt.json.c_str(), "w");
+        if (!f) throw std::runtime_error("cannot write " + opt.json);
+        std::fputs(js.str().c_str(), f);
+        std::fclose(f);
+    }
+    return 0;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+    try {
+        return run(argc, argv);
+    } catch (const std::exception &e) {
+        std::cerr << "llaisys-bench: " << e.what() << std::endl;
+        return 1;
+    }
+}
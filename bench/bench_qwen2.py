@@ -0,0 +1,363 @@
+"""End-to-end Qwen2 benchmark on a synthetic checkpoint (no network, no tokenizer).
+
+    python bench/bench_qwen2.py --preset qwen2-0.5b --prompt-len 32,512 --batch 1,4 \\
+        --threads 1,8 --json report.json
+    python bench/bench_qwen2.py ... --compare old_report.json
+
+A checkpoint with random weights of the requested size is written once (safetensors +
+config.json, cached under --model-dir) and loaded through the normal native loader. Every
+(prompt length, batch, threads) configuration then runs in a fresh subprocess so the
+OpenMP thread count takes effect and peak RSS belongs to that configuration alone.
+
+The model has a single KV cache and no batched forward, so a batch of B is B model
+instances over the same mmapped checkpoint, stepped round-robin the way a simple server
+would interleave B requests. Inter-token latency is the time of one full round.
+
+Reported per configuration: load time, time to first token (the prefill), inter-token
+latency p50/p90/p99, prefill and decode tokens/s, and peak RSS.
+"""
+
+import argparse
+import json
+import os
+import platform
+import resource
+import struct
+import subprocess
+import sys
+import tempfile
+import time
+from ctypes import c_int64, c_size_t
+from pathlib import Path
+
+import numpy as np
+
+PRESETS = {
+    "tiny": dict(hs=256, nlayer=4, nh=8, nkvh=2, di=768, voc=4096, tied=True),
+    "qwen2-0.5b": dict(hs=896, nlayer=24, nh=14, nkvh=2, di=4864, voc=151936, tied=True),
+    "qwen2-1.5b": dict(hs=1536, nlayer=28, nh=12, nkvh=2, di=8960, voc=151936, tied=True),
+    "qwen2-7b": dict(hs=3584, nlayer=28, nh=28, nkvh=4, di=18944, voc=152064, tied=False),
+}
+
+ST_DTYPE = {"bfloat16": "BF16", "float16": "F16", "float32": "F32"}
+
+
+def parse_list(text, cast=int):
+    return [cast(x) for x in text.split(",") if x]
+
+
+# ---- synthetic checkpoint ----
+
+
+def checkpoint_tensors(cfg):
+    """(name, shape, std) of every tensor of a Qwen2 checkpoint."""
+    hs, nh, nkvh, di, voc = cfg["hs"], cfg["nh"], cfg["nkvh"], cfg["di"], cfg["voc"]
+    dh = hs // nh
+    out = [("model.embed_tokens.weight", (voc, hs), 0.02)]
+    for i in range(cfg["nlayer"]):
+        p = f"model.layers.{i}."
+        out += [
+            (p + "input_layernorm.weight", (hs,), None),
+            (p + "self_attn.q_proj.weight", (nh * dh, hs), 0.02),
+            (p + "self_attn.q_proj.bias", (nh * dh,), 0.02),
+            (p + "self_attn.k_proj.weight", (nkvh * dh, hs), 0.02),
+            (p + "self_attn.k_proj.bias", (nkvh * dh,), 0.02),
+            (p + "self_attn.v_proj.weight", (nkvh * dh, hs), 0.02),
+            (p + "self_attn.v_proj.bias", (nkvh * dh,), 0.02),
+            (p + "self_attn.o_proj.weight", (hs, nh * dh), 0.02),
+            (p + "post_attention_layernorm.weight", (hs,), None),
+            (p + "mlp.gate_proj.weight", (di, hs), 0.02),
+            (p + "mlp.up_proj.weight", (di, hs), 0.02),
+            (p + "mlp.down_proj.weight", (hs, di), 0.02),
+        ]
+    out.append(("model.norm.weight", (hs,), None))
+    if not cfg["tied"]:
+        out.append(("lm_head.weight", (voc, hs), 0.02))
+    return out
+
+
+def encode(values, dtype):
+    if dtype == "float32":
+        return values.astype(np.float32)
+    if dtype == "float16":
+        return values.astype(np.float16)
+    bits = np.ascontiguousarray(values, np.float32).view(np.uint32)
+    return ((bits + 0x7FFF + ((bits >> 16) & 1)) >> 16).astype(np.uint16)
+
+
+def write_checkpoint(path: Path, cfg, dtype, maxseq, seed=0):
+    """Streams random weights into one safetensors file, tensor by tensor."""
+    esize = 4 if dtype == "float32" else 2
+    tensors = checkpoint_tensors(cfg)
+    header, offset = {"__metadata__": {"format": "pt"}}, 0
+    for name, shape, _ in tensors:
+        nbytes = int(np.prod(shape)) * esize
+        header[name] = {"dtype": ST_DTYPE[dtype], "shape": list(shape), "data_offsets": [offset, offset + nbytes]}
+        offset += nbytes
+    raw = json.dumps(header).encode()
+    raw += b" " * (-len(raw) % 8)
+
+    rng = np.random.default_rng(seed)
+    path.mkdir(parents=True, exist_ok=True)
+    tmp = path / "model.safetensors.tmp"
+    with open(tmp, "wb") as f:
+        f.write(struct.pack("<Q", len(raw)))
+        f.write(raw)
+        for _, shape, std in tensors:
+            if std is None:
+                values = np.ones(shape, np.float32)
+            else:
+                values = rng.standard_normal(shape, dtype=np.float32) * std
+            f.write(encode(values, dtype).tobytes())
+    tmp.rename(path / "model.safetensors")
+
+    config = dict(
+        architectures=["Qwen2ForCausalLM"],
+        hidden_size=cfg["hs"],
+        num_hidden_layers=cfg["nlayer"],
+        num_attention_heads=cfg["nh"],
+        num_key_value_heads=cfg["nkvh"],
+        intermediate_size=cfg["di"],
+        vocab_size=cfg["voc"],
+        max_position_embeddings=maxseq,
+        rms_norm_eps=1e-6,
+        rope_theta=1000000.0,
+        tie_word_embeddings=cfg["tied"],
+        torch_dtype=dtype,
+    )
+    with open(path / "config.json", "w") as f:
+        json.dump(config, f, indent=2)
+
+
+def ensure_checkpoint(args, cfg):
+    name = f"{args.preset}-L{cfg['nlayer']}-{args.dtype}-s{args.maxseq}"
+    path = Path(args.model_dir) / name
+    if not (path / "model.safetensors").exists() or not (path / "config.json").exists():
+        print(f"writing synthetic checkpoint {path} ...", file=sys.stderr)
+        t = time.perf_counter()
+        write_checkpoint(path, cfg, args.dtype, args.maxseq)
+        print(f"  done in {time.perf_counter() - t:.1f}s", file=sys.stderr)
+    return path
+
+
+# ---- one configuration (runs in a subprocess) ----
+
+
+def percentile(values, q):
+    return float(np.percentile(values, q)) if values else 0.0
+
+
+def run_worker(spec):
+    # must be set before the library (and its OpenMP runtime) is loaded
+    os.environ["OMP_NUM_THREADS"] = str(spec["threads"])
+    import llaisys
+    from llaisys.libllaisys import LIB_LLAISYS
+
+    rng = np.random.default_rng(spec["seed"])
+    t = time.perf_counter()
+    models = [
+        llaisys.models.Qwen2(
+            spec["model"],
+            quantize=spec["quantize"],
+            kv_cache_quantize=spec["kv_quantize"],
+            decode_plan=spec["decode_plan"],
+        )
+        for _ in range(spec["batch"])
+    ]
+    load_s = time.perf_counter() - t
+    voc = int(models[0]._meta.voc)
+
+    def prefill(model, tokens):
+        buf = (c_int64 * len(tokens))(*tokens)
+        return int(LIB_LLAISYS.llaisysQwen2ModelPrefill(model._model, buf, c_size_t(len(tokens))))
+
+    def step(model, token):
+        buf = (c_int64 * 1)(token)
+        return int(LIB_LLAISYS.llaisysQwen2ModelStep(model._model, buf, c_size_t(1)))
+
+    # warm-up: first-call tables, the decode plan capture and the thread pool
+    for model in models:
+        token = prefill(model, rng.integers(0, voc, 8).tolist())
+        for _ in range(4):
+            token = step(model, max(token, 0))
+        # a longer prompt would otherwise be taken to extend the cached warm-up tokens
+        model.truncate_kv_cache(0)
+
+    prompts = [rng.integers(0, voc, spec["prompt_len"]).tolist() for _ in models]
+    ttft, tokens = [], []
+    for model, prompt in zip(models, prompts):
+        t = time.perf_counter()
+        tokens.append(prefill(model, prompt))
+        ttft.append(time.perf_counter() - t)
+
+    itl = []
+    t0 = time.perf_counter()
+    for _ in range(spec["gen_len"] - 1):
+        t = time.perf_counter()
+        for i, model in enumerate(models):
+            # random weights may emit any id, including eos; keep decoding regardless
+            tokens[i] = step(model, max(tokens[i], 0))
+        itl.append(time.perf_counter() - t)
+    decode_s = time.perf_counter() - t0
+
+    rss = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    rss_mb = rss / 1024 if sys.platform != "darwin" else rss / (1 << 20)
+    decoded = spec["batch"] * (spec["gen_len"] - 1)
+    return dict(
+        load_s=load_s,
+        ttft_ms=1e3 * float(np.mean(ttft)),
+        ttft_max_ms=1e3 * max(ttft),
+        prefill_tok_s=spec["batch"] * spec["prompt_len"] / sum(ttft),
+        itl_p50_ms=1e3 * percentile(itl, 50),
+        itl_p90_ms=1e3 * percentile(itl, 90),
+        itl_p99_ms=1e3 * percentile(itl, 99),
+        decode_tok_s=decoded / decode_s if decode_s > 0 else 0.0,
+        peak_rss_mb=rss_mb,
+    )
+
+
+# ---- driver ----
+
+
+def config_key(r):
+    return (r["prompt_len"], r["batch"], r["threads"])
+
+
+def cpu_name():
+    try:
+        with open("/proc/cpuinfo") as f:
+            for line in f:
+                if line.startswith("model name"):
+                    return line.split(":", 1)[1].strip()
+    except OSError:
+        pass
+    return platform.processor()
+
+
+def git_commit():
+    try:
+        out = subprocess.run(
+            ["git", "rev-parse", "--short", "HEAD"],
+            cwd=Path(__file__).parent,
+            capture_output=True,
+            text=True,
+            check=True,
+        )
+        return out.stdout.strip()
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+
+COLUMNS = [
+    ("load_s", "load(s)", "{:8.2f}"),
+    ("ttft_ms", "ttft(ms)", "{:9.1f}"),
+    ("itl_p50_ms", "itl50(ms)", "{:9.2f}"),
+    ("itl_p90_ms", "itl90(ms)", "{:9.2f}"),
+    ("itl_p99_ms", "itl99(ms)", "{:9.2f}"),
+    ("prefill_tok_s", "pf tok/s", "{:9.1f}"),
+    ("decode_tok_s", "dec tok/s", "{:9.2f}"),
+    ("peak_rss_mb", "rss(MB)", "{:8.0f}"),
+]
+
+
+def print_table(results, baseline=None):
+    base = {config_key(r): r for r in (baseline or {}).get("results", [])}
+    head = f"{'prompt':>6} {'batch':>5} {'thr':>3} " + " ".join(f"{title:>9}" for _, title, _ in COLUMNS)
+    print(head)
+    for r in results:
+        row = f"{r['prompt_len']:>6} {r['batch']:>5} {r['threads']:>3} "
+        if "error" in r:
+            print(row + "error: " + r["error"])
+            continue
+        row += " ".join(f"{fmt.format(r[key]):>9}" for key, _, fmt in COLUMNS)
+        print(row)
+        old = base.get(config_key(r))
+        if old and "error" not in old:
+            # relative change; for latencies and memory lower is better
+            deltas = []
+            for key, _, _ in COLUMNS:
+                deltas.append(f"{(r[key] / old[key] - 1) * 100:+8.1f}%" if old[key] else f"{'':>9}")
+            print(f"{'vs base':>16} " + " ".join(deltas))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--preset", default="qwen2-0.5b", choices=sorted(PRESETS))
+    parser.add_argument("--layers", type=int, help="override the preset's layer count")
+    parser.add_argument("--dtype", default="bfloat16", choices=sorted(ST_DTYPE))
+    parser.add_argument("--quantize", choices=["q8", "q4_32", "q4_64"], help="quantize linear weights at load")
+    parser.add_argument("--kv-quantize", choices=["q8"], help="int8 KV cache")
+    parser.add_argument("--no-decode-plan", action="store_true", help="dispatch decode op by op")
+    parser.add_argument("--prompt-len", default="32,512", help="comma-separated prompt lengths")
+    parser.add_argument("--gen-len", type=int, default=64, help="tokens generated per sequence")
+    parser.add_argument("--batch", default="1", help="comma-separated concurrent sequences")
+    parser.add_argument("--threads", default=str(os.cpu_count() or 1), help="comma-separated OpenMP thread counts")
+    parser.add_argument("--maxseq", type=int, default=4096, help="max_position_embeddings of the checkpoint")
+    parser.add_argument("--model-dir", default=os.path.join(tempfile.gettempdir(), "llaisys-bench"))
+    parser.add_argument("--seed", type=int, default=0)
+    parser.add_argument("--json", help="write the report to this path")
+    parser.add_argument("--compare", help="print the change against an earlier report")
+    parser.add_argument("--worker", help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.worker:
+        print(json.dumps(run_worker(json.loads(args.worker))))
+        return
+
+    cfg = dict(PRESETS[args.preset])
+    if args.layers:
+        cfg["nlayer"] = args.layers
+    prompt_lens, batches, threads = parse_list(args.prompt_len), parse_list(args.batch), parse_list(args.threads)
+    if max(prompt_lens) + args.gen_len + 8 > args.maxseq:
+        parser.error("--maxseq must cover the longest prompt plus --gen-len")
+    model = ensure_checkpoint(args, cfg)
+
+    results = []
+    for prompt_len in prompt_lens:
+        for batch in batches:
+            for nthread in threads:
+                spec = dict(
+                    model=str(model),
+                    quantize=args.quantize,
+                    kv_quantize=args.kv_quantize,
+                    decode_plan=not args.no_decode_plan,
+                    prompt_len=prompt_len,
+                    gen_len=args.gen_len,
+                    batch=batch,
+                    threads=nthread,
+                    seed=args.seed,
+                )
+                print(f"prompt={prompt_len} batch={batch} threads={nthread} ...", file=sys.stderr)
+                proc = subprocess.run(
+                    [sys.executable, __file__, "--worker", json.dumps(spec)], capture_output=True, text=True
+                )
+                entry = dict(prompt_len=prompt_len, batch=batch, threads=nthread)
+                if proc.returncode != 0:
+                    entry["error"] = (proc.stderr.strip().splitlines() or ["worker failed"])[-1]
+                else:
+                    entry.update(json.loads(proc.stdout.strip().splitlines()[-1]))
+                results.append(entry)
+
+    report = dict(
+        schema=1,
+        created=time.strftime("%Y-%m-%dT%H:%M:%S"),
+        commit=git_commit(),
+        machine=dict(cpu=cpu_name(), cpus=os.cpu_count(), platform=platform.platform()),
+        model=dict(preset=args.preset, dtype=args.dtype, quantize=args.quantize, kv_quantize=args.kv_quantize,
+                   decode_plan=not args.no_decode_plan, gen_len=args.gen_len, **cfg),
+        results=results,
+    )
+    baseline = None
+    if args.compare:
+        with open(args.compare) as f:
+            baseline = json.load(f)
+        if baseline.get("model") != report["model"]:
+            print(f"note: {args.compare} was measured on a different model setup", file=sys.stderr)
+    print_table(results, baseline)
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(report, f, indent=2)
+
+
+if __name__ == "__main__":
+    main()
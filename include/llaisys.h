@@ -49,11 +49,23 @@ typedef enum {
     LLAISYS_DTYPE_C64 = 17,
     LLAISYS_DTYPE_C128 = 18,
     LLAISYS_DTYPE_BF16 = 19,
+    // Quantized formats: every row (last dim) is stored as a scale header followed by packed values.
+    LLAISYS_DTYPE_Q8 = 20, // [float scale][int8 q[cols]], value = q * scale
+    // Q4_G: cols / G blocks of [fp16 scale][fp16 min][uint8 q[G / 2]], value = q * scale + min.
+    // Byte j of a block holds element j in its low nibble and element j + G / 2 in its high nibble.
+    LLAISYS_DTYPE_Q4_32 = 21,
+    LLAISYS_DTYPE_Q4_64 = 22,
 } llaisysDataType_t;
 
 // Runtime Types
 // Stream
 typedef void *llaisysStream_t;
+// Event, marks a point in a stream
+typedef void *llaisysEvent_t;
+// Host function enqueued on a stream
+typedef void (*llaisysHostFn_t)(void *);
+// Releases memory borrowed from another framework, called with its context pointer
+typedef void (*llaisysDeleter_t)(void *);
 
 // Memory Copy Directions
 typedef enum {
@@ -63,4 +75,21 @@ typedef enum {
     LLAISYS_MEMCPY_D2D = 3,
 } llaisysMemcpyKind_t;
 
+// CPU allocation classes, each with its own page policy
+typedef enum {
+    LLAISYS_ALLOC_ACTIVATION = 0,
+    LLAISYS_ALLOC_WEIGHT = 1,
+    LLAISYS_ALLOC_KV_CACHE = 2,
+    LLAISYS_ALLOC_CLASS_COUNT
+} llaisysAllocClass_t;
+
+// Page policy for large CPU allocations
+typedef enum {
+    LLAISYS_HUGE_PAGE_NONE = 0,
+    // 2 MB aligned and madvise(MADV_HUGEPAGE): transparent huge pages
+    LLAISYS_HUGE_PAGE_TRANSPARENT = 1,
+    // mmap(MAP_HUGETLB) from the reserved pool, falling back to transparent
+    LLAISYS_HUGE_PAGE_EXPLICIT = 2,
+} llaisysHugePageMode_t;
+
 #endif // __LLAISYS_H__
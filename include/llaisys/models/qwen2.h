@@ -14,6 +14,9 @@ __C {
         float epsilon, theta;
         //特殊token
         int64_t end_token;
+        //lm_head 与 embedding 共享同一矩阵（tie_word_embeddings，或文件中没有 lm_head.weight），
+        //此时 weights.out_embed 与 in_embed 指向同一份数据，只存一份
+        uint8_t tie_embed;
     };
 
     //千问2模型权重
@@ -49,6 +52,41 @@ __C {
     //创建千问2模型实例
     __export struct LlaisysQwen2Model *llaisysQwen2ModelCreate(const LlaisysQwen2Meta *meta, llaisysDeviceType_t device, int *device_ids, int ndevice);
 
+    //从 HF 格式的模型目录（config.json + *.safetensors）创建并加载千问2模型，失败返回 NULL
+    //CPU 上权重直接指向 mmap 的文件映射（零拷贝，多进程共享 page cache），dtype 与文件一致
+    __export struct LlaisysQwen2Model *llaisysQwen2ModelLoad(const char *model_dir, llaisysDeviceType_t device, int *device_ids, int ndevice);
+
+    //加载选项
+    struct LlaisysQwen2LoadOptions {
+        //线性层权重量化到该 dtype（Q8/Q4_32/Q4_64），LLAISYS_DTYPE_INVALID 表示保持原 dtype
+        llaisysDataType_t weight_dtype;
+        //预处理权重缓存文件路径，NULL 表示不使用；缓存缺失或过期（源文件、选项、CPU 指令集变化）时重新生成
+        //命中时整个模型只需一次 mmap，无需转换和量化
+        const char *cache_path;
+        //非 0 时按 NUMA 节点放置权重：把 OpenMP 线程绑定到各节点的核上，线性层（含 lm_head）的每一行由
+        //计算它的线程首次写入（first-touch），落在该线程所在节点的内存中；单节点机器上不做任何事
+        uint8_t numa;
+    };
+
+    //加载统计
+    struct LlaisysQwen2LoadStats {
+        //读取的权重字节数（命中缓存时为缓存文件大小）
+        size_t bytes;
+        //加载耗时（秒），不含拷贝到非 CPU 设备
+        double seconds;
+        //是否命中权重缓存
+        uint8_t from_cache;
+    };
+
+    //带选项加载千问2模型，options 为 NULL 时等价于 llaisysQwen2ModelLoad
+    __export struct LlaisysQwen2Model *llaisysQwen2ModelLoadWithOptions(const char *model_dir, const struct LlaisysQwen2LoadOptions *options, llaisysDeviceType_t device, int *device_ids, int ndevice);
+
+    //获取最近一次 Load 的统计信息（吞吐量 = bytes / seconds），未通过 Load 创建时全为 0
+    __export const struct LlaisysQwen2LoadStats *llaisysQwen2ModelLoadStats(struct LlaisysQwen2Model * model);
+
+    //获取千问2模型元信息
+    __export const struct LlaisysQwen2Meta *llaisysQwen2ModelMeta(struct LlaisysQwen2Model * model);
+
     //销毁千问2模型实例
     __export void llaisysQwen2ModelDestroy(struct LlaisysQwen2Model * model);
 
@@ -64,6 +102,21 @@ __C {
     //执行千问2模型单步解码（step）
     __export int64_t llaisysQwen2ModelStep(struct LlaisysQwen2Model * model, int64_t * token_ids, size_t ntoken);
 
+    //预填充并输出每个位置的结果：out_logits 为 [ntoken, voc]，out_hidden 为 [ntoken, hs]（最终 norm 之后），
+    //两者均可为空，由调用方分配。总是从位置 0 重新计算，成功返回 1
+    __export uint8_t llaisysQwen2ModelPrefillOutputs(struct LlaisysQwen2Model * model,
+                                                     int64_t * token_ids,
+                                                     size_t ntoken,
+                                                     llaisysTensor_t out_logits,
+                                                     llaisysTensor_t out_hidden);
+
+    //追加 ntoken 个 token 并输出它们每个位置的结果（形状同上），成功返回 1
+    __export uint8_t llaisysQwen2ModelStepOutputs(struct LlaisysQwen2Model * model,
+                                                  int64_t * token_ids,
+                                                  size_t ntoken,
+                                                  llaisysTensor_t out_logits,
+                                                  llaisysTensor_t out_hidden);
+
     //执行千问2模型推理（带采样参数）
     __export int64_t llaisysQwen2ModelInferSampling(struct LlaisysQwen2Model * model,
                                                     int64_t * token_ids,
@@ -82,7 +135,28 @@ __C {
     //重置千问2模型的 KV-cache
     __export void llaisysQwen2ModelResetKVCache(struct LlaisysQwen2Model * model);
 
+    //将 KV-cache 回滚到前 len 个位置（len 不得超过当前长度），成功返回 1
+    //之后的 Prefill 会复用这 len 个位置，只计算其后的 token
+    __export uint8_t llaisysQwen2ModelTruncateKVCache(struct LlaisysQwen2Model * model, size_t len);
+
+    //获取 KV-cache 当前已缓存的位置数
+    __export size_t llaisysQwen2ModelKVCacheLength(struct LlaisysQwen2Model * model);
+
     //启用/禁用 KV-cache
     __export void llaisysQwen2ModelSetKVCacheEnabled(struct LlaisysQwen2Model * model, uint8_t enabled);
+
+    //设置 KV-cache 的存储类型：模型 dtype（默认）或 LLAISYS_DTYPE_Q8（每个 token 每个 kv head 一个 scale），
+    //切换会清空已缓存的位置，成功返回 1
+    __export uint8_t llaisysQwen2ModelSetKVCacheDtype(struct LlaisysQwen2Model * model, llaisysDataType_t dtype);
+
+    //按层换页：对 mmap 的权重提前 prefetch_layers 层发出预读（MADV_WILLNEED），evict 非 0 时每层算完即释放其页面，
+    //下次前向再从文件读回；可让大于内存的模型低速运行。prefetch_layers 为 0 且 evict 为 0 时关闭。
+    //只作用于直接映射文件的权重（未转换 dtype 或来自权重缓存），返回被换页管理的字节数
+    __export size_t llaisysQwen2ModelSetWeightPaging(struct LlaisysQwen2Model * model, size_t prefetch_layers, uint8_t evict);
+
+    //CPU 上单 token 解码（Step）回放预先捕获的执行计划：权重/KV-cache 指针与工作缓冲区在第一次 Step 时固定下来，
+    //之后每步只改变位置，不再经过算子层的检查和张量分配（默认开启）。
+    //每步前会检查权重表：替换了其中的张量（句柄或其底层张量改变）后自动重新捕获；原地改写张量数据无需重新捕获
+    __export void llaisysQwen2ModelSetDecodePlan(struct LlaisysQwen2Model * model, uint8_t enabled);
 }
 #endif // LLAISYS_MODELS_QWEN2_H
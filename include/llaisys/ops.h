@@ -4,10 +4,19 @@
 #include "tensor.h"
 
 __C {
+    // c = a + b; a and b broadcast to c's shape NumPy-style.
     __export void llaisysAdd(llaisysTensor_t c, llaisysTensor_t a, llaisysTensor_t b);
+    // a += b, with b broadcast to a's shape.
+    __export void llaisysAddInplace(llaisysTensor_t a, llaisysTensor_t b);
     __export void llaisysArgmax(llaisysTensor_t max_idx, llaisysTensor_t max_val, llaisysTensor_t vals);
     __export void llaisysEmbedding(llaisysTensor_t out, llaisysTensor_t index, llaisysTensor_t weight);
+    // c = a * b; a and b broadcast to c's shape NumPy-style.
+    __export void llaisysMul(llaisysTensor_t c, llaisysTensor_t a, llaisysTensor_t b);
+    // a *= b, with b broadcast to a's shape.
+    __export void llaisysMulInplace(llaisysTensor_t a, llaisysTensor_t b);
     __export void llaisysLinear(llaisysTensor_t out, llaisysTensor_t in, llaisysTensor_t weight, llaisysTensor_t bias);
+    // Row-wise quantization of `in` into `out`, whose dtype selects the format (e.g. LLAISYS_DTYPE_Q8).
+    __export void llaisysQuantize(llaisysTensor_t out, llaisysTensor_t in);
     __export void llaisysRearrange(llaisysTensor_t out, llaisysTensor_t in);
     __export void llaisysRmsNorm(llaisysTensor_t out, llaisysTensor_t in, llaisysTensor_t weight, float eps);
     __export void llaisysROPE(llaisysTensor_t out, llaisysTensor_t in, llaisysTensor_t pos_ids, float theta);
@@ -0,0 +1,21 @@
+#ifndef LLAISYS_PROFILER_H
+#define LLAISYS_PROFILER_H
+
+#include "../llaisys.h"
+
+__C {
+    // Op-level profiler. While started, every llaisys* op call and every step of the
+    // captured decode plan records its wall time, bytes touched and FLOPs. When stopped
+    // each hook costs one flag check.
+    __export void llaisysProfilerStart();
+    __export void llaisysProfilerStop();
+    // Drops all recorded events and totals.
+    __export void llaisysProfilerReset();
+    // Writes the recorded events as Chrome trace-event JSON. Returns 0 on success.
+    __export int llaisysProfilerDumpTrace(const char *path);
+    // Copies the per-op summary table (NUL-terminated, truncated to fit) into `buf` and
+    // returns its full length; call with size 0 to query it.
+    __export size_t llaisysProfilerSummary(char *buf, size_t size);
+}
+
+#endif // LLAISYS_PROFILER_H
@@ -21,6 +21,14 @@ __C {
     // Memory copy
     typedef void (*memcpy_sync_api)(void *, const void *, size_t, llaisysMemcpyKind_t);
     typedef void (*memcpy_async_api)(void *, const void *, size_t, llaisysMemcpyKind_t, llaisysStream_t);
+    // Event
+    typedef llaisysEvent_t (*create_event_api)();
+    typedef void (*destroy_event_api)(llaisysEvent_t);
+    typedef void (*event_record_api)(llaisysEvent_t, llaisysStream_t);
+    typedef void (*stream_wait_event_api)(llaisysStream_t, llaisysEvent_t);
+    typedef void (*event_synchronize_api)(llaisysEvent_t);
+    // Host work, runs in stream order
+    typedef void (*launch_host_func_api)(llaisysStream_t, llaisysHostFn_t, void *);
 
     struct LlaisysRuntimeAPI {
         get_device_count_api get_device_count;
@@ -35,6 +43,12 @@ __C {
         free_host_api free_host;
         memcpy_sync_api memcpy_sync;
         memcpy_async_api memcpy_async;
+        create_event_api create_event;
+        destroy_event_api destroy_event;
+        event_record_api event_record;
+        stream_wait_event_api stream_wait_event;
+        event_synchronize_api event_synchronize;
+        launch_host_func_api launch_host_func;
     };
 
     // Llaisys API for getting the runtime APIs
@@ -42,6 +56,11 @@ __C {
 
     // Llaisys API for switching device context
     __export void llaisysSetContextRuntime(llaisysDeviceType_t, int);
+
+    // Page policy of CPU allocations of at least 2 MB in the given class (process wide).
+    // Weights are allocated by the model loaders, KV caches by the decoder, everything else
+    // counts as activations.
+    __export void llaisysCpuSetHugePages(llaisysAllocClass_t, llaisysHugePageMode_t);
 }
 
 #endif // LLAISYS_RUNTIME_H
@@ -13,6 +13,19 @@ __C {
         llaisysDeviceType_t device_type,
         int device_id);
 
+    // Wraps memory owned by another framework without copying. `strides` (in elements) may be
+    // null for a contiguous layout. `deleter(deleter_ctx)` runs once no tensor uses the memory.
+    __export llaisysTensor_t tensorFromBlob(
+        void *data,
+        size_t * shape,
+        ptrdiff_t * strides,
+        size_t ndim,
+        llaisysDataType_t dtype,
+        llaisysDeviceType_t device_type,
+        int device_id,
+        llaisysDeleter_t deleter,
+        void *deleter_ctx);
+
     __export void tensorDestroy(
         llaisysTensor_t tensor);
 
@@ -63,6 +76,20 @@ __C {
         size_t dim,
         size_t start,
         size_t end);
+
+    __export llaisysTensor_t tensorContiguous(
+        llaisysTensor_t tensor);
+
+    __export llaisysTensor_t tensorReshape(
+        llaisysTensor_t tensor,
+        size_t * shape,
+        size_t ndim);
+
+    __export llaisysTensor_t tensorTo(
+        llaisysTensor_t tensor,
+        llaisysDeviceType_t device_type,
+        int device_id,
+        uint8_t non_blocking);
 }
 
 #endif // LLAISYS_TENSOR_H
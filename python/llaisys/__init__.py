@@ -1,10 +1,12 @@
-from .runtime import RuntimeAPI
+from .runtime import RuntimeAPI, set_huge_pages
 from .libllaisys import DeviceType
 from .libllaisys import DataType
 from .libllaisys import MemcpyKind
+from .libllaisys import AllocClass, HugePageMode
 from .libllaisys import llaisysStream_t as Stream
 from .tensor import Tensor
 from .ops import Ops
+from .profiler import Profiler
 from . import models
 from .models import *
 
@@ -13,8 +15,12 @@ __all__ = [
     "DeviceType",
     "DataType",
     "MemcpyKind",
+    "AllocClass",
+    "HugePageMode",
+    "set_huge_pages",
     "Stream",
     "Tensor",
     "Ops",
+    "Profiler",
     "models",
 ]
@@ -0,0 +1,182 @@
+import ctypes
+from ctypes import (
+    CFUNCTYPE,
+    POINTER,
+    Structure,
+    c_char_p,
+    c_int,
+    c_int64,
+    c_uint8,
+    c_uint16,
+    c_uint64,
+    c_void_p,
+)
+
+from .libllaisys import DataType, DeviceType
+
+# DLPack 0.x ABI (the unversioned "dltensor" capsule understood by numpy and torch).
+
+kDLCPU = 1
+kDLCUDA = 2
+kDLCUDAHost = 3
+
+kDLInt = 0
+kDLUInt = 1
+kDLFloat = 2
+kDLBfloat = 4
+kDLBool = 6
+
+
+class DLDevice(Structure):
+    _fields_ = [("device_type", c_int), ("device_id", c_int)]
+
+
+class DLDataType(Structure):
+    _fields_ = [("code", c_uint8), ("bits", c_uint8), ("lanes", c_uint16)]
+
+
+class DLTensor(Structure):
+    _fields_ = [
+        ("data", c_void_p),
+        ("device", DLDevice),
+        ("ndim", c_int),
+        ("dtype", DLDataType),
+        ("shape", POINTER(c_int64)),
+        ("strides", POINTER(c_int64)),
+        ("byte_offset", c_uint64),
+    ]
+
+
+class DLManagedTensor(Structure):
+    pass
+
+
+DLManagedTensorDeleter = CFUNCTYPE(None, POINTER(DLManagedTensor))
+DLManagedTensor._fields_ = [
+    ("dl_tensor", DLTensor),
+    ("manager_ctx", c_void_p),
+    ("deleter", DLManagedTensorDeleter),
+]
+
+DTYPE_TO_DL = {
+    DataType.BOOL: (kDLBool, 8),
+    DataType.BYTE: (kDLUInt, 8),
+    DataType.I8: (kDLInt, 8),
+    DataType.I16: (kDLInt, 16),
+    DataType.I32: (kDLInt, 32),
+    DataType.I64: (kDLInt, 64),
+    DataType.U8: (kDLUInt, 8),
+    DataType.U16: (kDLUInt, 16),
+    DataType.U32: (kDLUInt, 32),
+    DataType.U64: (kDLUInt, 64),
+    DataType.F16: (kDLFloat, 16),
+    DataType.F32: (kDLFloat, 32),
+    DataType.F64: (kDLFloat, 64),
+    DataType.BF16: (kDLBfloat, 16),
+}
+DL_TO_DTYPE = {v: k for k, v in DTYPE_TO_DL.items() if k != DataType.BYTE}
+
+
+def to_dl_device(device: DeviceType, device_id: int):
+    if device == DeviceType.CPU:
+        return kDLCPU, 0
+    if device == DeviceType.NVIDIA:
+        return kDLCUDA, device_id
+    raise TypeError(f"DLPack: unsupported device {device}")
+
+
+def from_dl_device(device: DLDevice):
+    if device.device_type in (kDLCPU, kDLCUDAHost):
+        return DeviceType.CPU, 0
+    if device.device_type == kDLCUDA:
+        return DeviceType.NVIDIA, device.device_id
+    raise TypeError(f"DLPack: unsupported device type {device.device_type}")
+
+
+# Capsule helpers. Calls made from Python take the capsule object itself; the capsule
+# destructor only gets a raw PyObject* and must not create new references to it.
+_capsule_new = ctypes.PYFUNCTYPE(ctypes.py_object, c_void_p, c_char_p, c_void_p)(
+    ("PyCapsule_New", ctypes.pythonapi)
+)
+_capsule_get_pointer = ctypes.PYFUNCTYPE(c_void_p, ctypes.py_object, c_char_p)(
+    ("PyCapsule_GetPointer", ctypes.pythonapi)
+)
+_capsule_set_name = ctypes.PYFUNCTYPE(c_int, ctypes.py_object, c_char_p)(
+    ("PyCapsule_SetName", ctypes.pythonapi)
+)
+_raw_capsule_is_valid = ctypes.PYFUNCTYPE(c_int, c_void_p, c_char_p)(
+    ("PyCapsule_IsValid", ctypes.pythonapi)
+)
+_raw_capsule_get_pointer = ctypes.PYFUNCTYPE(c_void_p, c_void_p, c_char_p)(
+    ("PyCapsule_GetPointer", ctypes.pythonapi)
+)
+
+_CAPSULE_NAME = b"dltensor"
+_USED_CAPSULE_NAME = b"used_dltensor"
+
+# Exported DLManagedTensors by address, each with the objects that must outlive it.
+_exported = {}
+
+
+@DLManagedTensorDeleter
+def _delete_exported(managed):
+    _exported.pop(ctypes.addressof(managed.contents), None)
+
+
+@CFUNCTYPE(None, c_void_p)
+def _capsule_destructor(capsule):
+    # A consumer renames the capsule and takes over the deleter; otherwise nobody did.
+    if _raw_capsule_is_valid(capsule, _CAPSULE_NAME):
+        address = _raw_capsule_get_pointer(capsule, _CAPSULE_NAME)
+        _exported.pop(address, None)
+
+
+def make_capsule(data: int, shape, strides, dtype: DataType, device: DeviceType, device_id: int, owner):
+    """Packs a strided buffer into a "dltensor" capsule that keeps `owner` alive."""
+    if dtype not in DTYPE_TO_DL:
+        raise TypeError(f"DLPack: unsupported dtype {dtype}")
+    code, bits = DTYPE_TO_DL[dtype]
+    ndim = len(shape)
+    shape_arr = (c_int64 * max(ndim, 1))(*shape)
+    strides_arr = (c_int64 * max(ndim, 1))(*strides)
+
+    managed = DLManagedTensor()
+    managed.dl_tensor.data = data
+    managed.dl_tensor.device = DLDevice(*to_dl_device(device, device_id))
+    managed.dl_tensor.ndim = ndim
+    managed.dl_tensor.dtype = DLDataType(code, bits, 1)
+    managed.dl_tensor.shape = shape_arr
+    managed.dl_tensor.strides = strides_arr
+    managed.dl_tensor.byte_offset = 0
+    managed.deleter = _delete_exported
+
+    address = ctypes.addressof(managed)
+    _exported[address] = (managed, shape_arr, strides_arr, owner)
+    return _capsule_new(address, _CAPSULE_NAME, ctypes.cast(_capsule_destructor, c_void_p))
+
+
+class ImportedBuffer:
+    """A DLPack buffer taken over from a producer; release() hands it back."""
+
+    def __init__(self, capsule):
+        address = _capsule_get_pointer(capsule, _CAPSULE_NAME)
+        self._managed = DLManagedTensor.from_address(address)
+        tensor = self._managed.dl_tensor
+        if tensor.dtype.lanes != 1 or (tensor.dtype.code, tensor.dtype.bits) not in DL_TO_DTYPE:
+            raise TypeError(
+                f"DLPack: unsupported dtype code={tensor.dtype.code} bits={tensor.dtype.bits} lanes={tensor.dtype.lanes}"
+            )
+        self.dtype = DL_TO_DTYPE[(tensor.dtype.code, tensor.dtype.bits)]
+        self.device, self.device_id = from_dl_device(tensor.device)
+        self.shape = tuple(tensor.shape[i] for i in range(tensor.ndim))
+        self.strides = (
+            tuple(tensor.strides[i] for i in range(tensor.ndim)) if tensor.strides else None
+        )
+        self.data = (tensor.data or 0) + tensor.byte_offset
+        # From here on the deleter is ours to call.
+        _capsule_set_name(capsule, _USED_CAPSULE_NAME)
+
+    def release(self):
+        if self._managed is not None and self._managed.deleter:
+            self._managed.deleter(ctypes.pointer(self._managed))
+        self._managed = None
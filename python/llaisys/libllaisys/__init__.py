@@ -8,12 +8,14 @@ from .runtime import LlaisysRuntimeAPI
 from .llaisys_types import llaisysDeviceType_t, DeviceType
 from .llaisys_types import llaisysDataType_t, DataType
 from .llaisys_types import llaisysMemcpyKind_t, MemcpyKind
-from .llaisys_types import llaisysStream_t
+from .llaisys_types import llaisysAllocClass_t, AllocClass, llaisysHugePageMode_t, HugePageMode
+from .llaisys_types import llaisysStream_t, llaisysEvent_t, llaisysHostFn_t, llaisysDeleter_t
 from .tensor import llaisysTensor_t
 from .tensor import load_tensor
 from .ops import load_ops
+from .profiler import load_profiler
 from .models import load_models
-from .models import LlaisysQwen2Meta, LlaisysQwen2Weights, LlaisysQwen2Model, LlaisysSamplingParams
+from .models import LlaisysQwen2Meta, LlaisysQwen2Weights, LlaisysQwen2Model, LlaisysQwen2LoadOptions, LlaisysSamplingParams
 from .tokenizer import load_tokenizer, LlaisysTokenizer
 
 
@@ -41,6 +43,7 @@ LIB_LLAISYS = load_shared_library()
 load_runtime(LIB_LLAISYS)
 load_tensor(LIB_LLAISYS)
 load_ops(LIB_LLAISYS)
+load_profiler(LIB_LLAISYS)
 load_models(LIB_LLAISYS)
 load_tokenizer(LIB_LLAISYS)
 
@@ -56,10 +59,18 @@ __all__ = [
     "DeviceType",
     "llaisysMemcpyKind_t",
     "MemcpyKind",
+    "llaisysAllocClass_t",
+    "AllocClass",
+    "llaisysHugePageMode_t",
+    "HugePageMode",
     "llaisysStream_t",
+    "llaisysEvent_t",
+    "llaisysHostFn_t",
+    "llaisysDeleter_t",
     "LlaisysQwen2Meta",
     "LlaisysQwen2Weights",
     "LlaisysQwen2Model",
+    "LlaisysQwen2LoadOptions",
     "LlaisysSamplingParams",
     "LlaisysTokenizer",
 ]
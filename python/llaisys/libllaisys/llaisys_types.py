@@ -34,6 +34,9 @@ class DataType(IntEnum):
     C64 = 17
     C128 = 18
     BF16 = 19
+    Q8 = 20
+    Q4_32 = 21
+    Q4_64 = 22
 
 
 llaisysDataType_t = ctypes.c_int
@@ -49,9 +52,33 @@ class MemcpyKind(IntEnum):
 
 llaisysMemcpyKind_t = ctypes.c_int
 
+
+class AllocClass(IntEnum):
+    ACTIVATION = 0
+    WEIGHT = 1
+    KV_CACHE = 2
+
+
+llaisysAllocClass_t = ctypes.c_int
+
+
+class HugePageMode(IntEnum):
+    NONE = 0
+    TRANSPARENT = 1
+    EXPLICIT = 2
+
+
+llaisysHugePageMode_t = ctypes.c_int
+
 # Stream type (opaque pointer)
 llaisysStream_t = ctypes.c_void_p
 
+# Event type (opaque pointer)
+llaisysEvent_t = ctypes.c_void_p
+
+# Host function enqueued on a stream
+llaisysHostFn_t = ctypes.CFUNCTYPE(None, ctypes.c_void_p)
+
 __all__ = [
     "llaisysDeviceType_t",
     "DeviceType",
@@ -59,5 +86,14 @@ __all__ = [
     "DataType",
     "llaisysMemcpyKind_t",
     "MemcpyKind",
+    "llaisysAllocClass_t",
+    "AllocClass",
+    "llaisysHugePageMode_t",
+    "HugePageMode",
     "llaisysStream_t",
+    "llaisysEvent_t",
+    "llaisysHostFn_t",
 ]
+
+# Releases memory borrowed from another framework
+llaisysDeleter_t = ctypes.CFUNCTYPE(None, ctypes.c_void_p)
@@ -1,4 +1,4 @@
-from ctypes import Structure, POINTER, c_size_t, c_int, c_float, c_int64, c_uint32, c_void_p
+from ctypes import Structure, POINTER, c_char_p, c_size_t, c_int, c_float, c_double, c_int64, c_uint8, c_uint32, c_void_p
 
 from .llaisys_types import llaisysDeviceType_t, llaisysDataType_t
 from .tensor import llaisysTensor_t
@@ -18,6 +18,7 @@ class LlaisysQwen2Meta(Structure):
         ("epsilon", c_float),
         ("theta", c_float),
         ("end_token", c_int64),
+        ("tie_embed", c_uint8),
     ]
 
 
@@ -40,6 +41,22 @@ class LlaisysQwen2Weights(Structure):
         ("mlp_down_w", POINTER(llaisysTensor_t)),
     ]
 
+class LlaisysQwen2LoadOptions(Structure):
+    _fields_ = [
+        ("weight_dtype", llaisysDataType_t),
+        ("cache_path", c_char_p),
+        ("numa", c_uint8),
+    ]
+
+
+class LlaisysQwen2LoadStats(Structure):
+    _fields_ = [
+        ("bytes", c_size_t),
+        ("seconds", c_double),
+        ("from_cache", c_uint8),
+    ]
+
+
 class LlaisysSamplingParams(Structure):
     _fields_ = [
         ("top_k", c_int),
@@ -61,6 +78,29 @@ def load_models(lib):
     ]
     lib.llaisysQwen2ModelCreate.restype = LlaisysQwen2Model
 
+    lib.llaisysQwen2ModelLoad.argtypes = [
+        c_char_p,
+        llaisysDeviceType_t,
+        POINTER(c_int),
+        c_int,
+    ]
+    lib.llaisysQwen2ModelLoad.restype = LlaisysQwen2Model
+
+    lib.llaisysQwen2ModelLoadWithOptions.argtypes = [
+        c_char_p,
+        POINTER(LlaisysQwen2LoadOptions),
+        llaisysDeviceType_t,
+        POINTER(c_int),
+        c_int,
+    ]
+    lib.llaisysQwen2ModelLoadWithOptions.restype = LlaisysQwen2Model
+
+    lib.llaisysQwen2ModelLoadStats.argtypes = [LlaisysQwen2Model]
+    lib.llaisysQwen2ModelLoadStats.restype = POINTER(LlaisysQwen2LoadStats)
+
+    lib.llaisysQwen2ModelMeta.argtypes = [LlaisysQwen2Model]
+    lib.llaisysQwen2ModelMeta.restype = POINTER(LlaisysQwen2Meta)
+
     lib.llaisysQwen2ModelDestroy.argtypes = [LlaisysQwen2Model]
     lib.llaisysQwen2ModelDestroy.restype = None
 
@@ -76,6 +116,24 @@ def load_models(lib):
     lib.llaisysQwen2ModelStep.argtypes = [LlaisysQwen2Model, POINTER(c_int64), c_size_t]
     lib.llaisysQwen2ModelStep.restype = c_int64
 
+    lib.llaisysQwen2ModelPrefillOutputs.argtypes = [
+        LlaisysQwen2Model,
+        POINTER(c_int64),
+        c_size_t,
+        llaisysTensor_t,
+        llaisysTensor_t,
+    ]
+    lib.llaisysQwen2ModelPrefillOutputs.restype = c_uint8
+
+    lib.llaisysQwen2ModelStepOutputs.argtypes = [
+        LlaisysQwen2Model,
+        POINTER(c_int64),
+        c_size_t,
+        llaisysTensor_t,
+        llaisysTensor_t,
+    ]
+    lib.llaisysQwen2ModelStepOutputs.restype = c_uint8
+
     lib.llaisysQwen2ModelInferSampling.argtypes = [
         LlaisysQwen2Model,
         POINTER(c_int64),
@@ -98,13 +156,30 @@ def load_models(lib):
     lib.llaisysQwen2ModelResetKVCache.argtypes = [LlaisysQwen2Model]
     lib.llaisysQwen2ModelResetKVCache.restype = None
 
+    lib.llaisysQwen2ModelTruncateKVCache.argtypes = [LlaisysQwen2Model, c_size_t]
+    lib.llaisysQwen2ModelTruncateKVCache.restype = c_uint8
+
+    lib.llaisysQwen2ModelKVCacheLength.argtypes = [LlaisysQwen2Model]
+    lib.llaisysQwen2ModelKVCacheLength.restype = c_size_t
+
     lib.llaisysQwen2ModelSetKVCacheEnabled.argtypes = [LlaisysQwen2Model, c_int]
     lib.llaisysQwen2ModelSetKVCacheEnabled.restype = None
 
+    lib.llaisysQwen2ModelSetKVCacheDtype.argtypes = [LlaisysQwen2Model, llaisysDataType_t]
+    lib.llaisysQwen2ModelSetKVCacheDtype.restype = c_uint8
+
+    lib.llaisysQwen2ModelSetWeightPaging.argtypes = [LlaisysQwen2Model, c_size_t, c_uint8]
+    lib.llaisysQwen2ModelSetWeightPaging.restype = c_size_t
+
+    lib.llaisysQwen2ModelSetDecodePlan.argtypes = [LlaisysQwen2Model, c_uint8]
+    lib.llaisysQwen2ModelSetDecodePlan.restype = None
+
 
 __all__ = [
     "LlaisysQwen2Meta",
     "LlaisysQwen2Weights",
+    "LlaisysQwen2LoadOptions",
+    "LlaisysQwen2LoadStats",
     "LlaisysSamplingParams",
     "LlaisysQwen2Model",
     "load_models",
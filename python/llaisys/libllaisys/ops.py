@@ -5,15 +5,27 @@ def load_ops(lib):
     lib.llaisysAdd.argtypes = [llaisysTensor_t, llaisysTensor_t, llaisysTensor_t]
     lib.llaisysAdd.restype = None
 
+    lib.llaisysAddInplace.argtypes = [llaisysTensor_t, llaisysTensor_t]
+    lib.llaisysAddInplace.restype = None
+
     lib.llaisysArgmax.argtypes = [llaisysTensor_t, llaisysTensor_t, llaisysTensor_t]
     lib.llaisysArgmax.restype = None
 
     lib.llaisysEmbedding.argtypes = [llaisysTensor_t, llaisysTensor_t, llaisysTensor_t]
     lib.llaisysEmbedding.restype = None
 
+    lib.llaisysMul.argtypes = [llaisysTensor_t, llaisysTensor_t, llaisysTensor_t]
+    lib.llaisysMul.restype = None
+
+    lib.llaisysMulInplace.argtypes = [llaisysTensor_t, llaisysTensor_t]
+    lib.llaisysMulInplace.restype = None
+
     lib.llaisysLinear.argtypes = [llaisysTensor_t, llaisysTensor_t, llaisysTensor_t, llaisysTensor_t]
     lib.llaisysLinear.restype = None
 
+    lib.llaisysQuantize.argtypes = [llaisysTensor_t, llaisysTensor_t]
+    lib.llaisysQuantize.restype = None
+
     lib.llaisysRearrange.argtypes = [llaisysTensor_t, llaisysTensor_t]
     lib.llaisysRearrange.restype = None
 
@@ -0,0 +1,18 @@
+from ctypes import c_char_p, c_int, c_size_t
+
+
+def load_profiler(lib):
+    lib.llaisysProfilerStart.argtypes = []
+    lib.llaisysProfilerStart.restype = None
+
+    lib.llaisysProfilerStop.argtypes = []
+    lib.llaisysProfilerStop.restype = None
+
+    lib.llaisysProfilerReset.argtypes = []
+    lib.llaisysProfilerReset.restype = None
+
+    lib.llaisysProfilerDumpTrace.argtypes = [c_char_p]
+    lib.llaisysProfilerDumpTrace.restype = c_int
+
+    lib.llaisysProfilerSummary.argtypes = [c_char_p, c_size_t]
+    lib.llaisysProfilerSummary.restype = c_size_t
@@ -19,6 +19,13 @@ free_host_api = CFUNCTYPE(None, c_void_p)
 memcpy_sync_api = CFUNCTYPE(None, c_void_p, c_void_p, c_size_t, llaisysMemcpyKind_t)
 memcpy_async_api = CFUNCTYPE(None, c_void_p, c_void_p, c_size_t, llaisysMemcpyKind_t, llaisysStream_t)
 
+create_event_api = CFUNCTYPE(llaisysEvent_t)
+destroy_event_api = CFUNCTYPE(None, llaisysEvent_t)
+event_record_api = CFUNCTYPE(None, llaisysEvent_t, llaisysStream_t)
+stream_wait_event_api = CFUNCTYPE(None, llaisysStream_t, llaisysEvent_t)
+event_synchronize_api = CFUNCTYPE(None, llaisysEvent_t)
+launch_host_func_api = CFUNCTYPE(None, llaisysStream_t, llaisysHostFn_t, c_void_p)
+
 
 # Define the struct matching LlaisysRuntimeAPI
 class LlaisysRuntimeAPI(Structure):
@@ -35,6 +42,12 @@ class LlaisysRuntimeAPI(Structure):
         ("free_host", free_host_api),
         ("memcpy_sync", memcpy_sync_api),
         ("memcpy_async", memcpy_async_api),
+        ("create_event", create_event_api),
+        ("destroy_event", destroy_event_api),
+        ("event_record", event_record_api),
+        ("stream_wait_event", stream_wait_event_api),
+        ("event_synchronize", event_synchronize_api),
+        ("launch_host_func", launch_host_func_api),
     ]
 
 
@@ -46,3 +59,6 @@ def load_runtime(lib):
 
     lib.llaisysSetContextRuntime.argtypes = [llaisysDeviceType_t, c_int]
     lib.llaisysSetContextRuntime.restype = None
+
+    lib.llaisysCpuSetHugePages.argtypes = [llaisysAllocClass_t, llaisysHugePageMode_t]
+    lib.llaisysCpuSetHugePages.restype = None
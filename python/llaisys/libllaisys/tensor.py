@@ -1,5 +1,5 @@
 from ctypes import POINTER, c_uint8, c_void_p, c_size_t, c_ssize_t, c_int
-from .llaisys_types import llaisysDataType_t, llaisysDeviceType_t
+from .llaisys_types import llaisysDataType_t, llaisysDeviceType_t, llaisysDeleter_t
 
 # Handle type
 llaisysTensor_t = c_void_p
@@ -15,6 +15,22 @@ def load_tensor(lib):
     ]
     lib.tensorCreate.restype = llaisysTensor_t
 
+    # Function: tensorFromBlob(void *data, size_t *shape, ptrdiff_t *strides, size_t ndim,
+    #                          llaisysDataType_t dtype, llaisysDeviceType_t device_type,
+    #                          int device_id, llaisysDeleter_t deleter, void *deleter_ctx);
+    lib.tensorFromBlob.argtypes = [
+        c_void_p,
+        POINTER(c_size_t),
+        POINTER(c_ssize_t),
+        c_size_t,
+        llaisysDataType_t,
+        llaisysDeviceType_t,
+        c_int,
+        llaisysDeleter_t,
+        c_void_p,
+    ]
+    lib.tensorFromBlob.restype = llaisysTensor_t
+
     # Function: tensorDestroy
     lib.tensorDestroy.argtypes = [llaisysTensor_t]
     lib.tensorDestroy.restype = None
@@ -76,3 +92,16 @@ def load_tensor(lib):
         c_size_t,  # end  : exclusive
     ]
     lib.tensorSlice.restype = llaisysTensor_t
+
+    # Function: tensorContiguous(llaisysTensor_t tensor);
+    lib.tensorContiguous.argtypes = [llaisysTensor_t]
+    lib.tensorContiguous.restype = llaisysTensor_t
+
+    # Function: tensorReshape(llaisysTensor_t tensor, size_t *shape, size_t ndim);
+    lib.tensorReshape.argtypes = [llaisysTensor_t, POINTER(c_size_t), c_size_t]
+    lib.tensorReshape.restype = llaisysTensor_t
+
+    # Function: tensorTo(llaisysTensor_t tensor, llaisysDeviceType_t device_type,
+    #                    int device_id, uint8_t non_blocking);
+    lib.tensorTo.argtypes = [llaisysTensor_t, llaisysDeviceType_t, c_int, c_uint8]
+    lib.tensorTo.restype = llaisysTensor_t
@@ -1,186 +1,151 @@
 from typing import Sequence
-import warnings
-from ctypes import byref, c_int, c_size_t, c_float, c_int64, c_uint32, c_void_p
-import json
+from ctypes import byref, c_int, c_size_t, c_int64, c_uint8
 from pathlib import Path
 
 import numpy as np
-import safetensors
 
 from ..libllaisys import (
     LIB_LLAISYS,
+    LlaisysQwen2LoadOptions,
     DeviceType,
     DataType,
     llaisysDeviceType_t,
     llaisysDataType_t,
-    LlaisysQwen2Meta,
-    LlaisysSamplingParams,
 )
+from ..tensor import Tensor
 
 
 class Qwen2:
 
-    def __init__(self, model_path, device: DeviceType = DeviceType.CPU):
-        model_path = Path(model_path)
+    def __init__(
+        self,
+        model_path,
+        device: DeviceType = DeviceType.CPU,
+        quantize: str = None,
+        kv_cache_quantize: str = None,
+        weight_cache=None,
+        prefetch_layers: int = 0,
+        evict_layers: bool = False,
+        numa: bool = False,
+        decode_plan: bool = True,
+    ):
+        """weight_cache: None to disable, True for a cache file next to the checkpoint,
+        or an explicit path. The cache holds the converted/quantized weights, so a warm
+        start maps one file instead of re-reading and re-quantizing every shard.
 
-        config_path = model_path / "config.json"
-       
-        with open(config_path, "r", encoding="utf-8") as f:
-            cfg = json.load(f)
-        
-        # vscode中用safetensor view 插件直接看值，硬编码
-        dtype = DataType.BF16
-
-        # 避免 numpy bfloat16 兼容问题
-        use_torch_loader = False
-        if dtype == DataType.BF16:
-            dtype = DataType.F16
-            use_torch_loader = True
-
-        nlayer = int(cfg.get("num_hidden_layers", 0))
-        hs = int(cfg.get("hidden_size", 0))
-        nh = int(cfg.get("num_attention_heads", 0))
-        nkvh = int(cfg.get("num_key_value_heads", nh))
-        di = int(cfg.get("intermediate_size", 0))
-        maxseq = int(cfg.get("max_position_embeddings", 0))
-        voc = int(cfg.get("vocab_size", 0))
-        epsilon = float(cfg.get("rms_norm_eps", 1e-6))
-        theta = float(cfg.get("rope_theta", 10000.0))
-        end_token = int(cfg.get("eos_token_id", -1))
-        dh = int(cfg.get("head_dim", hs // nh if nh else 0))
-
-        model_meta = LlaisysQwen2Meta(
-            llaisysDataType_t(dtype),
-            c_size_t(nlayer),
-            c_size_t(hs),
-            c_size_t(nh),
-            c_size_t(nkvh),
-            c_size_t(dh),
-            c_size_t(di),
-            c_size_t(maxseq),
-            c_size_t(voc),
-            c_float(epsilon),
-            c_float(theta),
-            c_int64(end_token),
+        prefetch_layers / evict_layers page the mmapped layer weights through memory during
+        the forward pass, so models larger than RAM run (slowly) instead of failing.
+
+        numa spreads the worker threads over the NUMA nodes and places each weight row on
+        the node of the thread that computes it (no effect on single-node hosts).
+
+        decode_plan replays single-token CPU decode steps from a plan captured on the first
+        step (fixed buffers, pre-resolved pointers) instead of dispatching op by op."""
+        model_path = Path(model_path)
+        quant_dtype = {
+            None: DataType.INVALID,
+            "q8": DataType.Q8,
+            "q4": DataType.Q4_32,
+            "q4_32": DataType.Q4_32,
+            "q4_64": DataType.Q4_64,
+        }.get(quantize, -1)
+        if quant_dtype == -1:
+            raise ValueError(f"Unsupported quantize mode: {quantize}")
+        if kv_cache_quantize not in (None, "q8"):
+            raise ValueError(f"Unsupported KV-cache quantize mode: {kv_cache_quantize}")
+        if weight_cache is True:
+            tag = quantize or "native"
+            weight_cache = model_path / f"llaisys-{tag}.wcache"
+
+        # 原生加载：C++ 端解析 config.json 并 mmap 所有 safetensors，权重保持文件中的 dtype（通常是 bf16）；
+        # 线性层按 quantize 在加载时量化
+        options = LlaisysQwen2LoadOptions(
+            llaisysDataType_t(quant_dtype),
+            str(weight_cache).encode("utf-8") if weight_cache else None,
+            1 if numa else 0,
         )
-  
         device_ids = (c_int * 1)(0)
-        self._model = LIB_LLAISYS.llaisysQwen2ModelCreate(
-            byref(model_meta),
+        self._model = LIB_LLAISYS.llaisysQwen2ModelLoadWithOptions(
+            str(model_path).encode("utf-8"),
+            byref(options),
             llaisysDeviceType_t(device),
             device_ids,
             1,
         )
         if not self._model:
-            raise RuntimeError("llaisysQwen2ModelCreate failed")
+            raise RuntimeError(f"llaisysQwen2ModelLoad failed for {model_path}")
         self._model_weights = LIB_LLAISYS.llaisysQwen2ModelWeights(self._model)
-        self._meta = model_meta
+        self._meta = LIB_LLAISYS.llaisysQwen2ModelMeta(self._model).contents
 
         LIB_LLAISYS.llaisysQwen2ModelSetKVCacheEnabled(self._model, c_int(1))
-        #
-        def _dtype_to_llaisys(dtype: np.dtype) -> DataType:
-            name = getattr(dtype, "name", str(dtype)).lower()
-            if name in {"float32", "f4"}:
-                return DataType.F32
-            if name in {"float16", "f2"}:
-                return DataType.F16
-            if name in {"bfloat16", "bf16"}:
-                return DataType.BF16
-            if name in {"int64", "i8"}:
-                return DataType.I64
-            if name in {"int32", "i4"}:
-                return DataType.I32
-            if name in {"int16", "i2"}:
-                return DataType.I16
-            if name in {"int8", "i1"}:
-                return DataType.I8
-            if name in {"uint8", "u1"}:
-                return DataType.U8
-            raise ValueError(f"Unsupported dtype: {dtype}")
-
-        def _create_tensor_from_numpy(arr: np.ndarray):
-            arr = np.ascontiguousarray(arr)
-            _shape = (c_size_t * arr.ndim)(*arr.shape)
-            _dtype = _dtype_to_llaisys(arr.dtype)
-            tensor = LIB_LLAISYS.tensorCreate(
-                _shape,
-                c_size_t(arr.ndim),
-                llaisysDataType_t(_dtype),
-                llaisysDeviceType_t(device),
-                c_int(0),
+        if kv_cache_quantize == "q8":
+            # int8 K/V with a scale per token and kv head, about half the fp16 footprint
+            LIB_LLAISYS.llaisysQwen2ModelSetKVCacheDtype(self._model, llaisysDataType_t(DataType.Q8))
+        if not decode_plan:
+            LIB_LLAISYS.llaisysQwen2ModelSetDecodePlan(self._model, c_uint8(0))
+        if prefetch_layers or evict_layers:
+            self.paged_bytes = int(
+                LIB_LLAISYS.llaisysQwen2ModelSetWeightPaging(
+                    self._model, c_size_t(prefetch_layers), c_uint8(1 if evict_layers else 0)
+                )
+            )
+
+    def __del__(self):
+        if getattr(self, "_model", None):
+            LIB_LLAISYS.llaisysQwen2ModelDestroy(self._model)
+            self._model = None
+
+    def load_stats(self) -> dict:
+        """Bytes read, seconds and MB/s of the native load (cache hits report the cache file)."""
+        st = LIB_LLAISYS.llaisysQwen2ModelLoadStats(self._model).contents
+        return {
+            "bytes": int(st.bytes),
+            "seconds": float(st.seconds),
+            "mb_per_s": st.bytes / 1e6 / st.seconds if st.seconds > 0 else 0.0,
+            "from_cache": bool(st.from_cache),
+        }
+
+    def kv_cache_length(self) -> int:
+        return int(LIB_LLAISYS.llaisysQwen2ModelKVCacheLength(self._model))
+
+    def truncate_kv_cache(self, length: int):
+        # 回滚 KV-cache，下一次 generate 只需计算 length 之后的 token
+        if not LIB_LLAISYS.llaisysQwen2ModelTruncateKVCache(self._model, c_size_t(length)):
+            raise ValueError(
+                f"cannot truncate KV-cache to {length}, cached length is {self.kv_cache_length()}"
             )
-            LIB_LLAISYS.tensorLoad(tensor, c_void_p(arr.ctypes.data))
-            return tensor
-
-        for file in sorted(model_path.glob("*.safetensors")):
-            if use_torch_loader:
-                import torch
-                data_ = safetensors.safe_open(file, framework="pt", device="cpu")
-            else:
-                data_ = safetensors.safe_open(file, framework="numpy", device="cpu")
-            for name_ in data_.keys():
-                ## TODO: load the model weights
-                try:
-                    arr = data_.get_tensor(name_)
-                except TypeError:
-                    import torch
-                    data_ = safetensors.safe_open(file, framework="pt", device="cpu")
-                    arr = data_.get_tensor(name_)
-                    use_torch_loader = True
-                if use_torch_loader:
-                    if arr.dtype == torch.bfloat16:
-                        arr = arr.to(torch.float16)
-                    arr = arr.cpu().numpy()
-                tensor = _create_tensor_from_numpy(arr)
-                w = self._model_weights.contents
-
-                if name_ == "model.embed_tokens.weight":
-                    w.in_embed = tensor
-                    continue
-                if name_ == "lm_head.weight":
-                    w.out_embed = tensor
-                    continue
-                if name_ == "model.norm.weight":
-                    w.out_norm_w = tensor
-                    continue
-
-                if name_.startswith("model.layers."):
-                    parts = name_.split(".")
-                    if len(parts) < 4:
-                        continue
-                    layer = int(parts[2])
-                    sub = ".".join(parts[3:])
-
-                    if sub == "input_layernorm.weight":
-                        w.attn_norm_w[layer] = tensor
-                    elif sub == "self_attn.q_proj.weight":
-                        w.attn_q_w[layer] = tensor
-                    elif sub == "self_attn.q_proj.bias":
-                        w.attn_q_b[layer] = tensor
-                    elif sub == "self_attn.k_proj.weight":
-                        w.attn_k_w[layer] = tensor
-                    elif sub == "self_attn.k_proj.bias":
-                        w.attn_k_b[layer] = tensor
-                    elif sub == "self_attn.v_proj.weight":
-                        w.attn_v_w[layer] = tensor
-                    elif sub == "self_attn.v_proj.bias":
-                        w.attn_v_b[layer] = tensor
-                    elif sub == "self_attn.o_proj.weight":
-                        w.attn_o_w[layer] = tensor
-                    elif sub == "post_attention_layernorm.weight":
-                        w.mlp_norm_w[layer] = tensor
-                    elif sub == "mlp.gate_proj.weight":
-                        w.mlp_gate_w[layer] = tensor
-                    elif sub == "mlp.up_proj.weight":
-                        w.mlp_up_w[layer] = tensor
-                    elif sub == "mlp.down_proj.weight":
-                        w.mlp_down_w[layer] = tensor
-
-        w = self._model_weights.contents
-        if not w.out_embed and w.in_embed:
-            w.out_embed = w.in_embed
-
-    
+
+    def forward(self, inputs: Sequence[int], append: bool = False, hidden: bool = False):
+        """Return float32 logits [len(inputs), voc] for every position of `inputs`,
+        or the final hidden states [len(inputs), hs] when `hidden` is set.
+
+        With append=False the sequence is recomputed from position 0; with append=True
+        the tokens are appended after the current KV-cache (speculative verification).
+        """
+        n = len(inputs)
+        cols = self._meta.hs if hidden else self._meta.voc
+        out = Tensor((n, cols), dtype=DataType(self._meta.dtype))
+        token_buf = (c_int64 * n)(*inputs)
+        run = LIB_LLAISYS.llaisysQwen2ModelStepOutputs if append else LIB_LLAISYS.llaisysQwen2ModelPrefillOutputs
+        ok = run(
+            self._model,
+            token_buf,
+            c_size_t(n),
+            None if hidden else out.lib_tensor(),
+            out.lib_tensor() if hidden else None,
+        )
+        if not ok:
+            raise RuntimeError("llaisysQwen2Model forward failed")
+
+        raw = (c_uint8 * (n * cols * (4 if out.dtype() == DataType.F32 else 2))).from_address(out.data_ptr())
+        if out.dtype() == DataType.F32:
+            arr = np.frombuffer(raw, dtype=np.float32)
+        elif out.dtype() == DataType.F16:
+            arr = np.frombuffer(raw, dtype=np.float16)
+        else:
+            arr = (np.frombuffer(raw, dtype=np.uint16).astype(np.uint32) << 16).view(np.float32)
+        return arr.astype(np.float32).reshape(n, cols)
+
     def generate(
         self,
         inputs: Sequence[int],
@@ -8,6 +8,10 @@ class Ops:
     def add(c: Tensor, a: Tensor, b: Tensor):
         LIB_LLAISYS.llaisysAdd(c.lib_tensor(), a.lib_tensor(), b.lib_tensor())
 
+    @staticmethod
+    def add_(a: Tensor, b: Tensor):
+        LIB_LLAISYS.llaisysAddInplace(a.lib_tensor(), b.lib_tensor())
+
     @staticmethod
     def argmax(max_idx: Tensor, max_val: Tensor, vals: Tensor):
         LIB_LLAISYS.llaisysArgmax(max_idx.lib_tensor(), max_val.lib_tensor(), vals.lib_tensor())
@@ -18,12 +22,27 @@ class Ops:
             out.lib_tensor(), index.lib_tensor(), weight.lib_tensor()
         )
 
+    @staticmethod
+    def mul(c: Tensor, a: Tensor, b: Tensor):
+        LIB_LLAISYS.llaisysMul(c.lib_tensor(), a.lib_tensor(), b.lib_tensor())
+
+    @staticmethod
+    def mul_(a: Tensor, b: Tensor):
+        LIB_LLAISYS.llaisysMulInplace(a.lib_tensor(), b.lib_tensor())
+
     @staticmethod
     def linear(out: Tensor, inp: Tensor, weight: Tensor, bias: Tensor):
         LIB_LLAISYS.llaisysLinear(
-            out.lib_tensor(), inp.lib_tensor(), weight.lib_tensor(), bias.lib_tensor()
+            out.lib_tensor(),
+            inp.lib_tensor(),
+            weight.lib_tensor(),
+            bias.lib_tensor() if bias is not None else None,
         )
 
+    @staticmethod
+    def quantize(out: Tensor, inp: Tensor):
+        LIB_LLAISYS.llaisysQuantize(out.lib_tensor(), inp.lib_tensor())
+
     @staticmethod
     def rearrange(out: Tensor, inp: Tensor):
         LIB_LLAISYS.llaisysRearrange(out.lib_tensor(), inp.lib_tensor())
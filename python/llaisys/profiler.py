@@ -0,0 +1,53 @@
+import ctypes
+import os
+from contextlib import contextmanager
+
+from .libllaisys import LIB_LLAISYS
+
+
+class Profiler:
+    """Op-level profiler: wall time, bytes and FLOPs of every op call and decode-plan step.
+
+    with Profiler.profile("trace.json"):
+        model.generate(...)
+    print(Profiler.summary())
+    """
+
+    @staticmethod
+    def start():
+        LIB_LLAISYS.llaisysProfilerStart()
+
+    @staticmethod
+    def stop():
+        LIB_LLAISYS.llaisysProfilerStop()
+
+    @staticmethod
+    def reset():
+        LIB_LLAISYS.llaisysProfilerReset()
+
+    @staticmethod
+    def dump_trace(path):
+        """Writes Chrome trace-event JSON (chrome://tracing, Perfetto) to `path`."""
+        if LIB_LLAISYS.llaisysProfilerDumpTrace(os.fsencode(path)) != 0:
+            raise OSError(f"Profiler: cannot write trace to {path}")
+
+    @staticmethod
+    def summary() -> str:
+        """Per-op table: calls, total and average time, share, bytes, GB/s, GFLOP/s."""
+        size = LIB_LLAISYS.llaisysProfilerSummary(None, 0)
+        buf = ctypes.create_string_buffer(size + 1)
+        LIB_LLAISYS.llaisysProfilerSummary(buf, size + 1)
+        return buf.value.decode()
+
+    @staticmethod
+    @contextmanager
+    def profile(trace_path=None):
+        """Profiles the block from a clean state; optionally dumps the trace afterwards."""
+        Profiler.reset()
+        Profiler.start()
+        try:
+            yield Profiler
+        finally:
+            Profiler.stop()
+            if trace_path is not None:
+                Profiler.dump_trace(trace_path)
@@ -66,3 +66,30 @@ class RuntimeAPI:
         self._api.contents.memcpy_async(
             dst, src, size, libllaisys.llaisysMemcpyKind_t(kind), stream
         )
+
+    def create_event(self) -> libllaisys.llaisysEvent_t:
+        return self._api.contents.create_event()
+
+    def destroy_event(self, event: libllaisys.llaisysEvent_t) -> None:
+        self._api.contents.destroy_event(event)
+
+    def event_record(self, event: libllaisys.llaisysEvent_t, stream: libllaisys.llaisysStream_t) -> None:
+        self._api.contents.event_record(event, stream)
+
+    def stream_wait_event(self, stream: libllaisys.llaisysStream_t, event: libllaisys.llaisysEvent_t) -> None:
+        self._api.contents.stream_wait_event(stream, event)
+
+    def event_synchronize(self, event: libllaisys.llaisysEvent_t) -> None:
+        self._api.contents.event_synchronize(event)
+
+    def launch_host_func(self, stream: libllaisys.llaisysStream_t, fn, user_data=None) -> None:
+        """Runs fn(user_data) on the stream's worker in stream order. The caller must keep
+        `fn` (a libllaisys.llaisysHostFn_t) alive until the stream has run it."""
+        self._api.contents.launch_host_func(stream, fn, user_data)
+
+
+def set_huge_pages(alloc_class: libllaisys.AllocClass, mode: libllaisys.HugePageMode) -> None:
+    """Page policy for CPU allocations of at least 2 MB in `alloc_class` (process wide)."""
+    LIB_LLAISYS.llaisysCpuSetHugePages(
+        libllaisys.llaisysAllocClass_t(alloc_class), libllaisys.llaisysHugePageMode_t(mode)
+    )
@@ -1,3 +1,4 @@
+import itertools
 from typing import Sequence, Tuple
 
 from .libllaisys import (
@@ -7,8 +8,39 @@ from .libllaisys import (
     DeviceType,
     llaisysDataType_t,
     DataType,
+    llaisysDeleter_t,
 )
-from ctypes import c_size_t, c_int, c_ssize_t, c_void_p
+from . import dlpack
+from ctypes import c_size_t, c_int, c_ssize_t, c_uint8, c_void_p
+
+# numpy typestrs (__array_interface__) of the dtypes numpy can represent.
+_DTYPE_TO_TYPESTR = {
+    DataType.BOOL: "|b1",
+    DataType.BYTE: "|u1",
+    DataType.I8: "|i1",
+    DataType.I16: "<i2",
+    DataType.I32: "<i4",
+    DataType.I64: "<i8",
+    DataType.U8: "|u1",
+    DataType.U16: "<u2",
+    DataType.U32: "<u4",
+    DataType.U64: "<u8",
+    DataType.F16: "<f2",
+    DataType.F32: "<f4",
+    DataType.F64: "<f8",
+}
+_TYPESTR_TO_DTYPE = {v: k for k, v in _DTYPE_TO_TYPESTR.items() if k != DataType.BYTE}
+
+# Objects owning memory borrowed by tensors, keyed by the token handed to the C deleter.
+_borrowed = {}
+_borrow_tokens = itertools.count(1)
+
+
+@llaisysDeleter_t
+def _release_borrowed(token):
+    owner = _borrowed.pop(token, None)
+    if isinstance(owner, dlpack.ImportedBuffer):
+        owner.release()
 
 
 class Tensor:
@@ -95,3 +127,130 @@ class Tensor:
                 self._tensor, c_size_t(dim), c_size_t(start), c_size_t(end)
             )
         )
+
+    def contiguous(self):
+        return Tensor(tensor=LIB_LLAISYS.tensorContiguous(self._tensor))
+
+    def reshape(self, *shape: int):
+        _shape = (c_size_t * len(shape))(*shape)
+        return Tensor(
+            tensor=LIB_LLAISYS.tensorReshape(self._tensor, _shape, c_size_t(len(shape)))
+        )
+
+    def to(self, device: DeviceType, device_id: int = -1, non_blocking: bool = False):
+        return Tensor(
+            tensor=LIB_LLAISYS.tensorTo(
+                self._tensor,
+                llaisysDeviceType_t(device),
+                c_int(device_id),
+                c_uint8(non_blocking),
+            )
+        )
+
+    # Interop: tensors can borrow memory from numpy/torch and lend theirs without copying.
+
+    @staticmethod
+    def from_blob(
+        data: int,
+        shape: Sequence[int],
+        dtype: DataType,
+        strides: Sequence[int] = None,
+        device: DeviceType = DeviceType.CPU,
+        device_id: int = 0,
+        owner=None,
+    ):
+        """Wraps `data` without copying. `strides` are in elements; `owner` is kept alive
+        until no tensor uses the memory."""
+        if strides is not None and any(s < 0 for s in strides):
+            raise ValueError("from_blob: negative strides are not supported")
+        token = next(_borrow_tokens)
+        _borrowed[token] = owner
+        _shape = (c_size_t * max(len(shape), 1))(*shape)
+        _strides = None if strides is None else (c_ssize_t * max(len(strides), 1))(*strides)
+        return Tensor(
+            tensor=LIB_LLAISYS.tensorFromBlob(
+                c_void_p(data),
+                _shape,
+                _strides,
+                c_size_t(len(shape)),
+                llaisysDataType_t(dtype),
+                llaisysDeviceType_t(device),
+                c_int(device_id),
+                _release_borrowed,
+                c_void_p(token),
+            )
+        )
+
+    @staticmethod
+    def from_numpy(array):
+        """Shares the memory of anything exposing __array_interface__ (e.g. numpy arrays).
+        Read-only buffers are rejected: ops write through tensors freely, so pass a copy."""
+        interface = array.__array_interface__
+        if interface["data"][1]:
+            raise ValueError("from_numpy: the buffer is read-only; pass a writable copy")
+        typestr = interface["typestr"]
+        if typestr not in _TYPESTR_TO_DTYPE:
+            raise TypeError(f"from_numpy: unsupported typestr {typestr}")
+        itemsize = int(typestr[2:])
+        shape = tuple(interface["shape"])
+        strides = interface.get("strides")
+        if strides is not None:
+            if any(s % itemsize for s in strides):
+                raise ValueError("from_numpy: strides must be a multiple of the item size")
+            strides = tuple(s // itemsize for s in strides)
+        return Tensor.from_blob(
+            interface["data"][0], shape, _TYPESTR_TO_DTYPE[typestr], strides, owner=array
+        )
+
+    @staticmethod
+    def from_dlpack(obj):
+        """Takes over a DLPack producer's buffer (torch, numpy, ...) without copying."""
+        buffer = dlpack.ImportedBuffer(obj.__dlpack__())
+        try:
+            return Tensor.from_blob(
+                buffer.data,
+                buffer.shape,
+                buffer.dtype,
+                buffer.strides,
+                buffer.device,
+                buffer.device_id,
+                owner=buffer,
+            )
+        except Exception:
+            buffer.release()
+            raise
+
+    def __dlpack__(self, stream=None, **kwargs):
+        if self.device_type() != DeviceType.CPU:
+            # Consumers may use the data on any stream; finish pending work first.
+            from .runtime import RuntimeAPI
+
+            RuntimeAPI(self.device_type()).device_synchronize()
+        return dlpack.make_capsule(
+            self.data_ptr() or 0,
+            self.shape(),
+            self.strides(),
+            self.dtype(),
+            self.device_type(),
+            self.device_id(),
+            owner=self,
+        )
+
+    def __dlpack_device__(self):
+        return dlpack.to_dl_device(self.device_type(), self.device_id())
+
+    @property
+    def __array_interface__(self):
+        if self.device_type() != DeviceType.CPU:
+            raise TypeError("__array_interface__: only CPU tensors can be shared with numpy")
+        if self.dtype() not in _DTYPE_TO_TYPESTR:
+            raise TypeError(f"__array_interface__: numpy has no dtype for {self.dtype()}")
+        typestr = _DTYPE_TO_TYPESTR[self.dtype()]
+        itemsize = int(typestr[2:])
+        return {
+            "version": 3,
+            "shape": self.shape(),
+            "typestr": typestr,
+            "data": (self.data_ptr() or 0, False),
+            "strides": tuple(s * itemsize for s in self.strides()),
+        }
@@ -0,0 +1,178 @@
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace llaisys::core::profiler {
+namespace detail {
+std::atomic<bool> enabled{false};
+
+uint64_t now_ns() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+} // namespace detail
+
+namespace {
+struct Event {
+    const char *name;
+    uint64_t start_ns;
+    uint64_t dur_ns; // 0 for instant events
+    uint32_t tid;
+    bool instant;
+    OpCost cost;
+};
+
+struct Stats {
+    uint64_t calls = 0;
+    uint64_t ns = 0;
+    uint64_t bytes = 0;
+    uint64_t flops = 0;
+};
+
+struct State {
+    std::mutex mutex;
+    std::vector<Event> events;
+    // keyed by name contents, not pointer: the same op may be recorded from several literals
+    std::unordered_map<std::string, Stats> stats;
+    std::unordered_map<std::thread::id, uint32_t> tids;
+    uint64_t origin_ns = 0;
+};
+
+State &state() {
+    static State s;
+    return s;
+}
+
+// Small stable thread numbers for the trace viewer.
+uint32_t tid_locked(State &s) {
+    auto it = s.tids.find(std::this_thread::get_id());
+    if (it != s.tids.end()) return it->second;
+    auto id = static_cast<uint32_t>(s.tids.size());
+    s.tids.emplace(std::this_thread::get_id(), id);
+    return id;
+}
+
+void write_json_string(std::ostream &os, const char *str) {
+    os << '"';
+    for (const char *p = str; *p; ++p) {
+        if (*p == '"' || *p == '\\') {
+            os << '\\' << *p;
+        } else if (static_cast<unsigned char>(*p) < 0x20) {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", *p);
+            os << buf;
+        } else {
+            os << *p;
+        }
+    }
+    os << '"';
+}
+} // namespace
+
+namespace detail {
+void record(const char *name, uint64_t start_ns, uint64_t end_ns, const OpCost &cost) {
+    State &s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    const uint64_t dur = end_ns - start_ns;
+    s.events.push_back(Event{name, start_ns, dur, tid_locked(s), false, cost});
+    Stats &st = s.stats[name];
+    st.calls += 1;
+    st.ns += dur;
+    st.bytes += cost.bytes;
+    st.flops += cost.flops;
+}
+} // namespace detail
+
+void start() {
+    State &s = state();
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        if (s.events.empty()) s.origin_ns = detail::now_ns();
+    }
+    detail::enabled.store(true, std::memory_order_relaxed);
+}
+
+void stop() {
+    detail::enabled.store(false, std::memory_order_relaxed);
+}
+
+void reset() {
+    State &s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.events.clear();
+    s.stats.clear();
+    s.origin_ns = detail::now_ns();
+}
+
+void mark(const char *name) {
+    if (!enabled()) return;
+    State &s = state();
+    const uint64_t t = detail::now_ns();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.events.push_back(Event{name, t, 0, tid_locked(s), true, {}});
+}
+
+bool dumpTrace(const std::string &path) {
+    std::ofstream out(path);
+    if (!out) return false;
+    State &s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    char ts[64];
+    for (const Event &e : s.events) {
+        out << (first ? "\n" : ",\n");
+        first = false;
+        // trace timestamps are microseconds; keep ns resolution in the fraction
+        const uint64_t rel = e.start_ns >= s.origin_ns ? e.start_ns - s.origin_ns : 0;
+        std::snprintf(ts, sizeof(ts), "%.3f", rel / 1e3);
+        out << "{\"name\":";
+        write_json_string(out, e.name);
+        out << ",\"pid\":0,\"tid\":" << e.tid << ",\"ts\":" << ts;
+        if (e.instant) {
+            out << ",\"ph\":\"i\",\"s\":\"t\",\"cat\":\"stage\"}";
+            continue;
+        }
+        std::snprintf(ts, sizeof(ts), "%.3f", e.dur_ns / 1e3);
+        out << ",\"ph\":\"X\",\"cat\":\"op\",\"dur\":" << ts << ",\"args\":{\"bytes\":" << e.cost.bytes
+            << ",\"flops\":" << e.cost.flops << "}}";
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+std::string summary() {
+    State &s = state();
+    std::vector<std::pair<std::string, Stats>> rows;
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        rows.assign(s.stats.begin(), s.stats.end());
+    }
+    std::sort(rows.begin(), rows.end(), [](const auto &a, const auto &b) { return a.second.ns > b.second.ns; });
+    uint64_t total_ns = 0;
+    for (const auto &r : rows) total_ns += r.second.ns;
+
+    std::ostringstream os;
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-24s %8s %12s %10s %7s %12s %9s %10s\n", "op", "calls", "total(ms)",
+                  "avg(us)", "%", "MB", "GB/s", "GFLOP/s");
+    os << line;
+    for (const auto &[name, st] : rows) {
+        const double sec = st.ns / 1e9;
+        std::snprintf(line, sizeof(line), "%-24s %8llu %12.3f %10.2f %6.1f%% %12.2f %9.2f %10.2f\n", name.c_str(),
+                      static_cast<unsigned long long>(st.calls), st.ns / 1e6, st.calls ? st.ns / 1e3 / st.calls : 0.0,
+                      total_ns ? 100.0 * st.ns / total_ns : 0.0, st.bytes / 1e6, sec > 0 ? st.bytes / sec / 1e9 : 0.0,
+                      sec > 0 ? st.flops / sec / 1e9 : 0.0);
+        os << line;
+    }
+    return os.str();
+}
+} // namespace llaisys::core::profiler
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace llaisys::core::profiler {
+// Work done by one op call, for achieved GB/s and GFLOP/s.
+struct OpCost {
+    uint64_t bytes = 0;
+    uint64_t flops = 0;
+};
+
+namespace detail {
+extern std::atomic<bool> enabled;
+uint64_t now_ns();
+void record(const char *name, uint64_t start_ns, uint64_t end_ns, const OpCost &cost);
+} // namespace detail
+
+// Process-wide switch; when off every hook costs one relaxed load.
+inline bool enabled() {
+    return detail::enabled.load(std::memory_order_relaxed);
+}
+
+void start();
+void stop();
+// Drops everything recorded so far.
+void reset();
+
+// An instant event in the trace (e.g. a decoder stage).
+void mark(const char *name);
+
+// Chrome trace-event JSON (chrome://tracing, Perfetto). Returns false if `path` cannot be written.
+bool dumpTrace(const std::string &path);
+// Per-op table: calls, total/avg time, share, bytes, GB/s, GFLOP/s; slowest first.
+std::string summary();
+
+// Times the enclosing scope as one call of `name`. `name` must outlive the profiler (a
+// literal). The cost callback only runs while profiling, so it may inspect tensors freely.
+class Scope {
+public:
+    explicit Scope(const char *name) : Scope(name, [] { return OpCost{}; }) {}
+
+    template <typename CostFn>
+    Scope(const char *name, CostFn &&cost) {
+        if (!enabled()) return;
+        _name = name;
+        _cost = cost();
+        _start = detail::now_ns();
+    }
+
+    ~Scope() {
+        if (_name) detail::record(_name, _start, detail::now_ns(), _cost);
+    }
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+private:
+    const char *_name = nullptr;
+    uint64_t _start = 0;
+    OpCost _cost;
+};
+} // namespace llaisys::core::profiler
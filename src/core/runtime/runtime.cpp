@@ -15,6 +15,8 @@ Runtime::~Runtime() {
     if (!_is_active) {
         std::cerr << "Mallicious destruction of inactive runtime." << std::endl;
     }
+    _api->stream_synchronize(_stream);
+    _collectRetired();
     delete _allocator;
     _allocator = nullptr;
     _api->destroy_stream(_stream);
@@ -54,6 +56,14 @@ storage_t Runtime::allocateHostStorage(size_t size) {
     return std::shared_ptr<Storage>(new Storage((std::byte *)_api->malloc_host(size), size, *this, true));
 }
 
+storage_t Runtime::wrapHostStorage(std::byte *memory, size_t size, std::shared_ptr<void> owner) {
+    return std::shared_ptr<Storage>(new Storage(memory, size, *this, true, std::move(owner)));
+}
+
+storage_t Runtime::wrapDeviceStorage(std::byte *memory, size_t size, std::shared_ptr<void> owner) {
+    return std::shared_ptr<Storage>(new Storage(memory, size, *this, false, std::move(owner)));
+}
+
 void Runtime::freeStorage(Storage *storage) {
     if (storage->isHost()) {
         _api->free_host(storage->memory());
@@ -68,6 +78,41 @@ llaisysStream_t Runtime::stream() const {
 
 void Runtime::synchronize() const {
     _api->stream_synchronize(_stream);
+    _collectRetired();
+}
+
+namespace {
+struct RetiredStorage {
+    std::mutex *mutex;
+    std::vector<storage_t> *retired;
+    storage_t storage;
+};
+} // namespace
+
+void Runtime::retainUntilComplete(storage_t storage) {
+    _collectRetired();
+    // The host callback must not call back into the device API (freeing pinned memory would),
+    // so it only hands the storage back; it is freed by the next synchronize or retain.
+    auto *holder = new RetiredStorage{&_retired_mutex, &_retired, std::move(storage)};
+    _api->launch_host_func(
+        _stream,
+        [](void *p) {
+            auto *h = static_cast<RetiredStorage *>(p);
+            {
+                std::lock_guard<std::mutex> lock(*h->mutex);
+                h->retired->push_back(std::move(h->storage));
+            }
+            delete h;
+        },
+        holder);
+}
+
+void Runtime::_collectRetired() const {
+    std::vector<storage_t> done;
+    {
+        std::lock_guard<std::mutex> lock(_retired_mutex);
+        done.swap(_retired);
+    }
 }
 
 } // namespace llaisys::core
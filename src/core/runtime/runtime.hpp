@@ -4,6 +4,9 @@
 #include "../../device/runtime_api.hpp"
 #include "../allocator/allocator.hpp"
 
+#include <mutex>
+#include <vector>
+
 namespace llaisys::core {
 class Runtime {
 private:
@@ -15,6 +18,10 @@ private:
     void _activate();
     void _deactivate();
     llaisysStream_t _stream;
+    // Storages released by completed stream work, freed on the owning thread.
+    mutable std::mutex _retired_mutex;
+    mutable std::vector<storage_t> _retired;
+    void _collectRetired() const;
     Runtime(llaisysDeviceType_t device_type, int device_id);
 
 public:
@@ -39,9 +46,16 @@ public:
     storage_t allocateDeviceStorage(size_t size);
     ;
     storage_t allocateHostStorage(size_t size);
+    // Wrap host memory owned elsewhere without copying; `owner` is held until the storage dies.
+    storage_t wrapHostStorage(std::byte *memory, size_t size, std::shared_ptr<void> owner);
+    // Same for device memory of this runtime's device.
+    storage_t wrapDeviceStorage(std::byte *memory, size_t size, std::shared_ptr<void> owner);
     void freeStorage(Storage *storage);
 
     llaisysStream_t stream() const;
     void synchronize() const;
+    // Keeps `storage` alive until the work enqueued on stream() so far has run, so async copies
+    // may still read or write it after the caller drops its reference.
+    void retainUntilComplete(storage_t storage);
 };
 } // namespace llaisys::core
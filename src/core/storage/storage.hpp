@@ -12,7 +12,10 @@ private:
     size_t _size;
     Runtime &_runtime;
     bool _is_host;
-    Storage(std::byte *memory, size_t size, Runtime &runtime, bool is_host);
+    // Keeps externally owned memory (e.g. a file mapping) alive; such storage is never freed
+    // through the runtime.
+    std::shared_ptr<void> _owner;
+    Storage(std::byte *memory, size_t size, Runtime &runtime, bool is_host, std::shared_ptr<void> owner = nullptr);
 
 public:
     friend class Runtime;
@@ -23,6 +26,9 @@ public:
     llaisysDeviceType_t deviceType() const;
     int deviceId() const;
     bool isHost() const;
+    // Page-locked host memory from a device runtime, usable directly by async copies.
+    bool isPinned() const;
+    bool isExternal() const;
 };
 
 }; // namespace llaisys::core
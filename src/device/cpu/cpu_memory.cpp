@@ -0,0 +1,105 @@
+#include "cpu_memory.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <unordered_map>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace llaisys::device::cpu {
+namespace {
+std::atomic<int> g_modes[LLAISYS_ALLOC_CLASS_COUNT] = {};
+thread_local llaisysAllocClass_t t_class = LLAISYS_ALLOC_ACTIVATION;
+
+// MAP_HUGETLB blocks have to be munmap'ed with their size; everything else goes to free().
+std::mutex g_hugetlb_mutex;
+std::unordered_map<void *, size_t> g_hugetlb;
+std::atomic<size_t> g_hugetlb_count{0};
+
+size_t round_up(size_t size) {
+    return (size + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+}
+
+#if defined(__linux__)
+void *allocate_transparent(size_t size) {
+    void *ptr = nullptr;
+    // 2 MB alignment lets the kernel back the whole range with huge pages
+    if (posix_memalign(&ptr, kHugePageSize, round_up(size)) != 0) return nullptr;
+    (void)madvise(ptr, round_up(size), MADV_HUGEPAGE);
+    return ptr;
+}
+
+void *allocate_hugetlb(size_t size) {
+    void *ptr = mmap(nullptr, round_up(size), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (ptr == MAP_FAILED) return nullptr;
+    std::lock_guard<std::mutex> lock(g_hugetlb_mutex);
+    g_hugetlb.emplace(ptr, round_up(size));
+    g_hugetlb_count.fetch_add(1, std::memory_order_relaxed);
+    return ptr;
+}
+#endif
+} // namespace
+
+void set_huge_page_mode(llaisysAllocClass_t alloc_class, llaisysHugePageMode_t mode) {
+    if (alloc_class < 0 || alloc_class >= LLAISYS_ALLOC_CLASS_COUNT) return;
+    g_modes[alloc_class].store(mode, std::memory_order_relaxed);
+}
+
+llaisysHugePageMode_t huge_page_mode(llaisysAllocClass_t alloc_class) {
+    if (alloc_class < 0 || alloc_class >= LLAISYS_ALLOC_CLASS_COUNT) return LLAISYS_HUGE_PAGE_NONE;
+    return static_cast<llaisysHugePageMode_t>(g_modes[alloc_class].load(std::memory_order_relaxed));
+}
+
+llaisysAllocClass_t current_alloc_class() {
+    return t_class;
+}
+
+AllocClassScope::AllocClassScope(llaisysAllocClass_t alloc_class) : _prev(t_class) {
+    t_class = alloc_class;
+}
+
+AllocClassScope::~AllocClassScope() {
+    t_class = _prev;
+}
+
+void *allocate(size_t size) {
+#if defined(__linux__)
+    if (size >= kHugePageSize) {
+        switch (huge_page_mode(t_class)) {
+        case LLAISYS_HUGE_PAGE_EXPLICIT:
+            // the reserved pool may be empty or absent; transparent pages are the next best
+            if (void *ptr = allocate_hugetlb(size)) return ptr;
+            [[fallthrough]];
+        case LLAISYS_HUGE_PAGE_TRANSPARENT:
+            if (void *ptr = allocate_transparent(size)) return ptr;
+            break;
+        default:
+            break;
+        }
+    }
+#endif
+    return std::malloc(size);
+}
+
+void release(void *ptr) {
+    if (!ptr) return;
+#if defined(__linux__)
+    if (g_hugetlb_count.load(std::memory_order_relaxed) > 0) {
+        std::unique_lock<std::mutex> lock(g_hugetlb_mutex);
+        auto it = g_hugetlb.find(ptr);
+        if (it != g_hugetlb.end()) {
+            size_t size = it->second;
+            g_hugetlb.erase(it);
+            g_hugetlb_count.fetch_sub(1, std::memory_order_relaxed);
+            lock.unlock();
+            munmap(ptr, size);
+            return;
+        }
+    }
+#endif
+    std::free(ptr);
+}
+} // namespace llaisys::device::cpu
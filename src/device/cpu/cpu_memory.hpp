@@ -0,0 +1,32 @@
+#pragma once
+
+#include "llaisys.h"
+
+#include <cstddef>
+
+namespace llaisys::device::cpu {
+constexpr size_t kHugePageSize = size_t(2) << 20;
+
+// Page policy per allocation class; allocations below kHugePageSize always use malloc.
+void set_huge_page_mode(llaisysAllocClass_t alloc_class, llaisysHugePageMode_t mode);
+llaisysHugePageMode_t huge_page_mode(llaisysAllocClass_t alloc_class);
+
+// Class of CPU allocations made by the calling thread (activations by default).
+llaisysAllocClass_t current_alloc_class();
+
+// Tags the calling thread's allocations with `alloc_class` for the lifetime of the scope.
+class AllocClassScope {
+public:
+    explicit AllocClassScope(llaisysAllocClass_t alloc_class);
+    ~AllocClassScope();
+
+    AllocClassScope(const AllocClassScope &) = delete;
+    AllocClassScope &operator=(const AllocClassScope &) = delete;
+
+private:
+    llaisysAllocClass_t _prev;
+};
+
+void *allocate(size_t size);
+void release(void *ptr);
+} // namespace llaisys::device::cpu
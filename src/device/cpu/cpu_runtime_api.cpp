@@ -1,4 +1,6 @@
 #include "../runtime_api.hpp"
+#include "cpu_memory.hpp"
+#include "cpu_stream.hpp"
 
 #include <cstdlib>
 #include <cstring>
@@ -15,26 +17,26 @@ void setDevice(int) {
 }
 
 void deviceSynchronize() {
-    // do nothing
+    Stream::synchronizeAll();
 }
 
 llaisysStream_t createStream() {
-    return (llaisysStream_t)0; // null stream
+    return new Stream();
 }
 
 void destroyStream(llaisysStream_t stream) {
-    // do nothing
+    delete static_cast<Stream *>(stream);
 }
 void streamSynchronize(llaisysStream_t stream) {
-    // do nothing
+    if (stream) static_cast<Stream *>(stream)->synchronize();
 }
 
 void *mallocDevice(size_t size) {
-    return std::malloc(size);
+    return cpu::allocate(size);
 }
 
 void freeDevice(void *ptr) {
-    std::free(ptr);
+    cpu::release(ptr);
 }
 
 void *mallocHost(size_t size) {
@@ -50,7 +52,33 @@ void memcpySync(void *dst, const void *src, size_t size, llaisysMemcpyKind_t kin
 }
 
 void memcpyAsync(void *dst, const void *src, size_t size, llaisysMemcpyKind_t kind, llaisysStream_t stream) {
-    memcpySync(dst, src, size, kind);
+    if (!stream) return memcpySync(dst, src, size, kind);
+    static_cast<Stream *>(stream)->enqueue([=] { std::memcpy(dst, src, size); });
+}
+
+llaisysEvent_t createEvent() {
+    return new Event();
+}
+
+void destroyEvent(llaisysEvent_t event) {
+    delete static_cast<Event *>(event);
+}
+
+void eventRecord(llaisysEvent_t event, llaisysStream_t stream) {
+    static_cast<Event *>(event)->record(static_cast<Stream *>(stream));
+}
+
+void streamWaitEvent(llaisysStream_t stream, llaisysEvent_t event) {
+    static_cast<Event *>(event)->wait(static_cast<Stream *>(stream));
+}
+
+void eventSynchronize(llaisysEvent_t event) {
+    static_cast<Event *>(event)->synchronize();
+}
+
+void launchHostFunc(llaisysStream_t stream, llaisysHostFn_t fn, void *user_data) {
+    if (!stream) return fn(user_data);
+    static_cast<Stream *>(stream)->enqueue([=] { fn(user_data); });
 }
 
 static const LlaisysRuntimeAPI RUNTIME_API = {
@@ -65,7 +93,13 @@ static const LlaisysRuntimeAPI RUNTIME_API = {
     &mallocHost,
     &freeHost,
     &memcpySync,
-    &memcpyAsync};
+    &memcpyAsync,
+    &createEvent,
+    &destroyEvent,
+    &eventRecord,
+    &streamWaitEvent,
+    &eventSynchronize,
+    &launchHostFunc};
 
 } // namespace runtime_api
 
@@ -0,0 +1,158 @@
+#include "cpu_stream.hpp"
+
+#include <deque>
+#include <iostream>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+namespace llaisys::device::cpu {
+class StreamQueue {
+public:
+    ~StreamQueue() { stop(); }
+
+    void enqueue(std::function<void()> task);
+    void synchronize();
+    // Lets the worker drain the queue and joins it.
+    void stop();
+
+private:
+    void run();
+
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::condition_variable _idle;
+    std::deque<std::function<void()>> _tasks;
+    bool _busy{false};
+    bool _stop{false};
+    std::thread _worker;
+};
+
+namespace {
+std::mutex g_streams_mutex;
+std::unordered_set<std::shared_ptr<StreamQueue>> g_streams;
+} // namespace
+
+void StreamQueue::enqueue(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _tasks.push_back(std::move(task));
+        if (!_worker.joinable()) _worker = std::thread(&StreamQueue::run, this);
+    }
+    _cv.notify_one();
+}
+
+void StreamQueue::synchronize() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _idle.wait(lock, [this] { return _tasks.empty() && !_busy; });
+}
+
+void StreamQueue::stop() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _cv.notify_one();
+    // the worker drains the queue before it exits
+    if (_worker.joinable()) _worker.join();
+}
+
+void StreamQueue::run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    for (;;) {
+        _cv.wait(lock, [this] { return _stop || !_tasks.empty(); });
+        if (_tasks.empty()) return; // stopped and drained
+        std::function<void()> task = std::move(_tasks.front());
+        _tasks.pop_front();
+        _busy = true;
+        lock.unlock();
+        try {
+            task();
+        } catch (const std::exception &e) {
+            // nothing to return the error to; later work on the stream still runs
+            std::cerr << "[ERROR] CPU stream task failed: " << e.what() << std::endl;
+        } catch (...) {
+            std::cerr << "[ERROR] CPU stream task failed: unknown exception" << std::endl;
+        }
+        lock.lock();
+        _busy = false;
+        if (_tasks.empty()) _idle.notify_all();
+    }
+}
+
+Stream::Stream() : _queue(std::make_shared<StreamQueue>()) {
+    std::lock_guard<std::mutex> lock(g_streams_mutex);
+    g_streams.insert(_queue);
+}
+
+Stream::~Stream() {
+    {
+        std::lock_guard<std::mutex> lock(g_streams_mutex);
+        g_streams.erase(_queue);
+    }
+    _queue->stop();
+}
+
+void Stream::enqueue(std::function<void()> task) {
+    _queue->enqueue(std::move(task));
+}
+
+void Stream::synchronize() {
+    _queue->synchronize();
+}
+
+void Stream::synchronizeAll() {
+    // blocking under the registry lock would deadlock a task that creates or destroys a stream
+    std::vector<std::shared_ptr<StreamQueue>> queues;
+    {
+        std::lock_guard<std::mutex> lock(g_streams_mutex);
+        queues.assign(g_streams.begin(), g_streams.end());
+    }
+    for (const auto &queue : queues) queue->synchronize();
+}
+
+std::shared_ptr<Event::Record> Event::last() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _last;
+}
+
+void Event::record(Stream *stream) {
+    auto record = std::make_shared<Record>();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _last = record;
+    }
+    if (stream) {
+        stream->enqueue([record] { record->complete(); });
+    } else {
+        record->complete();
+    }
+}
+
+void Event::wait(Stream *stream) {
+    auto record = last();
+    if (!record) return;
+    if (stream) {
+        stream->enqueue([record] { record->waitFor(); });
+    } else {
+        record->waitFor();
+    }
+}
+
+void Event::synchronize() {
+    if (auto record = last()) record->waitFor();
+}
+
+void Event::Record::complete() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+    }
+    cv.notify_all();
+}
+
+void Event::Record::waitFor() {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [this] { return done; });
+}
+} // namespace llaisys::device::cpu
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace llaisys::device::cpu {
+class StreamQueue;
+
+// In-order task queue drained by one worker thread, started on the first enqueue. The null
+// stream (nullptr in the runtime API) stays synchronous: work runs on the calling thread.
+class Stream {
+public:
+    Stream();
+    ~Stream();
+
+    Stream(const Stream &) = delete;
+    Stream &operator=(const Stream &) = delete;
+
+    void enqueue(std::function<void()> task);
+    // Blocks until every task enqueued so far has finished.
+    void synchronize();
+
+    // Waits for all live streams (deviceSynchronize). Tasks may create and destroy streams
+    // meanwhile; a stream destroyed during the wait has drained its queue by then.
+    static void synchronizeAll();
+
+private:
+    // shared with synchronizeAll, which may still hold it while the stream is destroyed
+    std::shared_ptr<StreamQueue> _queue;
+};
+
+// A point in a stream. record() captures the work enqueued so far; the event completes once
+// that work has run. Re-recording moves the event forward, as with device events: waiters
+// then wait for the new point only, whichever stream it was recorded on. Each record has its
+// own completion state shared with the queued tasks, so an event may be destroyed while work
+// still refers to it.
+class Event {
+public:
+    void record(Stream *stream);
+    // Makes later work on `stream` wait for the currently recorded point.
+    void wait(Stream *stream);
+    void synchronize();
+
+private:
+    struct Record {
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool done{false};
+
+        void complete();
+        void waitFor();
+    };
+    // the last recorded point; null (never recorded) counts as complete
+    std::shared_ptr<Record> last();
+
+    std::mutex _mutex;
+    std::shared_ptr<Record> _last;
+};
+} // namespace llaisys::device::cpu
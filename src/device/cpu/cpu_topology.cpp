@@ -0,0 +1,73 @@
+#include "cpu_topology.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace llaisys::device::cpu {
+namespace {
+// Parses the kernel list format, e.g. "0-7,16-23".
+std::vector<int> parse_list(const std::string &text) {
+    std::vector<int> out;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty() || item == "\n") continue;
+        size_t dash = item.find('-');
+        try {
+            int lo = std::stoi(item.substr(0, dash));
+            int hi = dash == std::string::npos ? lo : std::stoi(item.substr(dash + 1));
+            for (int i = lo; i <= hi; ++i) out.push_back(i);
+        } catch (const std::exception &) {
+            return {};
+        }
+    }
+    return out;
+}
+
+std::string read_line(const std::string &path) {
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    return line;
+}
+
+std::vector<NumaNode> detect() {
+    std::vector<NumaNode> nodes;
+#if defined(__linux__)
+    for (int id : parse_list(read_line("/sys/devices/system/node/online"))) {
+        std::vector<int> cpus = parse_list(read_line("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist"));
+        // memory-only nodes (e.g. CXL expanders) have no cores to run on
+        if (!cpus.empty()) nodes.push_back({id, std::move(cpus)});
+    }
+#endif
+    if (nodes.empty()) nodes.push_back({0, {}});
+    return nodes;
+}
+} // namespace
+
+const std::vector<NumaNode> &numa_nodes() {
+    static const std::vector<NumaNode> nodes = detect();
+    return nodes;
+}
+
+bool pin_current_thread(const std::vector<int> &cpus) {
+#if defined(__linux__)
+    if (cpus.empty()) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : cpus) {
+        if (c >= 0 && c < CPU_SETSIZE) CPU_SET(c, &set);
+    }
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)cpus;
+    return false;
+#endif
+}
+} // namespace llaisys::device::cpu
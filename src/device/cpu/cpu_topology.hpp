@@ -0,0 +1,18 @@
+#pragma once
+
+#include <vector>
+
+namespace llaisys::device::cpu {
+struct NumaNode {
+    int id;
+    // Logical CPUs of the node; empty when the platform does not report them.
+    std::vector<int> cpus;
+};
+
+// NUMA nodes of the host, detected once (Linux: /sys/devices/system/node). Hosts without
+// NUMA information report a single node.
+const std::vector<NumaNode> &numa_nodes();
+
+// Restricts the calling thread to `cpus`. Returns false if unsupported or refused.
+bool pin_current_thread(const std::vector<int> &cpus);
+} // namespace llaisys::device::cpu
@@ -1,6 +1,7 @@
 // Qwen2 C API implementation (skeleton)
 #include "llaisys/models/qwen2.h"
 #include "../../models/qwen2/qwen2.hpp"
+#include "../../models/qwen2/qwen2_loader.hpp"
 
 #include <algorithm>
 #include <cstring>
@@ -11,6 +12,7 @@
 struct LlaisysQwen2Model {
 	LlaisysQwen2Meta meta{};
 	LlaisysQwen2Weights weights{};
+	LlaisysQwen2LoadStats load_stats{};
 	llaisysDeviceType_t device = LLAISYS_DEVICE_CPU;
 	std::vector<int> device_ids;
 	std::unique_ptr<llaisys::models::Qwen2> impl;
@@ -93,18 +95,67 @@ __C {
 		return model;
 	}
 
+	__export struct LlaisysQwen2Model *llaisysQwen2ModelLoad(
+		const char *model_dir,
+		llaisysDeviceType_t device,
+		int *device_ids,
+		int ndevice) {
+		return llaisysQwen2ModelLoadWithOptions(model_dir, nullptr, device, device_ids, ndevice);
+	}
+
+	__export struct LlaisysQwen2Model *llaisysQwen2ModelLoadWithOptions(
+		const char *model_dir,
+		const struct LlaisysQwen2LoadOptions *options,
+		llaisysDeviceType_t device,
+		int *device_ids,
+		int ndevice) {
+		if (!model_dir || ndevice <= 0) return nullptr;
+		LlaisysQwen2Model *model = nullptr;
+		try {
+			llaisys::models::Qwen2LoadOptions opts;
+			if (options) {
+				opts.weight_dtype = options->weight_dtype;
+				if (options->cache_path) opts.cache_path = options->cache_path;
+				opts.numa = options->numa != 0;
+			}
+			llaisys::models::Qwen2Checkpoint ckpt = llaisys::models::load_qwen2_checkpoint(model_dir, opts);
+			model = llaisysQwen2ModelCreate(&ckpt.meta, device, device_ids, ndevice);
+			if (!model) return nullptr;
+			llaisys::models::assign_qwen2_weights(model->weights, model->meta, ckpt.tensors, device, device_ids[0]);
+			model->load_stats = ckpt.stats;
+			return model;
+		} catch (const std::exception &e) {
+			std::cerr << "[ERROR] Qwen2 load failed: " << e.what() << std::endl;
+		} catch (...) {
+			std::cerr << "[ERROR] Qwen2 load failed: unknown exception" << std::endl;
+		}
+		llaisysQwen2ModelDestroy(model);
+		return nullptr;
+	}
+
+	__export const struct LlaisysQwen2LoadStats *llaisysQwen2ModelLoadStats(struct LlaisysQwen2Model *model) {
+		if (!model) return nullptr;
+		return &model->load_stats;
+	}
+
+	__export const struct LlaisysQwen2Meta *llaisysQwen2ModelMeta(struct LlaisysQwen2Model *model) {
+		if (!model) return nullptr;
+		return &model->meta;
+	}
+
     //销毁千问2模型实例
 	__export void llaisysQwen2ModelDestroy(struct LlaisysQwen2Model *model) {
 		if (!model) return;
 
+		//共享 embedding 时 out_embed 与 in_embed 是同一个句柄，只释放一次
+		if (model->weights.out_embed && model->weights.out_embed != model->weights.in_embed) {
+			tensorDestroy(model->weights.out_embed);
+		}
+		model->weights.out_embed = nullptr;
 		if (model->weights.in_embed) {
 			tensorDestroy(model->weights.in_embed);
 			model->weights.in_embed = nullptr;
 		}
-		if (model->weights.out_embed) {
-			tensorDestroy(model->weights.out_embed);
-			model->weights.out_embed = nullptr;
-		}
 		if (model->weights.out_norm_w) {
 			tensorDestroy(model->weights.out_norm_w);
 			model->weights.out_norm_w = nullptr;
@@ -163,6 +214,40 @@ __C {
 		}
 	}
 
+	__export uint8_t llaisysQwen2ModelPrefillOutputs(struct LlaisysQwen2Model *model,
+	                                                 int64_t *token_ids,
+	                                                 size_t ntoken,
+	                                                 llaisysTensor_t out_logits,
+	                                                 llaisysTensor_t out_hidden) {
+		if (!model || !model->impl) return 0;
+		try {
+			return model->impl->prefillOutputs(token_ids, ntoken, out_logits, out_hidden) ? 1 : 0;
+		} catch (const std::exception &e) {
+			std::cerr << "[ERROR] Qwen2 prefill failed: " << e.what() << std::endl;
+			return 0;
+		} catch (...) {
+			std::cerr << "[ERROR] Qwen2 prefill failed: unknown exception" << std::endl;
+			return 0;
+		}
+	}
+
+	__export uint8_t llaisysQwen2ModelStepOutputs(struct LlaisysQwen2Model *model,
+	                                              int64_t *token_ids,
+	                                              size_t ntoken,
+	                                              llaisysTensor_t out_logits,
+	                                              llaisysTensor_t out_hidden) {
+		if (!model || !model->impl) return 0;
+		try {
+			return model->impl->stepOutputs(token_ids, ntoken, out_logits, out_hidden) ? 1 : 0;
+		} catch (const std::exception &e) {
+			std::cerr << "[ERROR] Qwen2 step failed: " << e.what() << std::endl;
+			return 0;
+		} catch (...) {
+			std::cerr << "[ERROR] Qwen2 step failed: unknown exception" << std::endl;
+			return 0;
+		}
+	}
+
 	__export int64_t llaisysQwen2ModelInferSampling(struct LlaisysQwen2Model *model,
 	                                                int64_t *token_ids,
 	                                                size_t ntoken,
@@ -187,8 +272,38 @@ __C {
 		model->impl->resetKVCache();
 	}
 
+	__export uint8_t llaisysQwen2ModelTruncateKVCache(struct LlaisysQwen2Model *model, size_t len) {
+		if (!model || !model->impl) return 0;
+		return model->impl->truncateKVCache(len) ? 1 : 0;
+	}
+
+	__export size_t llaisysQwen2ModelKVCacheLength(struct LlaisysQwen2Model *model) {
+		if (!model || !model->impl) return 0;
+		return model->impl->kvCacheLength();
+	}
+
 	__export void llaisysQwen2ModelSetKVCacheEnabled(struct LlaisysQwen2Model *model, uint8_t enabled) {
 		if (!model || !model->impl) return;
 		model->impl->setKVCacheEnabled(enabled != 0);
 	}
+
+	__export uint8_t llaisysQwen2ModelSetKVCacheDtype(struct LlaisysQwen2Model *model, llaisysDataType_t dtype) {
+		if (!model || !model->impl) return 0;
+		return model->impl->setKVCacheDtype(dtype) ? 1 : 0;
+	}
+
+	__export size_t llaisysQwen2ModelSetWeightPaging(struct LlaisysQwen2Model *model, size_t prefetch_layers, uint8_t evict) {
+		if (!model || !model->impl) return 0;
+		try {
+			return model->impl->setWeightPaging(prefetch_layers, evict != 0);
+		} catch (const std::exception &e) {
+			std::cerr << "[ERROR] Qwen2 weight paging: " << e.what() << std::endl;
+			return 0;
+		}
+	}
+
+	__export void llaisysQwen2ModelSetDecodePlan(struct LlaisysQwen2Model *model, uint8_t enabled) {
+		if (!model || !model->impl) return;
+		model->impl->setDecodePlanEnabled(enabled != 0);
+	}
 }
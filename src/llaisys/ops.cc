@@ -2,45 +2,111 @@
 
 #include "llaisys_tensor.hpp"
 
+#include "../core/profiler/profiler.hpp"
+
 #include "../ops/add/op.hpp"
 #include "../ops/argmax/op.hpp"
 #include "../ops/embedding/op.hpp"
 #include "../ops/linear/op.hpp"
+#include "../ops/mul/op.hpp"
+#include "../ops/quantize/op.hpp"
 #include "../ops/rearrange/op.hpp"
 #include "../ops/rms_norm/op.hpp"
 #include "../ops/rope/op.hpp"
 #include "../ops/self_attention/op.hpp"
 #include "../ops/swiglu/op.hpp"
 
+#include <initializer_list>
+
+namespace {
+using llaisys::core::profiler::OpCost;
+using llaisys::core::profiler::Scope;
+
+// Bytes a kernel touches in `t`; quantized tensors are counted with their row headers.
+uint64_t bytes_of(const llaisys::tensor_t &t) {
+    if (!t || t->ndim() == 0) return t ? t->elementSize() : 0;
+    const size_t cols = t->shape().back();
+    const size_t rows = cols ? t->numel() / cols : 0;
+    return rows * llaisys::utils::row_bytes(t->dtype(), cols);
+}
+
+// Reads every input once, writes the output once, `flops_per_elem` per output element.
+OpCost pointwise(const llaisys::tensor_t &out, std::initializer_list<const llaisys::tensor_t *> in,
+                 uint64_t flops_per_elem) {
+    OpCost cost{bytes_of(out), flops_per_elem * out->numel()};
+    for (const auto *t : in) cost.bytes += bytes_of(*t);
+    return cost;
+}
+} // namespace
+
 __C {
     void llaisysAdd(llaisysTensor_t c, llaisysTensor_t a, llaisysTensor_t b) {
+        Scope scope("add", [&] { return pointwise(c->tensor, {&a->tensor, &b->tensor}, 1); });
         llaisys::ops::add(c->tensor, a->tensor, b->tensor);
     }
+    void llaisysAddInplace(llaisysTensor_t a, llaisysTensor_t b) {
+        Scope scope("add", [&] { return pointwise(a->tensor, {&a->tensor, &b->tensor}, 1); });
+        llaisys::ops::add(a->tensor, a->tensor, b->tensor);
+    }
     void llaisysArgmax(llaisysTensor_t max_idx, llaisysTensor_t max_val, llaisysTensor_t vals) {
+        Scope scope("argmax", [&] { return OpCost{bytes_of(vals->tensor), vals->tensor->numel()}; });
         llaisys::ops::argmax(max_idx->tensor, max_val->tensor, vals->tensor);
     }
     void llaisysEmbedding(llaisysTensor_t out, llaisysTensor_t index, llaisysTensor_t weight) {
+        // gathered weight rows are read once and written once
+        Scope scope("embedding", [&] { return pointwise(out->tensor, {&out->tensor, &index->tensor}, 0); });
         llaisys::ops::embedding(out->tensor, index->tensor, weight->tensor);
     }
+    void llaisysMul(llaisysTensor_t c, llaisysTensor_t a, llaisysTensor_t b) {
+        Scope scope("mul", [&] { return pointwise(c->tensor, {&a->tensor, &b->tensor}, 1); });
+        llaisys::ops::mul(c->tensor, a->tensor, b->tensor);
+    }
+    void llaisysMulInplace(llaisysTensor_t a, llaisysTensor_t b) {
+        Scope scope("mul", [&] { return pointwise(a->tensor, {&a->tensor, &b->tensor}, 1); });
+        llaisys::ops::mul(a->tensor, a->tensor, b->tensor);
+    }
     void llaisysLinear(llaisysTensor_t out, llaisysTensor_t in, llaisysTensor_t weight, llaisysTensor_t bias) {
+        Scope scope("linear", [&] {
+            OpCost cost = pointwise(out->tensor, {&in->tensor, &weight->tensor}, 0);
+            if (bias) cost.bytes += bytes_of(bias->tensor);
+            const auto &w = weight->tensor->shape();
+            if (w.size() == 2) cost.flops = 2ull * out->tensor->numel() * w[1];
+            return cost;
+        });
         llaisys::ops::linear(out->tensor,
                              in->tensor,
                              weight->tensor,
                              bias ? bias->tensor : nullptr);
     }
+    void llaisysQuantize(llaisysTensor_t out, llaisysTensor_t in) {
+        Scope scope("quantize", [&] { return pointwise(out->tensor, {&in->tensor}, 2); });
+        llaisys::ops::quantize(out->tensor, in->tensor);
+    }
     void llaisysRearrange(llaisysTensor_t out, llaisysTensor_t in) {
+        Scope scope("rearrange", [&] { return pointwise(out->tensor, {&in->tensor}, 0); });
         llaisys::ops::rearrange(out->tensor, in->tensor);
     }
     void llaisysRmsNorm(llaisysTensor_t out, llaisysTensor_t in, llaisysTensor_t weight, float eps) {
+        Scope scope("rms_norm", [&] { return pointwise(out->tensor, {&in->tensor, &weight->tensor}, 4); });
         llaisys::ops::rms_norm(out->tensor, in->tensor, weight->tensor, eps);
     }
     void llaisysROPE(llaisysTensor_t out, llaisysTensor_t in, llaisysTensor_t pos_ids, float theta) {
+        Scope scope("rope", [&] { return pointwise(out->tensor, {&in->tensor, &pos_ids->tensor}, 3); });
         llaisys::ops::rope(out->tensor, in->tensor, pos_ids->tensor, theta);
     }
     void llaisysSelfAttention(llaisysTensor_t attn_val, llaisysTensor_t q, llaisysTensor_t k, llaisysTensor_t v, float scale) {
+        Scope scope("self_attention", [&] {
+            OpCost cost = pointwise(attn_val->tensor, {&q->tensor, &k->tensor, &v->tensor}, 0);
+            // QK^T and PV: 2 * 2 * qlen * kvlen * dim per query head
+            const auto &qs = q->tensor->shape();
+            const auto &ks = k->tensor->shape();
+            if (qs.size() == 3 && ks.size() == 3) cost.flops = 4ull * qs[0] * ks[0] * qs[1] * qs[2];
+            return cost;
+        });
         llaisys::ops::self_attention(attn_val->tensor, q->tensor, k->tensor, v->tensor, scale);
     }
     void llaisysSwiGLU(llaisysTensor_t out, llaisysTensor_t gate, llaisysTensor_t up) {
+        Scope scope("swiglu", [&] { return pointwise(out->tensor, {&gate->tensor, &up->tensor}, 4); });
         llaisys::ops::swiglu(out->tensor, gate->tensor, up->tensor);
     }
 }
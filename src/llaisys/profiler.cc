@@ -0,0 +1,34 @@
+#include "llaisys/profiler.h"
+
+#include "../core/profiler/profiler.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace profiler = llaisys::core::profiler;
+
+__C {
+    void llaisysProfilerStart() {
+        profiler::start();
+    }
+    void llaisysProfilerStop() {
+        profiler::stop();
+    }
+    void llaisysProfilerReset() {
+        profiler::reset();
+    }
+    int llaisysProfilerDumpTrace(const char *path) {
+        if (!path || path[0] == '\0') return -1;
+        return profiler::dumpTrace(path) ? 0 : -1;
+    }
+    size_t llaisysProfilerSummary(char *buf, size_t size) {
+        const std::string table = profiler::summary();
+        if (buf && size > 0) {
+            const size_t n = std::min(table.size(), size - 1);
+            std::memcpy(buf, table.data(), n);
+            buf[n] = '\0';
+        }
+        return table.size();
+    }
+}
@@ -1,5 +1,6 @@
 #include "llaisys/runtime.h"
 #include "../core/context/context.hpp"
+#include "../device/cpu/cpu_memory.hpp"
 #include "../device/runtime_api.hpp"
 
 // Llaisys API for setting context runtime.
@@ -10,4 +11,9 @@ __C void llaisysSetContextRuntime(llaisysDeviceType_t device_type, int device_id
 // Llaisys API for getting the runtime APIs
 __C const LlaisysRuntimeAPI *llaisysGetRuntimeAPI(llaisysDeviceType_t device_type) {
     return llaisys::device::getRuntimeAPI(device_type);
-}
\ No newline at end of file
+}
+
+// Llaisys API for choosing the page policy of a CPU allocation class
+__C void llaisysCpuSetHugePages(llaisysAllocClass_t alloc_class, llaisysHugePageMode_t mode) {
+    llaisys::device::cpu::set_huge_page_mode(alloc_class, mode);
+}
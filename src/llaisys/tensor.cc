@@ -9,8 +9,52 @@ __C {
         llaisysDataType_t dtype,
         llaisysDeviceType_t device_type,
         int device_id) {
-        std::vector<size_t> shape_vec(shape, shape + ndim);
-        return new LlaisysTensor{llaisys::Tensor::create(shape_vec, dtype, device_type, device_id)};
+        return new LlaisysTensor{llaisys::Tensor::create(llaisys::TensorShape(shape, shape + ndim), dtype, device_type, device_id)};
+    }
+
+    llaisysTensor_t tensorFromBlob(
+        void *data,
+        size_t * shape,
+        ptrdiff_t * strides,
+        size_t ndim,
+        llaisysDataType_t dtype,
+        llaisysDeviceType_t device_type,
+        int device_id,
+        llaisysDeleter_t deleter,
+        void *deleter_ctx) {
+        llaisys::TensorShape shape_(shape, shape + ndim);
+        llaisys::TensorStrides strides_(ndim);
+        size_t bytes = 0;
+        if (strides) {
+            strides_ = llaisys::TensorStrides(strides, strides + ndim);
+            size_t extent = 1;
+            for (size_t i = 0; i < ndim; ++i) {
+                if (shape[i] == 0) extent = 0;
+                if (extent && strides[i] > 0) extent += (shape[i] - 1) * size_t(strides[i]);
+            }
+            bytes = extent * llaisys::utils::dsize(dtype);
+        } else {
+            size_t rows = 1;
+            for (size_t i = 0; i + 1 < ndim; ++i) rows *= shape[i];
+            bytes = rows * llaisys::utils::row_bytes(dtype, ndim ? shape[ndim - 1] : 1);
+        }
+
+        // The owner handle points at the data so it is never null; releasing it calls the deleter.
+        std::shared_ptr<void> owner(data, [deleter, deleter_ctx](void *) {
+            if (deleter) deleter(deleter_ctx);
+        });
+        auto *memory = static_cast<std::byte *>(data);
+        llaisys::core::storage_t storage;
+        if (device_type == LLAISYS_DEVICE_CPU) {
+            storage = llaisys::core::context().runtime().wrapHostStorage(memory, bytes, std::move(owner));
+        } else {
+            llaisys::core::context().setDevice(device_type, device_id);
+            storage = llaisys::core::context().runtime().wrapDeviceStorage(memory, bytes, std::move(owner));
+        }
+        if (!strides) {
+            return new LlaisysTensor{llaisys::Tensor::create(shape_, dtype, std::move(storage))};
+        }
+        return new LlaisysTensor{llaisys::Tensor::create(shape_, strides_, dtype, std::move(storage))};
     }
 
     void tensorDestroy(
@@ -75,15 +119,13 @@ __C {
         llaisysTensor_t tensor,
         size_t * shape,
         size_t ndim) {
-        std::vector<size_t> shape_vec(shape, shape + ndim);
-        return new LlaisysTensor{tensor->tensor->view(shape_vec)};
+        return new LlaisysTensor{tensor->tensor->view(llaisys::TensorShape(shape, shape + ndim))};
     }
 
     llaisysTensor_t tensorPermute(
         llaisysTensor_t tensor,
         size_t * order) {
-        std::vector<size_t> order_vec(order, order + tensor->tensor->ndim());
-        return new LlaisysTensor{tensor->tensor->permute(order_vec)};
+        return new LlaisysTensor{tensor->tensor->permute(llaisys::TensorShape(order, order + tensor->tensor->ndim()))};
     }
 
     llaisysTensor_t tensorSlice(
@@ -93,4 +135,24 @@ __C {
         size_t end) {
         return new LlaisysTensor{tensor->tensor->slice(dim, start, end)};
     }
+
+    llaisysTensor_t tensorContiguous(
+        llaisysTensor_t tensor) {
+        return new LlaisysTensor{tensor->tensor->contiguous()};
+    }
+
+    llaisysTensor_t tensorReshape(
+        llaisysTensor_t tensor,
+        size_t * shape,
+        size_t ndim) {
+        return new LlaisysTensor{tensor->tensor->reshape(llaisys::TensorShape(shape, shape + ndim))};
+    }
+
+    llaisysTensor_t tensorTo(
+        llaisysTensor_t tensor,
+        llaisysDeviceType_t device_type,
+        int device_id,
+        uint8_t non_blocking) {
+        return new LlaisysTensor{tensor->tensor->to(device_type, device_id, non_blocking != 0)};
+    }
 }
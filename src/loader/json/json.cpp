@@ -0,0 +1,254 @@
+#include "json.hpp"
+
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace llaisys::loader {
+class JsonParser {
+public:
+    JsonParser(const char *data, size_t size) : _p(data), _end(data + size) {}
+
+    Json parseDocument() {
+        Json value = parseValue();
+        skipSpace();
+        if (_p != _end) fail("trailing characters");
+        return value;
+    }
+
+private:
+    const char *_p;
+    const char *_end;
+
+    [[noreturn]] void fail(const char *what) {
+        throw std::runtime_error(std::string("json: ") + what);
+    }
+
+    void skipSpace() {
+        while (_p != _end && (*_p == ' ' || *_p == '\t' || *_p == '\n' || *_p == '\r')) ++_p;
+    }
+
+    char peek() {
+        skipSpace();
+        if (_p == _end) fail("unexpected end of input");
+        return *_p;
+    }
+
+    void expect(char c) {
+        if (peek() != c) fail("unexpected character");
+        ++_p;
+    }
+
+    bool consume(const char *word) {
+        const char *q = _p;
+        for (; *word; ++word, ++q) {
+            if (q == _end || *q != *word) return false;
+        }
+        _p = q;
+        return true;
+    }
+
+    Json parseValue() {
+        Json v;
+        char c = peek();
+        if (c == '{') {
+            ++_p;
+            v._type = Json::Type::Object;
+            if (peek() == '}') {
+                ++_p;
+                return v;
+            }
+            while (true) {
+                if (peek() != '"') fail("expected object key");
+                std::string key = parseString();
+                expect(':');
+                v._object[key] = parseValue();
+                if (peek() == ',') {
+                    ++_p;
+                    continue;
+                }
+                expect('}');
+                return v;
+            }
+        }
+        if (c == '[') {
+            ++_p;
+            v._type = Json::Type::Array;
+            if (peek() == ']') {
+                ++_p;
+                return v;
+            }
+            while (true) {
+                v._array.push_back(parseValue());
+                if (peek() == ',') {
+                    ++_p;
+                    continue;
+                }
+                expect(']');
+                return v;
+            }
+        }
+        if (c == '"') {
+            v._type = Json::Type::String;
+            v._string = parseString();
+            return v;
+        }
+        if (consume("true")) {
+            v._type = Json::Type::Bool;
+            v._bool = true;
+            return v;
+        }
+        if (consume("false")) {
+            v._type = Json::Type::Bool;
+            return v;
+        }
+        if (consume("null")) return v;
+        if (consume("NaN")) {
+            v._type = Json::Type::Number;
+            v._number = NAN;
+            return v;
+        }
+        v._type = Json::Type::Number;
+        v._number = parseNumber();
+        return v;
+    }
+
+    double parseNumber() {
+        std::string buf;
+        while (_p != _end && (std::isdigit(static_cast<unsigned char>(*_p)) || *_p == '-' || *_p == '+' ||
+                              *_p == '.' || *_p == 'e' || *_p == 'E')) {
+            buf.push_back(*_p++);
+        }
+        if (buf.empty()) fail("invalid value");
+        char *stop = nullptr;
+        double d = std::strtod(buf.c_str(), &stop);
+        if (*stop != '\0') fail("invalid number");
+        return d;
+    }
+
+    static void appendUtf8(std::string &out, uint32_t cp) {
+        if (cp < 0x80) {
+            out.push_back(static_cast<char>(cp));
+        } else if (cp < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else if (cp < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+        }
+    }
+
+    uint32_t parseHex4() {
+        if (_end - _p < 4) fail("truncated \\u escape");
+        uint32_t cp = 0;
+        for (int i = 0; i < 4; ++i) {
+            char h = *_p++;
+            cp <<= 4;
+            if (h >= '0' && h <= '9') cp |= h - '0';
+            else if (h >= 'a' && h <= 'f') cp |= h - 'a' + 10;
+            else if (h >= 'A' && h <= 'F') cp |= h - 'A' + 10;
+            else fail("invalid \\u escape");
+        }
+        return cp;
+    }
+
+    std::string parseString() {
+        expect('"');
+        std::string out;
+        while (true) {
+            if (_p == _end) fail("unterminated string");
+            char c = *_p++;
+            if (c == '"') return out;
+            if (c != '\\') {
+                out.push_back(c);
+                continue;
+            }
+            if (_p == _end) fail("unterminated escape");
+            char e = *_p++;
+            switch (e) {
+            case '"': out.push_back('"'); break;
+            case '\\': out.push_back('\\'); break;
+            case '/': out.push_back('/'); break;
+            case 'b': out.push_back('\b'); break;
+            case 'f': out.push_back('\f'); break;
+            case 'n': out.push_back('\n'); break;
+            case 'r': out.push_back('\r'); break;
+            case 't': out.push_back('\t'); break;
+            case 'u': {
+                uint32_t cp = parseHex4();
+                if (cp >= 0xD800 && cp < 0xDC00 && consume("\\u")) {
+                    uint32_t lo = parseHex4();
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                }
+                appendUtf8(out, cp);
+                break;
+            }
+            default:
+                fail("invalid escape");
+            }
+        }
+    }
+};
+
+Json Json::parse(const char *data, size_t size) {
+    return JsonParser(data, size).parseDocument();
+}
+
+Json Json::parse(const std::string &text) {
+    return parse(text.data(), text.size());
+}
+
+bool Json::asBool() const {
+    if (_type != Type::Bool) throw std::runtime_error("json: not a bool");
+    return _bool;
+}
+
+double Json::asNumber() const {
+    if (_type != Type::Number) throw std::runtime_error("json: not a number");
+    return _number;
+}
+
+int64_t Json::asInt() const {
+    double d = asNumber();
+    if (std::floor(d) != d) throw std::runtime_error("json: not an integer");
+    return static_cast<int64_t>(d);
+}
+
+const std::string &Json::asString() const {
+    if (_type != Type::String) throw std::runtime_error("json: not a string");
+    return _string;
+}
+
+const std::vector<Json> &Json::asArray() const {
+    if (_type != Type::Array) throw std::runtime_error("json: not an array");
+    return _array;
+}
+
+const std::map<std::string, Json> &Json::asObject() const {
+    if (_type != Type::Object) throw std::runtime_error("json: not an object");
+    return _object;
+}
+
+const Json *Json::find(const std::string &key) const {
+    if (_type != Type::Object) return nullptr;
+    auto it = _object.find(key);
+    return it == _object.end() ? nullptr : &it->second;
+}
+
+double Json::number(const std::string &key, double fallback) const {
+    const Json *v = find(key);
+    return (v && v->isNumber()) ? v->_number : fallback;
+}
+
+std::string Json::string(const std::string &key, const std::string &fallback) const {
+    const Json *v = find(key);
+    return (v && v->isString()) ? v->_string : fallback;
+}
+} // namespace llaisys::loader
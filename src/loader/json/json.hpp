@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace llaisys::loader {
+// Minimal JSON value, enough for safetensors headers and HF config.json files.
+class Json {
+public:
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    // Throws std::runtime_error on malformed input.
+    static Json parse(const char *data, size_t size);
+    static Json parse(const std::string &text);
+
+    Type type() const { return _type; }
+    bool isNull() const { return _type == Type::Null; }
+    bool isNumber() const { return _type == Type::Number; }
+    bool isString() const { return _type == Type::String; }
+    bool isArray() const { return _type == Type::Array; }
+    bool isObject() const { return _type == Type::Object; }
+
+    bool asBool() const;
+    double asNumber() const;
+    int64_t asInt() const;
+    const std::string &asString() const;
+    const std::vector<Json> &asArray() const;
+    const std::map<std::string, Json> &asObject() const;
+
+    // Object lookup; returns nullptr when this is not an object or the key is missing.
+    const Json *find(const std::string &key) const;
+    // Convenience getters with a fallback for missing or null keys.
+    double number(const std::string &key, double fallback) const;
+    std::string string(const std::string &key, const std::string &fallback) const;
+
+private:
+    friend class JsonParser;
+    Type _type{Type::Null};
+    bool _bool{false};
+    double _number{0};
+    std::string _string;
+    std::vector<Json> _array;
+    std::map<std::string, Json> _object;
+};
+} // namespace llaisys::loader
@@ -0,0 +1,47 @@
+#include "numa_placement.hpp"
+
+#include "../../device/cpu/cpu_topology.hpp"
+#include "../../utils.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace llaisys::loader {
+size_t bind_threads_to_numa_nodes() {
+    const auto &nodes = device::cpu::numa_nodes();
+    if (nodes.size() < 2) return 1;
+    size_t spanned = 1;
+#ifdef _OPENMP
+#pragma omp parallel
+    {
+        const size_t t = static_cast<size_t>(omp_get_thread_num());
+        const size_t nt = static_cast<size_t>(omp_get_num_threads());
+        device::cpu::pin_current_thread(nodes[t * nodes.size() / nt].cpus);
+#pragma omp single
+        spanned = std::min(nodes.size(), nt);
+    }
+#endif
+    return spanned;
+}
+
+tensor_t numa_place_rows(const tensor_t &weight) {
+    ASSERT(weight->deviceType() == LLAISYS_DEVICE_CPU && weight->ndim() == 2 && weight->isContiguous(),
+           "NUMA placement: expects a contiguous 2-D host weight");
+    const size_t rows = weight->shape()[0];
+    const size_t stride = utils::row_bytes(weight->dtype(), weight->shape()[1]);
+    // malloc'ed pages are not backed until written, so the copy below decides their node
+    tensor_t placed = Tensor::create(weight->shape(), weight->dtype());
+    const std::byte *src = weight->data();
+    std::byte *dst = placed->data();
+    // Same iteration space and schedule as the kernels' row loop.
+#pragma omp parallel for schedule(static)
+    for (ptrdiff_t r = 0; r < static_cast<ptrdiff_t>(rows); ++r) {
+        std::memcpy(dst + r * stride, src + r * stride, stride);
+    }
+    return placed;
+}
+} // namespace llaisys::loader
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "../../tensor/tensor.hpp"
+
+#include <cstddef>
+
+namespace llaisys::loader {
+// The row-parallel CPU kernels split output rows over the OpenMP team with a static schedule,
+// so thread t always owns the same contiguous block of every weight. Pinning the team so that
+// consecutive threads share a node, and first-touching each block from its owner, puts every
+// weight row in the memory of the socket that streams it during decode.
+
+// Pins the OpenMP team: thread t goes to node t * nnode / nthread, on any core of that node.
+// Returns the number of nodes the team spans (1 when there is nothing to do).
+size_t bind_threads_to_numa_nodes();
+
+// Host copy of a 2-D contiguous weight whose rows are first-touched by the thread that owns
+// them in the kernels. Quantized dtypes are copied row by row as well.
+tensor_t numa_place_rows(const tensor_t &weight);
+} // namespace llaisys::loader
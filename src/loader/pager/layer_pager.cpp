@@ -0,0 +1,92 @@
+#include "layer_pager.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace llaisys::loader {
+namespace {
+size_t page_size() {
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return static_cast<size_t>(info.dwPageSize);
+#else
+    static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+#endif
+}
+
+// madvise works on whole pages. Prefetch rounds outwards; eviction rounds inwards so a page
+// shared with a neighbouring tensor of another layer is never dropped.
+void advise(std::byte *addr, size_t bytes, bool willneed) {
+    const uintptr_t page = page_size();
+    uintptr_t begin = reinterpret_cast<uintptr_t>(addr);
+    uintptr_t end = begin + bytes;
+    if (willneed) {
+        begin = begin / page * page;
+        end = (end + page - 1) / page * page;
+    } else {
+        begin = (begin + page - 1) / page * page;
+        end = end / page * page;
+    }
+    if (end <= begin) return;
+#if defined(_WIN32)
+    if (willneed) {
+        WIN32_MEMORY_RANGE_ENTRY range{reinterpret_cast<void *>(begin), static_cast<SIZE_T>(end - begin)};
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    } else {
+        // Unmapped file pages leave the working set under memory pressure on their own.
+        VirtualUnlock(reinterpret_cast<void *>(begin), static_cast<SIZE_T>(end - begin));
+    }
+#else
+    // Advice is best effort; a failure only costs speed.
+    (void)madvise(reinterpret_cast<void *>(begin), end - begin, willneed ? MADV_WILLNEED : MADV_DONTNEED);
+#endif
+}
+} // namespace
+
+LayerPager::LayerPager(const std::vector<std::vector<tensor_t>> &layers, size_t prefetch, bool evict)
+    : _ranges(layers.size()), _prefetch(prefetch), _evict(evict) {
+    for (size_t i = 0; i < layers.size(); ++i) {
+        for (const auto &t : layers[i]) {
+            if (!t) continue;
+            const auto &storage = t->storage();
+            // Weights are never written, so dropping private file-backed pages loses nothing.
+            if (!storage->isHost() || !storage->isExternal()) continue;
+            _ranges[i].emplace_back(storage->memory(), storage->size());
+            _paged_bytes += storage->size();
+        }
+    }
+    if (_evict) {
+        // Start from a cold model: only the first layers are brought in.
+        for (size_t i = 0; i < _ranges.size(); ++i) this->evict(i);
+    }
+    for (size_t i = 0; i < std::min(_prefetch, _ranges.size()); ++i) this->prefetch(i);
+}
+
+void LayerPager::enter(size_t layer) {
+    if (layer >= _ranges.size()) return;
+    // Wrap around so the first layers of the next forward pass are read during the last ones.
+    for (size_t d = 1; d <= _prefetch && d < _ranges.size(); ++d) {
+        prefetch((layer + d) % _ranges.size());
+    }
+    if (_evict && _ranges.size() > _prefetch + 1) {
+        evict((layer + _ranges.size() - 1) % _ranges.size());
+    }
+}
+
+void LayerPager::prefetch(size_t layer) {
+    for (const auto &[addr, bytes] : _ranges[layer]) advise(addr, bytes, true);
+}
+
+void LayerPager::evict(size_t layer) {
+    for (const auto &[addr, bytes] : _ranges[layer]) advise(addr, bytes, false);
+}
+} // namespace llaisys::loader
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "../../tensor/tensor.hpp"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace llaisys::loader {
+// Streams file-backed layer weights through memory. Before layer i runs, the pages of the
+// next `prefetch` layers are requested from the kernel (MADV_WILLNEED) so they are read while
+// layer i computes; with `evict` set, the pages of layer i-1 are dropped (MADV_DONTNEED) and
+// are simply read from the file again on the next forward pass.
+//
+// Only tensors whose storage is an external host mapping (mmapped safetensors or weight
+// cache) are paged; heap copies, e.g. converted or device weights, are left alone. With every
+// layer paged, a model larger than RAM runs at disk speed instead of failing.
+class LayerPager {
+public:
+    LayerPager(const std::vector<std::vector<tensor_t>> &layers, size_t prefetch, bool evict);
+
+    // Called right before `layer` runs.
+    void enter(size_t layer);
+
+    // Bytes of file-backed weights the pager manages.
+    size_t pagedBytes() const { return _paged_bytes; }
+
+private:
+    using Range = std::pair<std::byte *, size_t>;
+
+    void prefetch(size_t layer);
+    void evict(size_t layer);
+
+    std::vector<std::vector<Range>> _ranges;
+    size_t _prefetch;
+    bool _evict;
+    size_t _paged_bytes{0};
+};
+} // namespace llaisys::loader
@@ -0,0 +1,147 @@
+#include "safetensors.hpp"
+
+#include "../json/json.hpp"
+
+#include "../../utils.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace llaisys::loader {
+namespace {
+llaisysDataType_t parse_dtype(const std::string &name) {
+    if (name == "BF16") return LLAISYS_DTYPE_BF16;
+    if (name == "F16") return LLAISYS_DTYPE_F16;
+    if (name == "F32") return LLAISYS_DTYPE_F32;
+    if (name == "F64") return LLAISYS_DTYPE_F64;
+    if (name == "I8") return LLAISYS_DTYPE_I8;
+    if (name == "I16") return LLAISYS_DTYPE_I16;
+    if (name == "I32") return LLAISYS_DTYPE_I32;
+    if (name == "I64") return LLAISYS_DTYPE_I64;
+    if (name == "U8") return LLAISYS_DTYPE_U8;
+    if (name == "BOOL") return LLAISYS_DTYPE_BOOL;
+    throw std::runtime_error("safetensors: unsupported dtype " + name);
+}
+
+const Json &field(const Json &info, const char *key, const std::string &name) {
+    const Json *v = info.find(key);
+    if (!v) throw std::runtime_error(std::string("safetensors: missing ") + key + " for " + name);
+    return *v;
+}
+} // namespace
+
+#if defined(_WIN32)
+MappedFile::MappedFile(const std::string &path) : _path(path) {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("cannot open " + path);
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        throw std::runtime_error("cannot stat " + path);
+    }
+    _size = static_cast<size_t>(size.QuadPart);
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        throw std::runtime_error("cannot map " + path);
+    }
+    _data = static_cast<std::byte *>(MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0));
+    if (!_data) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        throw std::runtime_error("cannot map " + path);
+    }
+    _file = file;
+    _mapping = mapping;
+}
+
+MappedFile::~MappedFile() {
+    if (_data) UnmapViewOfFile(_data);
+    if (_mapping) CloseHandle(static_cast<HANDLE>(_mapping));
+    if (_file) CloseHandle(static_cast<HANDLE>(_file));
+}
+#else
+MappedFile::MappedFile(const std::string &path) : _path(path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("cannot open " + path);
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("cannot stat " + path);
+    }
+    _size = static_cast<size_t>(st.st_size);
+    // MAP_PRIVATE + PROT_WRITE: shared clean pages, private copies only if a weight is modified.
+    void *p = _size ? mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0) : nullptr;
+    ::close(fd);
+    if (p == MAP_FAILED) throw std::runtime_error("cannot map " + path);
+    _data = static_cast<std::byte *>(p);
+}
+
+MappedFile::~MappedFile() {
+    if (_data) munmap(_data, _size);
+}
+#endif
+
+std::shared_ptr<SafetensorsFile> SafetensorsFile::open(const std::string &path) {
+    auto st = std::make_shared<SafetensorsFile>();
+    st->_file = std::make_shared<MappedFile>(path);
+    const std::byte *base = st->_file->data();
+    const size_t file_size = st->_file->size();
+
+    uint64_t header_len = 0;
+    if (file_size < sizeof(header_len)) throw std::runtime_error("safetensors: truncated file " + path);
+    std::memcpy(&header_len, base, sizeof(header_len));
+    if (header_len > file_size - sizeof(header_len)) throw std::runtime_error("safetensors: bad header in " + path);
+    const size_t data_begin = sizeof(header_len) + header_len;
+
+    Json header = Json::parse(reinterpret_cast<const char *>(base) + sizeof(header_len), header_len);
+    for (const auto &[name, info] : header.asObject()) {
+        if (name == "__metadata__") {
+            for (const auto &[k, v] : info.asObject()) {
+                if (v.isString()) st->_metadata[k] = v.asString();
+            }
+            continue;
+        }
+        SafetensorsEntry e;
+        e.dtype = parse_dtype(field(info, "dtype", name).asString());
+        size_t numel = 1;
+        for (const auto &d : field(info, "shape", name).asArray()) {
+            e.shape.push_back(static_cast<size_t>(d.asInt()));
+            numel *= e.shape.back();
+        }
+        const auto &range = field(info, "data_offsets", name).asArray();
+        if (range.size() != 2) throw std::runtime_error("safetensors: bad data_offsets for " + name);
+        size_t begin = static_cast<size_t>(range[0].asInt());
+        size_t end = static_cast<size_t>(range[1].asInt());
+        if (end < begin || data_begin + end > file_size || end - begin != numel * utils::dsize(e.dtype)) {
+            throw std::runtime_error("safetensors: bad data range for " + name);
+        }
+        e.offset = data_begin + begin;
+        e.bytes = end - begin;
+        st->_entries.emplace(name, std::move(e));
+    }
+    return st;
+}
+
+const SafetensorsEntry *SafetensorsFile::find(const std::string &name) const {
+    auto it = _entries.find(name);
+    return it == _entries.end() ? nullptr : &it->second;
+}
+
+tensor_t SafetensorsFile::tensor(const std::string &name) const {
+    const SafetensorsEntry *e = find(name);
+    if (!e) throw std::runtime_error("safetensors: no tensor named " + name);
+    auto storage = core::context().runtime().wrapHostStorage(_file->data() + e->offset, e->bytes, _file);
+    return Tensor::create(e->shape, e->dtype, storage);
+}
+} // namespace llaisys::loader
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "../../tensor/tensor.hpp"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace llaisys::loader {
+// Copy-on-write mapping of a whole file: pages come from the shared page cache and are only
+// duplicated if someone writes to them.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string &path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    std::byte *data() const { return _data; }
+    size_t size() const { return _size; }
+    const std::string &path() const { return _path; }
+
+private:
+    std::string _path;
+    std::byte *_data{nullptr};
+    size_t _size{0};
+#if defined(_WIN32)
+    void *_file{nullptr};
+    void *_mapping{nullptr};
+#endif
+};
+
+struct SafetensorsEntry {
+    llaisysDataType_t dtype;
+    std::vector<size_t> shape;
+    size_t offset; // absolute byte offset in the file
+    size_t bytes;
+};
+
+// A mapped .safetensors file: 8-byte little-endian header length, JSON header, raw data.
+class SafetensorsFile {
+public:
+    // Throws std::runtime_error if the file cannot be mapped or the header is malformed.
+    static std::shared_ptr<SafetensorsFile> open(const std::string &path);
+
+    const std::map<std::string, SafetensorsEntry> &entries() const { return _entries; }
+    const std::map<std::string, std::string> &metadata() const { return _metadata; }
+    const SafetensorsEntry *find(const std::string &name) const;
+    const std::shared_ptr<MappedFile> &mapping() const { return _file; }
+
+    // CPU tensor whose storage points straight into the mapping; it keeps the mapping alive.
+    tensor_t tensor(const std::string &name) const;
+
+private:
+    std::shared_ptr<MappedFile> _file;
+    std::map<std::string, SafetensorsEntry> _entries;
+    std::map<std::string, std::string> _metadata;
+};
+} // namespace llaisys::loader
@@ -0,0 +1,161 @@
+#include "weight_cache.hpp"
+
+#include "../../utils.hpp"
+#include "../../utils/cpu_features.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace llaisys::loader {
+namespace {
+constexpr char kMagic[8] = {'L', 'L', 'A', 'I', 'S', 'Y', 'S', 'W'};
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t isa;
+    uint64_t stamp;
+    uint64_t meta_bytes;
+    uint64_t ntensor;
+    uint64_t table_bytes;
+    uint64_t reserved[2];
+};
+static_assert(sizeof(Header) == 64, "weight cache header must stay 64 bytes");
+
+size_t align_up(size_t v) {
+    return (v + WeightCache::kAlign - 1) / WeightCache::kAlign * WeightCache::kAlign;
+}
+
+size_t tensor_bytes(const Tensor &t) {
+    if (t.ndim() == 0) return utils::dsize(t.dtype());
+    size_t cols = t.shape().back();
+    return t.numel() / cols * utils::row_bytes(t.dtype(), cols);
+}
+
+template <typename T>
+void put(std::string &buf, T v) {
+    buf.append(reinterpret_cast<const char *>(&v), sizeof(T));
+}
+
+// Bounds-checked reader over the table region.
+struct Cursor {
+    const std::byte *p;
+    const std::byte *end;
+
+    template <typename T>
+    T get() {
+        if (static_cast<size_t>(end - p) < sizeof(T)) throw std::runtime_error("weight cache: truncated table");
+        T v;
+        std::memcpy(&v, p, sizeof(T));
+        p += sizeof(T);
+        return v;
+    }
+
+    std::string str(size_t n) {
+        if (static_cast<size_t>(end - p) < n) throw std::runtime_error("weight cache: truncated table");
+        std::string s(reinterpret_cast<const char *>(p), n);
+        p += n;
+        return s;
+    }
+};
+} // namespace
+
+std::shared_ptr<WeightCache> WeightCache::open(const std::string &path, uint64_t stamp) {
+    std::error_code ec;
+    if (!std::filesystem::is_regular_file(path, ec)) return nullptr;
+
+    auto cache = std::make_shared<WeightCache>();
+    try {
+        cache->_file = std::make_shared<MappedFile>(path);
+    } catch (const std::exception &) {
+        return nullptr;
+    }
+    const std::byte *base = cache->_file->data();
+    const size_t size = cache->_file->size();
+
+    Header h;
+    if (size < sizeof(h)) return nullptr;
+    std::memcpy(&h, base, sizeof(h));
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.version != kVersion ||
+        h.isa != utils::cpu_isa_tag() || h.stamp != stamp) {
+        return nullptr;
+    }
+    if (h.meta_bytes > size - sizeof(h) || h.table_bytes > size - sizeof(h) - h.meta_bytes) return nullptr;
+
+    try {
+        cache->_meta.assign(reinterpret_cast<const char *>(base + sizeof(h)), h.meta_bytes);
+        Cursor c{base + sizeof(h) + h.meta_bytes, base + sizeof(h) + h.meta_bytes + h.table_bytes};
+        for (uint64_t i = 0; i < h.ntensor; ++i) {
+            std::string name = c.str(c.get<uint32_t>());
+            auto dtype = static_cast<llaisysDataType_t>(c.get<uint32_t>());
+            std::vector<size_t> shape(c.get<uint32_t>());
+            for (auto &d : shape) d = static_cast<size_t>(c.get<uint64_t>());
+            uint64_t offset = c.get<uint64_t>();
+            uint64_t bytes = c.get<uint64_t>();
+            if (offset > size || bytes > size - offset) throw std::runtime_error("weight cache: blob out of range");
+            auto storage = core::context().runtime().wrapHostStorage(
+                cache->_file->data() + offset, static_cast<size_t>(bytes), cache->_file);
+            cache->_tensors.emplace_back(std::move(name), Tensor::create(shape, dtype, storage));
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "[WARN] ignoring weight cache " << path << ": " << e.what() << std::endl;
+        return nullptr;
+    }
+    return cache;
+}
+
+void WeightCache::write(const std::string &path, uint64_t stamp, const std::string &meta, const NamedTensors &tensors) {
+    // Lay out the table first so blob offsets are known.
+    std::string table;
+    size_t table_bytes = 0;
+    for (const auto &[name, t] : tensors) {
+        table_bytes += 3 * sizeof(uint32_t) + name.size() + (t->ndim() + 2) * sizeof(uint64_t);
+    }
+    size_t offset = align_up(sizeof(Header) + meta.size() + table_bytes);
+    std::vector<size_t> offsets;
+    for (const auto &[name, t] : tensors) {
+        ASSERT(t->deviceType() == LLAISYS_DEVICE_CPU && t->isContiguous(),
+               "weight cache: only contiguous host tensors can be written");
+        put<uint32_t>(table, static_cast<uint32_t>(name.size()));
+        table += name;
+        put<uint32_t>(table, static_cast<uint32_t>(t->dtype()));
+        put<uint32_t>(table, static_cast<uint32_t>(t->ndim()));
+        for (size_t d : t->shape()) put<uint64_t>(table, d);
+        put<uint64_t>(table, offset);
+        put<uint64_t>(table, tensor_bytes(*t));
+        offsets.push_back(offset);
+        offset = align_up(offset + tensor_bytes(*t));
+    }
+
+    Header h{};
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kVersion;
+    h.isa = utils::cpu_isa_tag();
+    h.stamp = stamp;
+    h.meta_bytes = meta.size();
+    h.ntensor = tensors.size();
+    h.table_bytes = table.size();
+
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out) throw std::runtime_error("cannot write weight cache " + tmp);
+        out.write(reinterpret_cast<const char *>(&h), sizeof(h));
+        out.write(meta.data(), meta.size());
+        out.write(table.data(), table.size());
+        size_t pos = sizeof(h) + meta.size() + table.size();
+        static const char zeros[kAlign] = {};
+        for (size_t i = 0; i < tensors.size(); ++i) {
+            out.write(zeros, offsets[i] - pos);
+            const Tensor &t = *tensors[i].second;
+            out.write(reinterpret_cast<const char *>(t.data()), tensor_bytes(t));
+            pos = offsets[i] + tensor_bytes(t);
+        }
+        if (!out) throw std::runtime_error("cannot write weight cache " + tmp);
+    }
+    std::filesystem::rename(tmp, path);
+}
+} // namespace llaisys::loader
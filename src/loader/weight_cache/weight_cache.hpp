@@ -0,0 +1,39 @@
+#pragma once
+
+#include "../safetensors/safetensors.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace llaisys::loader {
+using NamedTensors = std::vector<std::pair<std::string, tensor_t>>;
+
+// llaisys-native weight file: fixed header, opaque model meta, tensor table, then raw tensor
+// blobs each aligned to kAlign bytes. Tensors are stored exactly as the kernels consume them
+// (converted / quantized), so a warm start is a single mmap.
+//
+// A cache is only valid for the same format version, the same CPU ISA tag and the same
+// `stamp`, which callers derive from the source files and load options.
+class WeightCache {
+public:
+    static constexpr uint32_t kVersion = 1;
+    static constexpr size_t kAlign = 64;
+
+    // Returns nullptr if the file is missing, malformed or stale.
+    static std::shared_ptr<WeightCache> open(const std::string &path, uint64_t stamp);
+
+    // Writes host tensors to `path` (through a temporary file and a rename).
+    static void write(const std::string &path, uint64_t stamp, const std::string &meta, const NamedTensors &tensors);
+
+    const std::string &meta() const { return _meta; }
+    // CPU tensors pointing into the mapping; they keep it alive.
+    const NamedTensors &tensors() const { return _tensors; }
+    const std::shared_ptr<MappedFile> &mapping() const { return _file; }
+
+private:
+    std::shared_ptr<MappedFile> _file;
+    std::string _meta;
+    NamedTensors _tensors;
+};
+} // namespace llaisys::loader
@@ -2,11 +2,14 @@
 
 #include "llaisys/ops.h"
 
+#include "../../llaisys/llaisys_tensor.hpp"
+#include "../../loader/pager/layer_pager.hpp"
 #include "../../utils.hpp"
 
 #include <cmath>
 #include <cstdlib>
 #include <iostream>
+#include <memory>
 #include <vector>
 
 namespace llaisys::models {
@@ -41,10 +44,48 @@ void Qwen2::resetKVCache() {
     _decoder.resetKVCache();
 }
 
+bool Qwen2::truncateKVCache(size_t len) {
+    return _decoder.truncateKVCache(len);
+}
+
+size_t Qwen2::kvCacheLength() const {
+    return _decoder.kvCacheLength();
+}
+
 void Qwen2::setKVCacheEnabled(bool enabled) {
     _decoder.setKVCacheEnabled(enabled);
 }
 
+bool Qwen2::setKVCacheDtype(llaisysDataType_t dtype) {
+    return _decoder.setKVCacheDtype(dtype);
+}
+
+void Qwen2::setDecodePlanEnabled(bool enabled) {
+    _decoder.setDecodePlanEnabled(enabled);
+}
+
+size_t Qwen2::setWeightPaging(size_t prefetch, bool evict) {
+    if (prefetch == 0 && !evict) {
+        _decoder.setLayerPager(nullptr);
+        return 0;
+    }
+    llaisysTensor_t *const per_layer[] = {
+        _weights->attn_norm_w, _weights->attn_q_w, _weights->attn_q_b, _weights->attn_k_w,
+        _weights->attn_k_b, _weights->attn_v_w, _weights->attn_v_b, _weights->attn_o_w,
+        _weights->mlp_norm_w, _weights->mlp_gate_w, _weights->mlp_up_w, _weights->mlp_down_w,
+    };
+    std::vector<std::vector<tensor_t>> layers(_meta.nlayer);
+    for (size_t i = 0; i < _meta.nlayer; ++i) {
+        for (llaisysTensor_t *arr : per_layer) {
+            if (arr && arr[i]) layers[i].push_back(arr[i]->tensor);
+        }
+    }
+    auto pager = std::make_unique<loader::LayerPager>(layers, prefetch, evict);
+    size_t bytes = pager->pagedBytes();
+    _decoder.setLayerPager(std::move(pager));
+    return bytes;
+}
+
 //执行千问2模型推理
 static int64_t argmax_from_logits(llaisysTensor_t logits,
                                   llaisysDataType_t dtype,
@@ -106,4 +147,20 @@ int64_t Qwen2::step(const int64_t *token_ids, size_t ntoken) {
     tensorDestroy(logits);
     return next_token;
 }
+
+bool Qwen2::prefillOutputs(const int64_t *token_ids,
+                           size_t ntoken,
+                           llaisysTensor_t out_logits,
+                           llaisysTensor_t out_hidden) {
+    if (!token_ids || ntoken == 0) return false;
+    return _decoder.prefillOutputs(token_ids, ntoken, out_logits, out_hidden);
+}
+
+bool Qwen2::stepOutputs(const int64_t *token_ids,
+                        size_t ntoken,
+                        llaisysTensor_t out_logits,
+                        llaisysTensor_t out_hidden) {
+    if (!token_ids || ntoken == 0) return false;
+    return _decoder.decodeStepOutputs(token_ids, ntoken, out_logits, out_hidden);
+}
 } // namespace llaisys::models
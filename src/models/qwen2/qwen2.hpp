@@ -20,8 +20,20 @@ public:
     int64_t infer(const int64_t *token_ids, size_t ntoken);
     int64_t prefill(const int64_t *token_ids, size_t ntoken);
     int64_t step(const int64_t *token_ids, size_t ntoken);
+    // Per-position logits/hidden states into caller tensors, see Decoder::prefillOutputs.
+    bool prefillOutputs(const int64_t *token_ids, size_t ntoken, llaisysTensor_t out_logits, llaisysTensor_t out_hidden);
+    bool stepOutputs(const int64_t *token_ids, size_t ntoken, llaisysTensor_t out_logits, llaisysTensor_t out_hidden);
     void resetKVCache();
+    bool truncateKVCache(size_t len);
+    size_t kvCacheLength() const;
     void setKVCacheEnabled(bool enabled);
+    bool setKVCacheDtype(llaisysDataType_t dtype);
+    // Page file-backed layer weights: prefetch `prefetch` layers ahead and, with `evict`,
+    // drop each layer once it has run. prefetch == 0 && !evict turns paging off.
+    // Returns the number of paged bytes.
+    size_t setWeightPaging(size_t prefetch, bool evict);
+    // Replay single-token CPU decode steps from a captured plan, see transformer::DecodePlan.
+    void setDecodePlanEnabled(bool enabled);
 
 private:
     LlaisysQwen2Meta _meta{};
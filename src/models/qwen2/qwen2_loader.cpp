@@ -0,0 +1,350 @@
+#include "qwen2_loader.hpp"
+
+#include "../../device/cpu/cpu_memory.hpp"
+#include "../../llaisys/llaisys_tensor.hpp"
+#include "../../loader/json/json.hpp"
+#include "../../loader/numa/numa_placement.hpp"
+#include "../../ops/quantize/op.hpp"
+#include "../../utils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace llaisys::models {
+namespace {
+namespace fs = std::filesystem;
+
+std::vector<std::string> list_shards(const std::string &model_dir) {
+    std::vector<std::string> shards;
+    for (const auto &entry : fs::directory_iterator(model_dir)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".safetensors") {
+            shards.push_back(entry.path().string());
+        }
+    }
+    std::sort(shards.begin(), shards.end());
+    if (shards.empty()) throw std::runtime_error("no .safetensors files in " + model_dir);
+    return shards;
+}
+
+bool is_float(llaisysDataType_t dtype) {
+    return dtype == LLAISYS_DTYPE_F32 || dtype == LLAISYS_DTYPE_F16 || dtype == LLAISYS_DTYPE_BF16;
+}
+
+template <typename To, typename From>
+void convert(std::byte *dst, const std::byte *src, size_t n) {
+    const From *s = reinterpret_cast<const From *>(src);
+    To *d = reinterpret_cast<To *>(dst);
+    for (size_t i = 0; i < n; ++i) {
+        d[i] = utils::cast<To>(utils::cast<float>(s[i]));
+    }
+}
+
+template <typename To>
+void convert_from(std::byte *dst, const std::byte *src, llaisysDataType_t from, size_t n) {
+    switch (from) {
+    case LLAISYS_DTYPE_F32:
+        return convert<To, float>(dst, src, n);
+    case LLAISYS_DTYPE_F16:
+        return convert<To, fp16_t>(dst, src, n);
+    case LLAISYS_DTYPE_BF16:
+        return convert<To, bf16_t>(dst, src, n);
+    default:
+        EXCEPTION_UNSUPPORTED_DATATYPE(from);
+    }
+}
+
+// Converts `src` into the preallocated host tensor `dst` of the same shape.
+void convert_into(Tensor &dst, const Tensor &src) {
+    ASSERT(is_float(src.dtype()) && is_float(dst.dtype()), "Qwen2 loader: only float weights can be converted");
+    switch (dst.dtype()) {
+    case LLAISYS_DTYPE_F32:
+        return convert_from<float>(dst.data(), src.data(), src.dtype(), src.numel());
+    case LLAISYS_DTYPE_F16:
+        return convert_from<fp16_t>(dst.data(), src.data(), src.dtype(), src.numel());
+    case LLAISYS_DTYPE_BF16:
+        return convert_from<bf16_t>(dst.data(), src.data(), src.dtype(), src.numel());
+    default:
+        EXCEPTION_UNSUPPORTED_DATATYPE(dst.dtype());
+    }
+}
+
+llaisysTensor_t *weight_slot(LlaisysQwen2Weights &w, const std::string &name, size_t nlayer) {
+    if (name == "model.embed_tokens.weight") return &w.in_embed;
+    if (name == "lm_head.weight") return &w.out_embed;
+    if (name == "model.norm.weight") return &w.out_norm_w;
+
+    const std::string prefix = "model.layers.";
+    if (name.compare(0, prefix.size(), prefix) != 0) return nullptr;
+    size_t dot = name.find('.', prefix.size());
+    if (dot == std::string::npos) return nullptr;
+    size_t layer = std::stoul(name.substr(prefix.size(), dot - prefix.size()));
+    if (layer >= nlayer) return nullptr;
+    const std::string sub = name.substr(dot + 1);
+
+    if (sub == "input_layernorm.weight") return &w.attn_norm_w[layer];
+    if (sub == "self_attn.q_proj.weight") return &w.attn_q_w[layer];
+    if (sub == "self_attn.q_proj.bias") return &w.attn_q_b[layer];
+    if (sub == "self_attn.k_proj.weight") return &w.attn_k_w[layer];
+    if (sub == "self_attn.k_proj.bias") return &w.attn_k_b[layer];
+    if (sub == "self_attn.v_proj.weight") return &w.attn_v_w[layer];
+    if (sub == "self_attn.v_proj.bias") return &w.attn_v_b[layer];
+    if (sub == "self_attn.o_proj.weight") return &w.attn_o_w[layer];
+    if (sub == "post_attention_layernorm.weight") return &w.mlp_norm_w[layer];
+    if (sub == "mlp.gate_proj.weight") return &w.mlp_gate_w[layer];
+    if (sub == "mlp.up_proj.weight") return &w.mlp_up_w[layer];
+    if (sub == "mlp.down_proj.weight") return &w.mlp_down_w[layer];
+    return nullptr;
+}
+
+// Keeps checkpoint-only extras (e.g. rotary buffers) out of the loaded set and the cache.
+bool is_qwen2_weight(const std::string &name, size_t nlayer) {
+    LlaisysQwen2Weights probe{};
+    std::vector<llaisysTensor_t> layers(nlayer);
+    probe.attn_norm_w = probe.attn_q_w = probe.attn_q_b = probe.attn_k_w = probe.attn_k_b = probe.attn_v_w =
+        probe.attn_v_b = probe.attn_o_w = probe.mlp_norm_w = probe.mlp_gate_w = probe.mlp_up_w = probe.mlp_down_w =
+            layers.data();
+    return weight_slot(probe, name, nlayer) != nullptr;
+}
+
+bool is_linear_weight(const std::string &name) {
+    static const char *suffixes[] = {
+        "self_attn.q_proj.weight", "self_attn.k_proj.weight", "self_attn.v_proj.weight", "self_attn.o_proj.weight",
+        "mlp.gate_proj.weight", "mlp.up_proj.weight", "mlp.down_proj.weight",
+    };
+    for (const char *suffix : suffixes) {
+        size_t n = std::strlen(suffix);
+        if (name.size() > n && name.compare(name.size() - n, n, suffix) == 0) return true;
+    }
+    return false;
+}
+
+// FNV-1a over everything a cached checkpoint depends on.
+struct Stamp {
+    uint64_t h = 1469598103934665603ull;
+    void add(const void *data, size_t n) {
+        const auto *p = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < n; ++i) h = (h ^ p[i]) * 1099511628211ull;
+    }
+    void add(const std::string &s) { add(s.data(), s.size()); }
+    void addFile(const fs::path &path) {
+        add(path.filename().string());
+        uint64_t size = fs::file_size(path);
+        int64_t mtime = static_cast<int64_t>(fs::last_write_time(path).time_since_epoch().count());
+        add(&size, sizeof(size));
+        add(&mtime, sizeof(mtime));
+    }
+};
+
+uint64_t checkpoint_stamp(const std::string &model_dir, const std::vector<std::string> &shards,
+                          const Qwen2LoadOptions &options) {
+    Stamp st;
+    st.add("qwen2");
+    st.addFile(fs::path(model_dir) / "config.json");
+    for (const auto &shard : shards) st.addFile(shard);
+    uint32_t wdt = static_cast<uint32_t>(options.weight_dtype);
+    st.add(&wdt, sizeof(wdt));
+    return st.h;
+}
+
+// Row-split first-touch copies of the bandwidth-heavy matrices; see numa_placement.hpp.
+void place_on_numa_nodes(Qwen2Checkpoint &ckpt) {
+    if (loader::bind_threads_to_numa_nodes() < 2) return;
+    for (auto &[name, tensor] : ckpt.tensors) {
+        const bool head = name == "lm_head.weight" || (ckpt.meta.tie_embed && name == "model.embed_tokens.weight");
+        if (head || is_linear_weight(name)) tensor = loader::numa_place_rows(tensor);
+    }
+}
+
+void require(llaisysTensor_t *arr, size_t nlayer, const char *name) {
+    for (size_t i = 0; i < nlayer; ++i) {
+        if (!arr[i]) throw std::runtime_error("Qwen2 loader: missing " + std::string(name) + " of layer " + std::to_string(i));
+    }
+}
+} // namespace
+
+LlaisysQwen2Meta load_qwen2_meta(const std::string &model_dir) {
+    std::ifstream in(fs::path(model_dir) / "config.json", std::ios::binary);
+    if (!in) throw std::runtime_error("cannot open config.json in " + model_dir);
+    std::stringstream text;
+    text << in.rdbuf();
+    loader::Json cfg = loader::Json::parse(text.str());
+
+    LlaisysQwen2Meta meta{};
+    meta.nlayer = static_cast<size_t>(cfg.number("num_hidden_layers", 0));
+    meta.hs = static_cast<size_t>(cfg.number("hidden_size", 0));
+    meta.nh = static_cast<size_t>(cfg.number("num_attention_heads", 0));
+    meta.nkvh = static_cast<size_t>(cfg.number("num_key_value_heads", static_cast<double>(meta.nh)));
+    meta.di = static_cast<size_t>(cfg.number("intermediate_size", 0));
+    meta.maxseq = static_cast<size_t>(cfg.number("max_position_embeddings", 0));
+    meta.voc = static_cast<size_t>(cfg.number("vocab_size", 0));
+    meta.epsilon = static_cast<float>(cfg.number("rms_norm_eps", 1e-6));
+    meta.theta = static_cast<float>(cfg.number("rope_theta", 10000.0));
+    meta.dh = static_cast<size_t>(cfg.number("head_dim", meta.nh ? static_cast<double>(meta.hs / meta.nh) : 0));
+    meta.end_token = -1;
+    if (const loader::Json *eos = cfg.find("eos_token_id")) {
+        if (eos->isNumber()) meta.end_token = eos->asInt();
+        if (eos->isArray() && !eos->asArray().empty()) meta.end_token = eos->asArray()[0].asInt();
+    }
+
+    if (const loader::Json *tie = cfg.find("tie_word_embeddings")) {
+        meta.tie_embed = tie->type() == loader::Json::Type::Bool && tie->asBool() ? 1 : 0;
+    }
+
+    const std::string torch_dtype = cfg.string("torch_dtype", "");
+    if (torch_dtype == "bfloat16") {
+        meta.dtype = LLAISYS_DTYPE_BF16;
+    } else if (torch_dtype == "float16") {
+        meta.dtype = LLAISYS_DTYPE_F16;
+    } else if (torch_dtype == "float32") {
+        meta.dtype = LLAISYS_DTYPE_F32;
+    } else {
+        auto shard = loader::SafetensorsFile::open(list_shards(model_dir).front());
+        const loader::SafetensorsEntry *embed = shard->find("model.embed_tokens.weight");
+        meta.dtype = embed ? embed->dtype : LLAISYS_DTYPE_F32;
+    }
+    if (meta.nlayer == 0 || meta.hs == 0 || meta.nh == 0 || meta.voc == 0) {
+        throw std::runtime_error("incomplete Qwen2 config in " + model_dir);
+    }
+    return meta;
+}
+
+Qwen2Checkpoint load_qwen2_checkpoint(const std::string &model_dir, const Qwen2LoadOptions &options) {
+    device::cpu::AllocClassScope alloc_class(LLAISYS_ALLOC_WEIGHT);
+    const auto start = std::chrono::steady_clock::now();
+    auto elapsed = [&] { return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(); };
+    const std::vector<std::string> shards = list_shards(model_dir);
+    const bool quant = options.weight_dtype != LLAISYS_DTYPE_INVALID;
+    ASSERT(!quant || utils::is_quantized(options.weight_dtype), "Qwen2 loader: weight_dtype must be a quantized dtype");
+
+    uint64_t stamp = 0;
+    if (!options.cache_path.empty()) {
+        stamp = checkpoint_stamp(model_dir, shards, options);
+        if (auto cache = loader::WeightCache::open(options.cache_path, stamp)) {
+            Qwen2Checkpoint ckpt;
+            if (cache->meta().size() == sizeof(ckpt.meta)) {
+                std::memcpy(&ckpt.meta, cache->meta().data(), sizeof(ckpt.meta));
+                ckpt.tensors = cache->tensors();
+                ckpt.stats.bytes = cache->mapping()->size();
+                ckpt.stats.from_cache = 1;
+                if (options.numa) place_on_numa_nodes(ckpt);
+                ckpt.stats.seconds = elapsed();
+                return ckpt;
+            }
+        }
+    }
+
+    Qwen2Checkpoint ckpt;
+    ckpt.meta = load_qwen2_meta(model_dir);
+
+    // Mapping the shards is cheap; the bytes are read when a tensor is first touched. Tensors
+    // already in the model dtype are used in place; everything else becomes a job that reads
+    // its source and writes a converted or quantized copy. Destinations are allocated here,
+    // on the calling thread, so the workers only run kernels on raw memory.
+    struct Job {
+        tensor_t src;
+        tensor_t dst;
+    };
+    std::vector<Job> jobs;
+    for (const auto &path : shards) {
+        auto shard = loader::SafetensorsFile::open(path);
+        for (const auto &[name, entry] : shard->entries()) {
+            if (!is_qwen2_weight(name, ckpt.meta.nlayer)) continue;
+            // a tied head is served by the embedding matrix; never keep a second copy
+            if (ckpt.meta.tie_embed && name == "lm_head.weight") continue;
+            tensor_t src = shard->tensor(name);
+            ckpt.stats.bytes += entry.bytes;
+            llaisysDataType_t dtype = quant && is_linear_weight(name) ? options.weight_dtype : ckpt.meta.dtype;
+            if (src->dtype() == dtype) {
+                ckpt.tensors.emplace_back(name, src);
+                continue;
+            }
+            ckpt.tensors.emplace_back(name, Tensor::create(src->shape(), dtype));
+            jobs.push_back({src, ckpt.tensors.back().second});
+        }
+        // `shard` goes out of scope here; the mapping lives on through the tensor storages.
+    }
+
+    // One tensor per task: page faults on one shard overlap with conversion of another.
+    // Kernels called from here run single-threaded (no nested parallelism).
+    std::exception_ptr error;
+#pragma omp parallel for schedule(dynamic, 1)
+    for (ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(jobs.size()); ++i) {
+        try {
+            const Job &job = jobs[i];
+            if (utils::is_quantized(job.dst->dtype())) {
+                ops::quantize(job.dst, job.src);
+            } else {
+                convert_into(*job.dst, *job.src);
+            }
+        } catch (...) {
+#pragma omp critical(qwen2_loader_error)
+            if (!error) error = std::current_exception();
+        }
+    }
+    if (error) std::rethrow_exception(error);
+    const bool has_head = std::any_of(ckpt.tensors.begin(), ckpt.tensors.end(),
+                                      [](const auto &t) { return t.first == "lm_head.weight"; });
+    if (!has_head) ckpt.meta.tie_embed = 1;
+
+    if (!options.cache_path.empty()) {
+        try {
+            std::string meta(reinterpret_cast<const char *>(&ckpt.meta), sizeof(ckpt.meta));
+            loader::WeightCache::write(options.cache_path, stamp, meta, ckpt.tensors);
+            // Serve the weights from the fresh file, so converted copies go back to the heap and
+            // the weights can be paged like any mmapped checkpoint.
+            if (auto cache = loader::WeightCache::open(options.cache_path, stamp)) ckpt.tensors = cache->tensors();
+        } catch (const std::exception &e) {
+            // The cache is an optimization; a read-only model directory must still load.
+            std::cerr << "[WARN] Qwen2 loader: " << e.what() << std::endl;
+        }
+    }
+    if (options.numa) place_on_numa_nodes(ckpt);
+    ckpt.stats.seconds = elapsed();
+    return ckpt;
+}
+
+void assign_qwen2_weights(LlaisysQwen2Weights &weights,
+                          const LlaisysQwen2Meta &meta,
+                          const loader::NamedTensors &tensors,
+                          llaisysDeviceType_t device,
+                          int device_id) {
+    for (const auto &[name, tensor] : tensors) {
+        llaisysTensor_t *slot = weight_slot(weights, name, meta.nlayer);
+        if (!slot) continue;
+        tensor_t t = tensor;
+        if (device != LLAISYS_DEVICE_CPU) {
+            tensor_t dev = Tensor::create(t->shape(), t->dtype(), device, device_id);
+            dev->load(t->data());
+            t = dev;
+        }
+        if (*slot) tensorDestroy(*slot);
+        *slot = new LlaisysTensor{t};
+    }
+
+    if (!weights.in_embed) throw std::runtime_error("Qwen2 loader: missing model.embed_tokens.weight");
+    if (!weights.out_norm_w) throw std::runtime_error("Qwen2 loader: missing model.norm.weight");
+    if (meta.tie_embed) {
+        // the same handle in both slots; llaisysQwen2ModelDestroy releases it once
+        if (weights.out_embed && weights.out_embed != weights.in_embed) tensorDestroy(weights.out_embed);
+        weights.out_embed = weights.in_embed;
+    }
+    if (!weights.out_embed) throw std::runtime_error("Qwen2 loader: missing lm_head.weight");
+    require(weights.attn_norm_w, meta.nlayer, "input_layernorm.weight");
+    require(weights.attn_q_w, meta.nlayer, "self_attn.q_proj.weight");
+    require(weights.attn_k_w, meta.nlayer, "self_attn.k_proj.weight");
+    require(weights.attn_v_w, meta.nlayer, "self_attn.v_proj.weight");
+    require(weights.attn_o_w, meta.nlayer, "self_attn.o_proj.weight");
+    require(weights.mlp_norm_w, meta.nlayer, "post_attention_layernorm.weight");
+    require(weights.mlp_gate_w, meta.nlayer, "mlp.gate_proj.weight");
+    require(weights.mlp_up_w, meta.nlayer, "mlp.up_proj.weight");
+    require(weights.mlp_down_w, meta.nlayer, "mlp.down_proj.weight");
+}
+} // namespace llaisys::models
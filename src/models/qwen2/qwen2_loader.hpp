@@ -0,0 +1,44 @@
+#pragma once
+
+#include "llaisys/models/qwen2.h"
+
+#include "../../loader/weight_cache/weight_cache.hpp"
+
+#include <string>
+
+namespace llaisys::models {
+struct Qwen2LoadOptions {
+    // Quantize the linear projections into this dtype; LLAISYS_DTYPE_INVALID keeps the model dtype.
+    llaisysDataType_t weight_dtype = LLAISYS_DTYPE_INVALID;
+    // Weight cache file; empty disables it. A stale or missing cache is rebuilt.
+    std::string cache_path;
+    // On multi-socket hosts: pin the OpenMP team across NUMA nodes and first-touch every row of
+    // the linear weights (and the LM head) from the thread that computes it.
+    bool numa = false;
+};
+
+// Weights named as in the HF checkpoint, as host tensors ready for the kernels.
+struct Qwen2Checkpoint {
+    LlaisysQwen2Meta meta{};
+    loader::NamedTensors tensors;
+    LlaisysQwen2LoadStats stats{};
+};
+
+// Reads `config.json` in a HF-style model directory. The dtype comes from `torch_dtype` or,
+// when absent, from the embedding tensor of the first shard.
+LlaisysQwen2Meta load_qwen2_meta(const std::string &model_dir);
+
+// Loads every `*.safetensors` shard in `model_dir` (or a valid weight cache).
+// Tensors already in meta.dtype point into the file mappings (no copy); other float dtypes
+// are converted and linear weights quantized, tensors in parallel on the OpenMP pool.
+// Throws std::runtime_error on malformed input.
+Qwen2Checkpoint load_qwen2_checkpoint(const std::string &model_dir, const Qwen2LoadOptions &options);
+
+// Hands the checkpoint tensors to `weights`, copying them if `device` is not the CPU.
+// Throws std::runtime_error on missing weights.
+void assign_qwen2_weights(LlaisysQwen2Weights &weights,
+                          const LlaisysQwen2Meta &meta,
+                          const loader::NamedTensors &tensors,
+                          llaisysDeviceType_t device,
+                          int device_id);
+} // namespace llaisys::models
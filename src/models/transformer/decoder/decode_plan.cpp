@@ -0,0 +1,286 @@
+#include "decode_plan.hpp"
+
+#include "../../../core/profiler/profiler.hpp"
+#include "../../../llaisys/llaisys_tensor.hpp"
+#include "../../../ops/embedding/cpu/embedding_cpu.hpp"
+#include "../../../ops/linear/cpu/linear_cpu.hpp"
+#include "../../../ops/quantize/cpu/quantize_cpu.hpp"
+#include "../../../ops/rms_norm/cpu/rms_norm_cpu.hpp"
+#include "../../../ops/rope/cpu/rope_cpu.hpp"
+#include "../../../ops/self_attention/cpu/self_attention_cpu.hpp"
+#include "../../../ops/swiglu/cpu/swiglu_cpu.hpp"
+#include "../../../utils.hpp"
+
+#include <cmath>
+#include <cstring>
+
+namespace llaisys::models::transformer {
+namespace {
+using core::profiler::OpCost;
+
+// The plan bypasses the C op entry points, so each step reports itself to the profiler
+// under the name of the op it stands for. The kernel call is inlined into the returned
+// lambda, so a step stays a single std::function call when profiling is off.
+template <typename Fn>
+auto profiled(const char *name, OpCost cost, Fn step) {
+    return [name, cost, step = std::move(step)] {
+        core::profiler::Scope scope(name, [&] { return cost; });
+        step();
+    };
+}
+
+OpCost linear_cost(const Tensor &w, llaisysDataType_t dtype, bool bias) {
+    const size_t n = w.shape()[0];
+    const size_t k = w.shape()[1];
+    const size_t es = utils::dsize(dtype);
+    return {n * utils::row_bytes(w.dtype(), k) + (k + n + (bias ? n : 0)) * es, 2ull * n * k};
+}
+// The tensor behind `t` if the plan can address it directly: contiguous host memory of exactly
+// `shape` and `dtype`. `quant_ok` also accepts a quantized dtype (linear weights). The kernels
+// are handed raw pointers with sizes taken from the config, so anything else must fall back to
+// the op path, which checks it.
+Tensor *usable(llaisysTensor_t t, const TensorShape &shape, llaisysDataType_t dtype, bool quant_ok = false) {
+    if (!t || !t->tensor) return nullptr;
+    Tensor *x = t->tensor.get();
+    if (x->deviceType() != LLAISYS_DEVICE_CPU || !x->isContiguous()) return nullptr;
+    if (x->shape() != shape) return nullptr;
+    if (x->dtype() != dtype && !(quant_ok && utils::is_quantized(x->dtype()))) return nullptr;
+    return x;
+}
+
+// Optional per-layer bias: `ok` is cleared if one is present but not usable, so the projection
+// is never silently run without it.
+Tensor *usable_bias(llaisysTensor_t *table, size_t layer, size_t n, llaisysDataType_t dtype, bool &ok) {
+    if (!table || !table[layer]) return nullptr;
+    Tensor *b = usable(table[layer], {n}, dtype);
+    if (!b) ok = false;
+    return b;
+}
+
+// y[1, n] = x[1, k] W^T (+ b), picking the kernel the linear op would pick for this weight.
+std::function<void()> linear_step(std::byte *y, const std::byte *x, const Tensor &w, const Tensor *b,
+                                  llaisysDataType_t dtype) {
+    const size_t n = w.shape()[0];
+    const size_t k = w.shape()[1];
+    const std::byte *wp = w.data();
+    const std::byte *bp = b ? b->data() : nullptr;
+    const llaisysDataType_t wtype = w.dtype();
+    const OpCost cost = linear_cost(w, dtype, b != nullptr);
+    if (utils::is_quantized(wtype)) {
+        return profiled("linear", cost, [=] { ops::cpu::linear_quant(y, x, wp, bp, dtype, wtype, 1, n, k, n, k); });
+    }
+    return profiled("linear", cost, [=] { ops::cpu::linear(y, x, wp, bp, dtype, 1, n, k, n, k); });
+}
+
+// h[1, n] += x[1, k] W^T with the residual add fused into the GEMM epilogue.
+std::function<void()> residual_step(std::byte *h, const std::byte *x, const Tensor &w, llaisysDataType_t dtype) {
+    const size_t n = w.shape()[0];
+    const size_t k = w.shape()[1];
+    const std::byte *wp = w.data();
+    const llaisysDataType_t wtype = w.dtype();
+    OpCost cost = linear_cost(w, dtype, false);
+    cost.bytes += n * utils::dsize(dtype);
+    cost.flops += n;
+    if (utils::is_quantized(wtype)) {
+        return profiled("linear_add", cost,
+                        [=] { ops::cpu::linear_quant_add(h, x, wp, nullptr, h, dtype, wtype, 1, n, k, n, k, n); });
+    }
+    return profiled("linear_add", cost, [=] { ops::cpu::linear_add(h, x, wp, nullptr, h, dtype, 1, n, k, n, k, n); });
+}
+// Calls `fn` on every entry of the table in a fixed order; a missing bias array counts as
+// `nlayer` null entries.
+template <typename Fn>
+void for_each_weight(const LlaisysQwen2Weights &w, size_t nlayer, Fn &&fn) {
+    fn(w.in_embed);
+    fn(w.out_embed);
+    fn(w.out_norm_w);
+    llaisysTensor_t *const tables[] = {w.attn_norm_w, w.attn_q_w, w.attn_q_b, w.attn_k_w, w.attn_k_b,
+                                       w.attn_v_w, w.attn_v_b, w.attn_o_w, w.mlp_norm_w, w.mlp_gate_w,
+                                       w.mlp_up_w, w.mlp_down_w};
+    for (llaisysTensor_t *table : tables) {
+        for (size_t l = 0; l < nlayer; ++l) fn(table ? table[l] : nullptr);
+    }
+}
+} // namespace
+
+WeightSnapshot::WeightSnapshot(const LlaisysQwen2Weights &weights, size_t nlayer) {
+    for_each_weight(weights, nlayer, [this](llaisysTensor_t t) {
+        _entries.emplace_back(t, t ? t->tensor : nullptr);
+    });
+}
+
+bool WeightSnapshot::matches(const LlaisysQwen2Weights &weights, size_t nlayer) const {
+    size_t i = 0;
+    bool same = true;
+    for_each_weight(weights, nlayer, [&](llaisysTensor_t t) {
+        if (!same) return;
+        const auto &[handle, tensor] = _entries[i++];
+        same = t == handle && (!t || t->tensor == tensor);
+    });
+    return same;
+}
+
+std::unique_ptr<DecodePlan> DecodePlan::capture(const DecoderConfig &config,
+                                                const LlaisysQwen2Weights &weights,
+                                                const std::vector<llaisysTensor_t> &k_cache,
+                                                const std::vector<llaisysTensor_t> &v_cache) {
+    const size_t nlayer = config.nlayer;
+    if (k_cache.size() != nlayer || v_cache.size() != nlayer) return nullptr;
+    const llaisysDataType_t dt = config.dtype;
+    const size_t hs = config.hs, nh = config.nh, nkvh = config.nkvh, dh = config.dh, di = config.di;
+    Tensor *in_embed = usable(weights.in_embed, {config.voc, hs}, dt);
+    Tensor *out_embed = usable(weights.out_embed, {config.voc, hs}, dt, true);
+    Tensor *out_norm = usable(weights.out_norm_w, {hs}, dt);
+    if (!in_embed || !out_embed || !out_norm) return nullptr;
+
+    auto plan = std::unique_ptr<DecodePlan>(new DecodePlan());
+    DecodePlan &p = *plan;
+
+    auto buffer = [&p, dt](std::vector<size_t> shape, llaisysDataType_t dtype = LLAISYS_DTYPE_INVALID) {
+        p._buffers.push_back(Tensor::create(shape, dtype == LLAISYS_DTYPE_INVALID ? dt : dtype));
+        return p._buffers.back()->data();
+    };
+    std::byte *hidden = buffer({1, hs});
+    std::byte *norm = buffer({1, hs});
+    std::byte *q = buffer({1, nh * dh});
+    std::byte *k = buffer({1, nkvh * dh});
+    std::byte *v = buffer({1, nkvh * dh});
+    std::byte *q_rope = buffer({1, nh * dh});
+    std::byte *k_rope = buffer({1, nkvh * dh});
+    std::byte *attn = buffer({1, nh * dh});
+    std::byte *gate = buffer({1, di});
+    std::byte *up = buffer({1, di});
+    std::byte *act = buffer({1, di});
+    std::byte *head_norm = buffer({1, hs});
+
+    // the kernels read token and position through these host scalars
+    const std::byte *token = reinterpret_cast<const std::byte *>(&p._token);
+    const std::byte *pos = reinterpret_cast<const std::byte *>(&p._pos);
+
+    const std::byte *embed_w = in_embed->data();
+    const size_t voc = in_embed->shape()[0];
+    const size_t es = utils::dsize(dt);
+    p._embed.push_back(profiled("embedding", {2 * hs * es, 0},
+                                [=] { ops::cpu::embedding(hidden, token, embed_w, dt, 1, hs, voc); }));
+    const OpCost norm_cost{3 * hs * es, 4ull * hs};
+
+    const float eps = config.epsilon;
+    const float theta = config.theta;
+    const float scale = 1.0f / std::sqrt(static_cast<float>(dh));
+    const ops::HeadStrides q_heads = ops::dense_head_strides(nh, dh);
+    const ops::HeadStrides kv_heads = ops::dense_head_strides(nkvh, dh);
+    p._layers.resize(nlayer);
+    for (size_t l = 0; l < nlayer; ++l) {
+        Tensor *attn_norm = usable(weights.attn_norm_w[l], {hs}, dt);
+        Tensor *wq = usable(weights.attn_q_w[l], {nh * dh, hs}, dt, true);
+        Tensor *wk = usable(weights.attn_k_w[l], {nkvh * dh, hs}, dt, true);
+        Tensor *wv = usable(weights.attn_v_w[l], {nkvh * dh, hs}, dt, true);
+        Tensor *wo = usable(weights.attn_o_w[l], {hs, nh * dh}, dt, true);
+        Tensor *mlp_norm = usable(weights.mlp_norm_w[l], {hs}, dt);
+        Tensor *wg = usable(weights.mlp_gate_w[l], {di, hs}, dt, true);
+        Tensor *wu = usable(weights.mlp_up_w[l], {di, hs}, dt, true);
+        Tensor *wd = usable(weights.mlp_down_w[l], {hs, di}, dt, true);
+        const TensorShape kv_shape{config.maxseq, nkvh, dh};
+        const llaisysDataType_t kv_dtype = k_cache[l] && k_cache[l]->tensor ? k_cache[l]->tensor->dtype() : dt;
+        if (kv_dtype != dt && kv_dtype != LLAISYS_DTYPE_Q8) return nullptr;
+        Tensor *kc = usable(k_cache[l], kv_shape, kv_dtype);
+        Tensor *vc = usable(v_cache[l], kv_shape, kv_dtype);
+        if (!attn_norm || !wq || !wk || !wv || !wo || !mlp_norm || !wg || !wu || !wd || !kc || !vc) return nullptr;
+        bool biases_ok = true;
+        Tensor *bq = usable_bias(weights.attn_q_b, l, nh * dh, dt, biases_ok);
+        Tensor *bk = usable_bias(weights.attn_k_b, l, nkvh * dh, dt, biases_ok);
+        Tensor *bv = usable_bias(weights.attn_v_b, l, nkvh * dh, dt, biases_ok);
+        if (!biases_ok) return nullptr;
+
+        auto &steps = p._layers[l];
+        const std::byte *attn_norm_w = attn_norm->data();
+        steps.push_back(profiled("rms_norm", norm_cost,
+                                 [=] { ops::cpu::rms_norm(norm, hidden, attn_norm_w, dt, 1, hs, eps, hs, hs); }));
+        steps.push_back(linear_step(q, norm, *wq, bq, dt));
+        steps.push_back(linear_step(k, norm, *wk, bk, dt));
+        steps.push_back(linear_step(v, norm, *wv, bv, dt));
+        steps.push_back(profiled("rope", {2 * nh * dh * es, 3ull * nh * dh},
+                                 [=] { ops::cpu::rope(q_rope, q, pos, dt, 1, nh, dh, theta, q_heads, q_heads); }));
+        steps.push_back(profiled("rope", {2 * nkvh * dh * es, 3ull * nkvh * dh},
+                                 [=] { ops::cpu::rope(k_rope, k, pos, dt, 1, nkvh, dh, theta, kv_heads, kv_heads); }));
+
+        // append K/V at `pos`, then attend over [0, pos]
+        const llaisysDataType_t kvt = kc->dtype();
+        const size_t slot = nkvh * utils::row_bytes(kvt, dh);
+        std::byte *kbase = kc->data();
+        std::byte *vbase = vc->data();
+        const int64_t *cur = &p._pos;
+        // q, attn and the [0, pos] K/V slots; QK^T and PV per query head
+        auto attn_cost = [=] {
+            const auto kvlen = static_cast<uint64_t>(*cur + 1);
+            return OpCost{2 * nh * dh * es + 2 * kvlen * slot, 4 * kvlen * nh * dh};
+        };
+        if (utils::is_quantized(kvt)) {
+            steps.push_back(profiled("quantize", {2 * (nkvh * dh * es + slot), 4ull * nkvh * dh}, [=] {
+                ops::cpu::quantize(kbase + *cur * slot, k_rope, kvt, dt, nkvh, dh);
+                ops::cpu::quantize(vbase + *cur * slot, v, kvt, dt, nkvh, dh);
+            }));
+            steps.push_back([=] {
+                core::profiler::Scope scope("self_attention", attn_cost);
+                ops::cpu::self_attention_quant(attn, q_rope, kbase, vbase, dt, kvt, 1, *cur + 1, nh, nkvh, dh, dh, scale);
+            });
+        } else {
+            steps.push_back(profiled("kv_cache.write", {4 * slot, 0}, [=] {
+                std::memcpy(kbase + *cur * slot, k_rope, slot);
+                std::memcpy(vbase + *cur * slot, v, slot);
+            }));
+            steps.push_back([=] {
+                core::profiler::Scope scope("self_attention", attn_cost);
+                ops::cpu::self_attention(attn, q_rope, kbase, vbase, dt, 1, *cur + 1, nh, nkvh, dh, dh, scale, q_heads,
+                                         q_heads, kv_heads, kv_heads);
+            });
+        }
+        steps.push_back(residual_step(hidden, attn, *wo, dt));
+
+        const std::byte *mlp_norm_w = mlp_norm->data();
+        steps.push_back(profiled("rms_norm", norm_cost,
+                                 [=] { ops::cpu::rms_norm(norm, hidden, mlp_norm_w, dt, 1, hs, eps, hs, hs); }));
+        steps.push_back(linear_step(gate, norm, *wg, nullptr, dt));
+        steps.push_back(linear_step(up, norm, *wu, nullptr, dt));
+        steps.push_back(profiled("swiglu", {3 * di * es, 4ull * di}, [=] { ops::cpu::swiglu(act, gate, up, dt, di); }));
+        steps.push_back(residual_step(hidden, act, *wd, dt));
+    }
+
+    // head: output norm into the caller's buffer if given, logits only if requested
+    const std::byte *out_norm_w = out_norm->data();
+    const std::byte *head_w = out_embed->data();
+    const llaisysDataType_t head_wtype = out_embed->dtype();
+    const size_t nvoc = out_embed->shape()[0];
+    const OpCost head_cost = linear_cost(*out_embed, dt, false);
+    DecodePlan *self = plan.get();
+    p._head.push_back([=] {
+        std::byte *normed = self->_out_hidden ? self->_out_hidden : head_norm;
+        {
+            core::profiler::Scope scope("rms_norm", [&] { return norm_cost; });
+            ops::cpu::rms_norm(normed, hidden, out_norm_w, dt, 1, hs, eps, hs, hs);
+        }
+        if (!self->_out_logits) return;
+        core::profiler::Scope scope("linear", [&] { return head_cost; });
+        if (utils::is_quantized(head_wtype)) {
+            ops::cpu::linear_quant(self->_out_logits, normed, head_w, nullptr, dt, head_wtype, 1, nvoc, hs, nvoc, hs);
+        } else {
+            ops::cpu::linear(self->_out_logits, normed, head_w, nullptr, dt, 1, nvoc, hs, nvoc, hs);
+        }
+    });
+    return plan;
+}
+
+void DecodePlan::run(int64_t token, size_t pos, std::byte *out_logits, std::byte *out_hidden,
+                     const std::function<void(size_t)> &enter_layer) {
+    _token = token;
+    _pos = static_cast<int64_t>(pos);
+    _out_logits = out_logits;
+    _out_hidden = out_hidden;
+    for (const auto &step : _embed) step();
+    for (size_t l = 0; l < _layers.size(); ++l) {
+        if (enter_layer) enter_layer(l);
+        for (const auto &step : _layers[l]) step();
+    }
+    for (const auto &step : _head) step();
+}
+} // namespace llaisys::models::transformer
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "decoder.hpp"
+
+#include "../../../tensor/tensor.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace llaisys::models::transformer {
+// A single-token decode step captured once and replayed. Capture resolves every weight and
+// KV-cache pointer and allocates fixed [1, *] work buffers; a replay is a flat list of CPU
+// kernel calls with only the position (RoPE angle, cache slot, attention length) varying.
+// Nothing is checked, allocated or dispatched through the tensor API per step.
+//
+// The plan borrows the weights and the KV cache: the owner must drop it whenever either is
+// replaced (cache released or re-typed, weight table edited; see WeightSnapshot).
+class DecodePlan {
+public:
+    // Returns nullptr if the step cannot be captured: non-CPU device, a missing or
+    // non-contiguous weight or cache, or one whose shape or dtype does not match `config`.
+    static std::unique_ptr<DecodePlan> capture(const DecoderConfig &config,
+                                               const LlaisysQwen2Weights &weights,
+                                               const std::vector<llaisysTensor_t> &k_cache,
+                                               const std::vector<llaisysTensor_t> &v_cache);
+
+    // Runs `token` at position `pos` (< maxseq) and appends its K/V to the cache.
+    // `out_hidden` ([1, hs], may be null) receives the final normed hidden state and
+    // `out_logits` ([1, voc], may be null) the logits.
+    void run(int64_t token, size_t pos, std::byte *out_logits, std::byte *out_hidden, const std::function<void(size_t)> &enter_layer);
+
+private:
+    using Step = std::function<void()>;
+
+    // per-replay parameters read by the steps
+    int64_t _token{0};
+    int64_t _pos{0};
+    std::byte *_out_logits{nullptr};
+    std::byte *_out_hidden{nullptr};
+
+    std::vector<tensor_t> _buffers;
+    std::vector<Step> _embed;
+    std::vector<std::vector<Step>> _layers;
+    std::vector<Step> _head;
+};
+
+// Identity of every entry of a weight table: the handle and the tensor behind it. Taken when a
+// plan is captured, it tells whether the table has been edited since, and the references it
+// holds keep the captured storage alive until the plan is dropped.
+class WeightSnapshot {
+public:
+    WeightSnapshot(const LlaisysQwen2Weights &weights, size_t nlayer);
+
+    bool matches(const LlaisysQwen2Weights &weights, size_t nlayer) const;
+
+private:
+    std::vector<std::pair<llaisysTensor_t, tensor_t>> _entries;
+};
+} // namespace llaisys::models::transformer
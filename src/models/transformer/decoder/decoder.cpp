@@ -1,10 +1,17 @@
 #include "decoder.hpp"
+#include "decode_plan.hpp"
 
 #include "llaisys/ops.h"
 
+#include "../../../core/profiler/profiler.hpp"
+#include "../../../device/cpu/cpu_memory.hpp"
+#include "../../../loader/pager/layer_pager.hpp"
+
 #include <cmath>
 #include <cstdlib>
+#include <functional>
 #include <iostream>
+#include <utility>
 
 namespace llaisys::models::transformer {
 namespace {
@@ -28,9 +35,12 @@ bool trace_enabled() {
     return enabled;
 }
 
+// Stage markers: an instant event in the profiler trace, and a line on stderr under
+// LLAISYS_QWEN2_TRACE. No flush: this runs on the per-layer path.
 void trace(const char *stage) {
+    core::profiler::mark(stage);
     if (trace_enabled()) {
-        std::cerr << "[TRACE] Decoder forward: " << stage << std::endl;
+        std::cerr << "[TRACE] Decoder forward: " << stage << '\n';
     }
 }
 
@@ -51,6 +61,20 @@ bool ensure_data(llaisysTensor_t t, const char *stage) {
     }
     return true;
 }
+
+bool check_shape(llaisysTensor_t t, size_t rows, size_t cols, const char *stage) {
+    size_t shape[2] = {0, 0};
+    if (tensorGetNdim(t) == 2) tensorGetShape(t, shape);
+    if (shape[0] == rows && shape[1] == cols) return true;
+    std::cerr << "[ERROR] Decoder: " << stage << " must be [" << rows << ", " << cols << "]" << std::endl;
+    return false;
+}
+
+// The decode plan writes outputs through raw host pointers.
+bool plan_output(llaisysTensor_t t, llaisysDataType_t dtype) {
+    return !t || (tensorGetDeviceType(t) == LLAISYS_DEVICE_CPU && tensorGetDataType(t) == dtype &&
+                  tensorIsContiguous(t));
+}
 } // namespace
 
 Decoder::Decoder(const DecoderConfig &config,
@@ -60,7 +84,8 @@ Decoder::Decoder(const DecoderConfig &config,
     : _config(config),
       _weights(weights),
       _device(device),
-      _device_ids(device_ids) {}
+      _device_ids(device_ids),
+      _kv_dtype(config.dtype) {}
 
 Decoder::~Decoder() {
     releaseCache();
@@ -68,20 +93,22 @@ Decoder::~Decoder() {
 
 void Decoder::ensureCache() {
     if (!_kv_cache_enabled || _cache_inited || _config.maxseq == 0 || _config.nlayer == 0) return;
+    device::cpu::AllocClassScope alloc_class(LLAISYS_ALLOC_KV_CACHE);
     _k_cache.assign(_config.nlayer, nullptr);
     _v_cache.assign(_config.nlayer, nullptr);
 
     size_t kv_shape[3] = {_config.maxseq, _config.nkvh, _config.dh};
     const int device_id = _device_ids.empty() ? 0 : _device_ids[0];
     for (size_t i = 0; i < _config.nlayer; ++i) {
-        _k_cache[i] = tensorCreate(kv_shape, 3, _config.dtype, _device, device_id);
-        _v_cache[i] = tensorCreate(kv_shape, 3, _config.dtype, _device, device_id);
+        _k_cache[i] = tensorCreate(kv_shape, 3, _kv_dtype, _device, device_id);
+        _v_cache[i] = tensorCreate(kv_shape, 3, _kv_dtype, _device, device_id);
     }
     _past_len = 0;
     _cache_inited = true;
 }
 
 void Decoder::releaseCache() {
+    invalidatePlan();
     for (auto &t : _k_cache) {
         if (t) tensorDestroy(t);
         t = nullptr;
@@ -101,6 +128,60 @@ void Decoder::resetKVCache() {
     _past_len = 0;
 }
 
+bool Decoder::truncateKVCache(size_t len) {
+    if (!_cache_inited) return len == 0;
+    if (len > _past_len) return false;
+    // Cached K/V rows are append-only, so dropping the tail only moves the write cursor;
+    // rows past `len` are overwritten by the next prefill/step.
+    _past_len = len;
+    return true;
+}
+
+size_t Decoder::kvCacheLength() const {
+    return _cache_inited ? _past_len : 0;
+}
+
+void Decoder::setLayerPager(std::unique_ptr<loader::LayerPager> pager) {
+    _pager = std::move(pager);
+}
+
+void Decoder::setDecodePlanEnabled(bool enabled) {
+    _plan_enabled = enabled;
+    if (!enabled) invalidatePlan();
+}
+
+void Decoder::invalidatePlan() {
+    _plan.reset();
+    _plan_weights.reset();
+    _plan_unsupported = false;
+}
+
+bool Decoder::runPlan(int64_t token, llaisysTensor_t out_logits, llaisysTensor_t out_hidden) {
+    if (!_plan_enabled || _device != LLAISYS_DEVICE_CPU) return false;
+    if (_plan_weights && !_plan_weights->matches(*_weights, _config.nlayer)) invalidatePlan();
+    if (_plan_unsupported) return false;
+    ensureCache();
+    if (!_cache_inited || _past_len >= _config.maxseq) return false;
+    if (!_plan) {
+        trace("plan.capture");
+        _plan_weights = std::make_unique<WeightSnapshot>(*_weights, _config.nlayer);
+        _plan = DecodePlan::capture(_config, *_weights, _k_cache, _v_cache);
+        if (!_plan) {
+            _plan_unsupported = true;
+            return false;
+        }
+    }
+    trace("plan.replay");
+    std::function<void(size_t)> enter_layer;
+    if (_pager) enter_layer = [this](size_t layer) { _pager->enter(layer); };
+    _plan->run(token, _past_len,
+               out_logits ? static_cast<std::byte *>(tensorGetData(out_logits)) : nullptr,
+               out_hidden ? static_cast<std::byte *>(tensorGetData(out_hidden)) : nullptr,
+               enter_layer);
+    ++_past_len;
+    return true;
+}
+
 void Decoder::setKVCacheEnabled(bool enabled) {
     if (_kv_cache_enabled == enabled) return;
     _kv_cache_enabled = enabled;
@@ -109,6 +190,17 @@ void Decoder::setKVCacheEnabled(bool enabled) {
     }
 }
 
+bool Decoder::setKVCacheDtype(llaisysDataType_t dtype) {
+    if (dtype != _config.dtype && dtype != LLAISYS_DTYPE_Q8) {
+        std::cerr << "[ERROR] Decoder: unsupported KV-cache dtype " << static_cast<int>(dtype) << std::endl;
+        return false;
+    }
+    if (_kv_dtype == dtype) return true;
+    releaseCache();
+    _kv_dtype = dtype;
+    return true;
+}
+
 bool Decoder::runHidden(const int64_t *token_ids,
                         size_t ntoken,
                         bool append_only,
@@ -148,7 +240,7 @@ bool Decoder::runHidden(const int64_t *token_ids,
                   << " can_cache=" << (can_cache ? 1 : 0)
                   << " past_len=" << past_len
                   << " cur_len=" << cur_len
-                  << " ntoken=" << ntoken << std::endl;
+                  << " ntoken=" << ntoken << '\n';
     }
     const int64_t *new_tokens = append_only ? token_ids : (token_ids + past_len);
     if (can_cache) {
@@ -191,6 +283,7 @@ bool Decoder::runHidden(const int64_t *token_ids,
     // 3) Attention + MLP blocks
     const float scale = 1.0f / std::sqrt(static_cast<float>(_config.dh));
     for (size_t layer = 0; layer < _config.nlayer; ++layer) {
+        if (_pager) _pager->enter(layer);
         trace("attn.weights.check");
         if (!_weights->attn_norm_w || !_weights->attn_q_w || !_weights->attn_k_w || !_weights->attn_v_w ||
             !_weights->attn_o_w || !_weights->mlp_norm_w || !_weights->mlp_gate_w || !_weights->mlp_up_w ||
@@ -310,8 +403,14 @@ bool Decoder::runHidden(const int64_t *token_ids,
             trace("attn.cache.write");
             llaisysTensor_t k_slot = tensorSlice(_k_cache[layer], 0, past_len, past_len + cur_len);
             llaisysTensor_t v_slot = tensorSlice(_v_cache[layer], 0, past_len, past_len + cur_len);
-            ::llaisysRearrange(k_slot, k_rope);
-            ::llaisysRearrange(v_slot, v3d);
+            if (_kv_dtype != _config.dtype) {
+                // quantized cache: each (token, kv head) row gets its own scale on write
+                ::llaisysQuantize(k_slot, k_rope);
+                ::llaisysQuantize(v_slot, v3d);
+            } else {
+                ::llaisysRearrange(k_slot, k_rope);
+                ::llaisysRearrange(v_slot, v3d);
+            }
             tensorDestroy(k_slot);
             tensorDestroy(v_slot);
         }
@@ -404,32 +503,8 @@ bool Decoder::runHidden(const int64_t *token_ids,
         ::llaisysLinear(proj_out, attn_out2d, _weights->attn_o_w[layer], nullptr);
 
         trace("attn.residual");
-        llaisysTensor_t new_hidden = tensorCreate(hidden_shape, 2, _config.dtype, _device, device_id);
-        if (!require_tensor(new_hidden, "attn.residual")) {
-            tensorDestroy(norm);
-            tensorDestroy(pos_ids);
-            tensorDestroy(hidden);
-            tensorDestroy(idx);
-            tensorDestroy(q2d);
-            tensorDestroy(k2d);
-            tensorDestroy(v2d);
-            tensorDestroy(q3d);
-            tensorDestroy(k3d);
-            tensorDestroy(v3d);
-            tensorDestroy(q_rope);
-            tensorDestroy(k_rope);
-            tensorDestroy(attn_out3d);
-            tensorDestroy(attn_out2d);
-            tensorDestroy(proj_out);
-            pos_ids = nullptr;
-            hidden = nullptr;
-            idx = nullptr;
-            return false;
-        }
-        ::llaisysAdd(new_hidden, hidden, proj_out);
-
-        tensorDestroy(hidden);
-        hidden = new_hidden;
+        // the residual stream stays in `hidden` for the whole forward pass
+        ::llaisysAddInplace(hidden, proj_out);
 
         tensorDestroy(norm);
         tensorDestroy(q2d);
@@ -511,25 +586,7 @@ bool Decoder::runHidden(const int64_t *token_ids,
         ::llaisysLinear(mlp_out, swiglu, _weights->mlp_down_w[layer], nullptr);
 
         trace("mlp.residual");
-        llaisysTensor_t mlp_hidden = tensorCreate(hidden_shape, 2, _config.dtype, _device, device_id);
-        if (!require_tensor(mlp_hidden, "mlp.residual")) {
-            tensorDestroy(mlp_norm);
-            tensorDestroy(gate);
-            tensorDestroy(up);
-            tensorDestroy(swiglu);
-            tensorDestroy(mlp_out);
-            tensorDestroy(pos_ids);
-            tensorDestroy(hidden);
-            tensorDestroy(idx);
-            pos_ids = nullptr;
-            hidden = nullptr;
-            idx = nullptr;
-            return false;
-        }
-        ::llaisysAdd(mlp_hidden, hidden, mlp_out);
-
-        tensorDestroy(hidden);
-        hidden = mlp_hidden;
+        ::llaisysAddInplace(hidden, mlp_out);
 
         tensorDestroy(mlp_norm);
         tensorDestroy(gate);
@@ -547,66 +604,60 @@ bool Decoder::runHidden(const int64_t *token_ids,
 
 bool Decoder::prefill(const int64_t *token_ids, size_t ntoken, llaisysTensor_t out_last_logits) {
     if (!out_last_logits) return false;
-    if (!ensure_data(out_last_logits, "head.logits.out")) return false;
-
-    size_t past_len = 0;
-    size_t cur_len = 0;
-    llaisysTensor_t idx = nullptr;
-    llaisysTensor_t pos_ids = nullptr;
-    llaisysTensor_t hidden = nullptr;
-    if (!runHidden(token_ids, ntoken, false, past_len, cur_len, idx, pos_ids, hidden)) return false;
-
-    if (!_weights || !_weights->out_norm_w || !_weights->out_embed) {
-        tensorDestroy(idx);
-        tensorDestroy(pos_ids);
-        tensorDestroy(hidden);
-        return false;
-    }
-
-    trace("head.slice");
-    llaisysTensor_t last_hidden = tensorSlice(hidden, 0, cur_len - 1, cur_len);
-    if (!require_tensor(last_hidden, "head.last_hidden")) {
-        tensorDestroy(idx);
-        tensorDestroy(pos_ids);
-        tensorDestroy(hidden);
-        return false;
-    }
+    return forward(token_ids, ntoken, false, false, out_last_logits, nullptr);
+}
 
-    size_t last_shape[2] = {1, _config.hs};
-    trace("head.norm");
-    llaisysTensor_t final_norm = tensorCreate(last_shape, 2, _config.dtype, _device, _device_ids.empty() ? 0 : _device_ids[0]);
-    if (!require_tensor(final_norm, "head.norm")) {
-        tensorDestroy(last_hidden);
-        tensorDestroy(idx);
-        tensorDestroy(pos_ids);
-        tensorDestroy(hidden);
-        return false;
-    }
-    ::llaisysRmsNorm(final_norm, last_hidden, _weights->out_norm_w, _config.epsilon);
+bool Decoder::decodeStep(const int64_t *token_ids, size_t ntoken, llaisysTensor_t out_last_logits) {
+    if (!out_last_logits) return false;
+    return forward(token_ids, ntoken, true, false, out_last_logits, nullptr);
+}
 
-    trace("head.logits");
-    ::llaisysLinear(out_last_logits, final_norm, _weights->out_embed, nullptr);
+bool Decoder::prefillOutputs(const int64_t *token_ids,
+                             size_t ntoken,
+                             llaisysTensor_t out_logits,
+                             llaisysTensor_t out_hidden) {
+    if (!out_logits && !out_hidden) return false;
+    // Every position must be produced, so the cached prefix cannot be reused.
+    resetKVCache();
+    return forward(token_ids, ntoken, false, true, out_logits, out_hidden);
+}
 
-    tensorDestroy(last_hidden);
-    tensorDestroy(final_norm);
-    tensorDestroy(idx);
-    tensorDestroy(pos_ids);
-    tensorDestroy(hidden);
-    return true;
+bool Decoder::decodeStepOutputs(const int64_t *token_ids,
+                                size_t ntoken,
+                                llaisysTensor_t out_logits,
+                                llaisysTensor_t out_hidden) {
+    if (!out_logits && !out_hidden) return false;
+    return forward(token_ids, ntoken, true, true, out_logits, out_hidden);
 }
 
-bool Decoder::decodeStep(const int64_t *token_ids, size_t ntoken, llaisysTensor_t out_last_logits) {
-    if (!out_last_logits) return false;
-    if (!ensure_data(out_last_logits, "head.logits.out")) return false;
+bool Decoder::forward(const int64_t *token_ids,
+                      size_t ntoken,
+                      bool append_only,
+                      bool all_positions,
+                      llaisysTensor_t out_logits,
+                      llaisysTensor_t out_hidden) {
+    if (out_logits && !ensure_data(out_logits, "head.logits.out")) return false;
+    if (out_hidden && !ensure_data(out_hidden, "head.hidden.out")) return false;
+    if (!_weights || !_weights->out_norm_w || !_weights->out_embed) return false;
+
+    // Output rows are known up front: one per token of this call, or just the last one.
+    const size_t nrow = all_positions ? ntoken : 1;
+    if (out_logits && !check_shape(out_logits, nrow, _config.voc, "head.logits.out")) return false;
+    if (out_hidden && !check_shape(out_hidden, nrow, _config.hs, "head.hidden.out")) return false;
+
+    if (append_only && ntoken == 1 && token_ids && plan_output(out_logits, _config.dtype) &&
+        plan_output(out_hidden, _config.dtype) && runPlan(token_ids[0], out_logits, out_hidden)) {
+        return true;
+    }
 
     size_t past_len = 0;
     size_t cur_len = 0;
     llaisysTensor_t idx = nullptr;
     llaisysTensor_t pos_ids = nullptr;
     llaisysTensor_t hidden = nullptr;
-    if (!runHidden(token_ids, ntoken, true, past_len, cur_len, idx, pos_ids, hidden)) return false;
-
-    if (!_weights || !_weights->out_norm_w || !_weights->out_embed) {
+    if (!runHidden(token_ids, ntoken, append_only, past_len, cur_len, idx, pos_ids, hidden)) return false;
+    if (all_positions && cur_len != nrow) {
+        std::cerr << "[ERROR] Decoder: computed " << cur_len << " positions, expected " << nrow << std::endl;
         tensorDestroy(idx);
         tensorDestroy(pos_ids);
         tensorDestroy(hidden);
@@ -614,31 +665,37 @@ bool Decoder::decodeStep(const int64_t *token_ids, size_t ntoken, llaisysTensor_
     }
 
     trace("head.slice");
-    llaisysTensor_t last_hidden = tensorSlice(hidden, 0, cur_len - 1, cur_len);
-    if (!require_tensor(last_hidden, "head.last_hidden")) {
+    llaisysTensor_t head_in = all_positions ? hidden : tensorSlice(hidden, 0, cur_len - 1, cur_len);
+    if (!require_tensor(head_in, "head.in")) {
         tensorDestroy(idx);
         tensorDestroy(pos_ids);
         tensorDestroy(hidden);
         return false;
     }
 
-    size_t last_shape[2] = {1, _config.hs};
+    size_t head_shape[2] = {nrow, _config.hs};
     trace("head.norm");
-    llaisysTensor_t final_norm = tensorCreate(last_shape, 2, _config.dtype, _device, _device_ids.empty() ? 0 : _device_ids[0]);
+    llaisysTensor_t final_norm = out_hidden;
+    if (!final_norm) {
+        final_norm = tensorCreate(head_shape, 2, _config.dtype, _device, _device_ids.empty() ? 0 : _device_ids[0]);
+    }
     if (!require_tensor(final_norm, "head.norm")) {
-        tensorDestroy(last_hidden);
+        if (head_in != hidden) tensorDestroy(head_in);
         tensorDestroy(idx);
         tensorDestroy(pos_ids);
         tensorDestroy(hidden);
         return false;
     }
-    ::llaisysRmsNorm(final_norm, last_hidden, _weights->out_norm_w, _config.epsilon);
+    ::llaisysRmsNorm(final_norm, head_in, _weights->out_norm_w, _config.epsilon);
 
-    trace("head.logits");
-    ::llaisysLinear(out_last_logits, final_norm, _weights->out_embed, nullptr);
+    if (out_logits) {
+        // A single [nrow, hs] x [voc, hs]^T GEMM covers every requested position.
+        trace("head.logits");
+        ::llaisysLinear(out_logits, final_norm, _weights->out_embed, nullptr);
+    }
 
-    tensorDestroy(last_hidden);
-    tensorDestroy(final_norm);
+    if (head_in != hidden) tensorDestroy(head_in);
+    if (final_norm != out_hidden) tensorDestroy(final_norm);
     tensorDestroy(idx);
     tensorDestroy(pos_ids);
     tensorDestroy(hidden);
@@ -5,9 +5,16 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <vector>
 
+namespace llaisys::loader {
+class LayerPager;
+} // namespace llaisys::loader
+
 namespace llaisys::models::transformer {
+class DecodePlan;
+class WeightSnapshot;
 
 struct DecoderConfig {
     llaisysDataType_t dtype{};
@@ -37,11 +44,43 @@ public:
     // Decode with only new tokens (append-only), returns last-step logits.
     bool decodeStep(const int64_t *token_ids, size_t ntoken, llaisysTensor_t out_last_logits);
 
+    // Per-position variants: out_logits is [ntoken, voc] and out_hidden is [ntoken, hs]
+    // (final hidden states after the output norm). Either may be null.
+    // prefillOutputs always starts from position 0 and so discards the cached prefix.
+    bool prefillOutputs(const int64_t *token_ids, size_t ntoken, llaisysTensor_t out_logits, llaisysTensor_t out_hidden);
+    bool decodeStepOutputs(const int64_t *token_ids, size_t ntoken, llaisysTensor_t out_logits, llaisysTensor_t out_hidden);
+
     void resetKVCache();
 
+    // Roll the cache back so that only the first `len` positions stay valid.
+    // Fails if `len` is beyond the currently cached length.
+    bool truncateKVCache(size_t len);
+
+    size_t kvCacheLength() const;
+
     void setKVCacheEnabled(bool enabled);
 
+    // Storage dtype of the KV-cache: the model dtype (default) or LLAISYS_DTYPE_Q8, which keeps
+    // one int8 row plus a float scale per token and kv head. Changing it drops the cached positions.
+    bool setKVCacheDtype(llaisysDataType_t dtype);
+
+    // Optional weight paging driven by the layer loop; null disables it.
+    void setLayerPager(std::unique_ptr<loader::LayerPager> pager);
+
+    // Single-token decode steps on CPU replay a captured DecodePlan instead of going through
+    // the op layer (on by default). The plan is captured lazily on the first such step.
+    void setDecodePlanEnabled(bool enabled);
+
+    // Drops the captured plan. Edits to the weight table are also detected before each step.
+    void invalidatePlan();
+
 private:
+    bool forward(const int64_t *token_ids,
+                 size_t ntoken,
+                 bool append_only,
+                 bool all_positions,
+                 llaisysTensor_t out_logits,
+                 llaisysTensor_t out_hidden);
     bool runHidden(const int64_t *token_ids,
                    size_t ntoken,
                    bool append_only,
@@ -52,6 +91,7 @@ private:
                    llaisysTensor_t &hidden);
     void ensureCache();
     void releaseCache();
+    bool runPlan(int64_t token, llaisysTensor_t out_logits, llaisysTensor_t out_hidden);
 
     DecoderConfig _config{};
     const LlaisysQwen2Weights *_weights{nullptr};
@@ -59,9 +99,17 @@ private:
     std::vector<int> _device_ids;
     std::vector<llaisysTensor_t> _k_cache;
     std::vector<llaisysTensor_t> _v_cache;
+    llaisysDataType_t _kv_dtype{};
     size_t _past_len{0};
     bool _cache_inited{false};
     bool _kv_cache_enabled{true};
+    std::unique_ptr<loader::LayerPager> _pager;
+    std::unique_ptr<DecodePlan> _plan;
+    // weight table the plan (or the failed capture) was taken from
+    std::unique_ptr<WeightSnapshot> _plan_weights;
+    bool _plan_enabled{true};
+    // set when capture failed for the current weights/cache, so it is not retried every step
+    bool _plan_unsupported{false};
 };
 
 } // namespace llaisys::models::transformer
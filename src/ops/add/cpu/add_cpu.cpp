@@ -1,33 +1,10 @@
 #include "add_cpu.hpp"
 
-#include "../../../utils.hpp"
-
-#include <cmath>
-
-template <typename T>
-    void add_(T *c, const T *a, const T *b, size_t numel) {
-        for (size_t i = 0; i < numel; i++) {
-            if constexpr (std::is_same_v<T, llaisys::bf16_t> || std::is_same_v<T, llaisys::fp16_t>) {
-                c[i] = llaisys::utils::cast<T>(llaisys::utils::cast<float>(a[i]) + llaisys::utils::cast<float>(b[i]));
-            } else {
-                c[i] = a[i] + b[i];
-            }
-        }
-    }
+#include "../../elementwise.hpp"
 
 namespace llaisys::ops::cpu {
-    void add(std::byte *c, const std::byte *a, const std::byte *b, llaisysDataType_t type, size_t numel) {
-        switch (type) {
-            case LLAISYS_DTYPE_F32:
-                return add_(reinterpret_cast<float *>(c), reinterpret_cast<const float *>(a), reinterpret_cast<const float *>(b), numel);
-            case LLAISYS_DTYPE_BF16:
-                return add_(reinterpret_cast<llaisys::bf16_t *>(c), reinterpret_cast<const llaisys::bf16_t *>(a),
-                            reinterpret_cast<const llaisys::bf16_t *>(b), numel);
-            case LLAISYS_DTYPE_F16:
-                return add_(reinterpret_cast<llaisys::fp16_t *>(c), reinterpret_cast<const llaisys::fp16_t *>(a),
-                            reinterpret_cast<const llaisys::fp16_t *>(b), numel);
-            default:
-                EXCEPTION_UNSUPPORTED_DATATYPE(type);
-        }
+    void add(std::byte *c, const std::byte *a, const std::byte *b, llaisysDataType_t type, size_t rows, size_t cols,
+             MatStrides c_strides, MatStrides a_strides, MatStrides b_strides) {
+        elementwise::binary<elementwise::Add>(c, a, b, type, rows, cols, c_strides, a_strides, b_strides);
     }
 } // namespace llaisys::ops::cpu
@@ -1,8 +1,13 @@
 #pragma once
 #include "llaisys.h"
 
+#include "../../strides.hpp"
+
 #include <cstddef>
 
 namespace llaisys::ops::cpu {
-    void add(std::byte *c, const std::byte *a, const std::byte *b, llaisysDataType_t type, size_t size);
-}
\ No newline at end of file
+    // c/a/b are [rows, cols] blocks with their own row/col strides (in elements); a stride of 0
+    // broadcasts a/b along that dim. c may be a or b for an in-place add.
+    void add(std::byte *c, const std::byte *a, const std::byte *b, llaisysDataType_t type, size_t rows, size_t cols,
+             MatStrides c_strides, MatStrides a_strides, MatStrides b_strides);
+}
@@ -1,36 +1,11 @@
 #include "op.hpp"
 
-#include "../../core/llaisys_core.hpp"
-#include "../../utils.hpp"
+#include "../binary.hpp"
 
 #include "cpu/add_cpu.hpp"
 
 namespace llaisys::ops {
 void add(tensor_t c, tensor_t a, tensor_t b) {
-    //确保所有张量都在同一设备上
-    CHECK_SAME_DEVICE(c, a, b);
-    // Only support contiguous inputs with same shape for now.
-    CHECK_SAME_SHAPE(c->shape(), a->shape(), b->shape());
-    CHECK_SAME_DTYPE(c->dtype(), a->dtype(), b->dtype());
-    ASSERT(c->isContiguous() && a->isContiguous() && b->isContiguous(), "Add: all tensors must be contiguous.");
-
-    // always support cpu calculation
-    if (c->deviceType() == LLAISYS_DEVICE_CPU) {
-        return cpu::add(c->data(), a->data(), b->data(), c->dtype(), c->numel());
-    }
-
-    llaisys::core::context().setDevice(c->deviceType(), c->deviceId());
-
-    switch (c->deviceType()) {
-    case LLAISYS_DEVICE_CPU:
-        return cpu::add(c->data(), a->data(), b->data(), c->dtype(), c->numel());
-#ifdef ENABLE_NVIDIA_API
-    case LLAISYS_DEVICE_NVIDIA:
-        TO_BE_IMPLEMENTED();
-        return;
-#endif
-    default:
-        EXCEPTION_UNSUPPORTED_DEVICE;
-    }
+    binary_op("Add", c, a, b, cpu::add);
 }
 } // namespace llaisys::ops
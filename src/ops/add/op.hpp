@@ -3,5 +3,7 @@
 #include "../../tensor/tensor.hpp"
 
 namespace llaisys::ops {
+// c = a + b with NumPy broadcasting of a and b to c's shape. c may be a or b (same layout) to
+// add in place.
 void add(tensor_t c, tensor_t a, tensor_t b);
 }
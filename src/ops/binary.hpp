@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../core/llaisys_core.hpp"
+#include "../tensor/tensor.hpp"
+#include "../utils.hpp"
+#include "strides.hpp"
+
+#include <cstddef>
+
+namespace llaisys::ops {
+// CPU body of a broadcasting binary op: c/a/b are [rows, cols] blocks with their own
+// row/col strides (in elements).
+using BinaryKernel = void (*)(std::byte *c, const std::byte *a, const std::byte *b, llaisysDataType_t type,
+                              size_t rows, size_t cols, MatStrides c_strides, MatStrides a_strides,
+                              MatStrides b_strides);
+
+// c = f(a, b) with NumPy broadcasting of a and b to c's shape, running `cpu_kernel` once per
+// block of the reduced layout. An input may share c's memory only with c's layout (in place).
+// `name` prefixes the error messages.
+inline void binary_op(const char *name, tensor_t c, tensor_t a, tensor_t b, BinaryKernel cpu_kernel) {
+    CHECK_SAME_DEVICE(c, a, b);
+    CHECK_SAME_DTYPE(c->dtype(), a->dtype(), b->dtype());
+
+    const BroadcastLayout l = broadcast_layout(*c, *a, *b);
+    ASSERT((a->data() != c->data() || l.a == l.c) && (b->data() != c->data() || l.b == l.c),
+           name << ": an input aliasing the output must have the output's layout.");
+    if (c->numel() == 0) return;
+
+    // always support cpu calculation
+    if (c->deviceType() == LLAISYS_DEVICE_CPU) {
+        const size_t es = c->elementSize();
+        for_each_block(l, [&](ptrdiff_t co, ptrdiff_t ao, ptrdiff_t bo) {
+            cpu_kernel(c->data() + co * es, a->data() + ao * es, b->data() + bo * es, c->dtype(), l.rows(), l.cols(),
+                       l.mat(l.c), l.mat(l.a), l.mat(l.b));
+        });
+        return;
+    }
+
+    llaisys::core::context().setDevice(c->deviceType(), c->deviceId());
+
+    switch (c->deviceType()) {
+#ifdef ENABLE_NVIDIA_API
+    case LLAISYS_DEVICE_NVIDIA:
+        TO_BE_IMPLEMENTED();
+        return;
+#endif
+    default:
+        EXCEPTION_UNSUPPORTED_DEVICE;
+    }
+}
+} // namespace llaisys::ops
@@ -0,0 +1,274 @@
+#pragma once
+
+#include "../utils.hpp"
+#include "../utils/cpu_features.hpp"
+#include "strides.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+// Compile-time elementwise kernels for the CPU ops. A functor maps fp32 inputs to one fp32
+// result; map_rows expands it into a tiled loop that widens every operand to fp32 one
+// L1-sized tile at a time, runs the functor over the tile as a SIMD loop and narrows on
+// store. Large inputs are split across threads. The GEMM epilogues at the bottom of this
+// file apply the same fp32-accumulator view to a linear's output before it is stored.
+namespace llaisys::ops::cpu::elementwise {
+constexpr size_t kTile = 512;
+constexpr size_t kParallelElems = size_t(1) << 16;
+
+// A [rows, cols] operand whose rows are `stride` elements apart and whose cols are `col`
+// elements apart. col == 1 is the fast path; col == 0 broadcasts one value along the row.
+template <typename T>
+struct Rows {
+    T *data;
+    ptrdiff_t stride;
+    ptrdiff_t col = 1;
+};
+
+template <typename T>
+Rows<T> rows_of(std::byte *p, ptrdiff_t stride, ptrdiff_t col = 1) {
+    return {reinterpret_cast<T *>(p), stride, col};
+}
+
+template <typename T>
+Rows<const T> rows_of(const std::byte *p, ptrdiff_t stride, ptrdiff_t col = 1) {
+    return {reinterpret_cast<const T *>(p), stride, col};
+}
+
+// Widen / narrow one value. bf16 is converted inline (same rounding as utils::cast) so loops
+// over it vectorize; f16 goes through utils::cast.
+template <typename T>
+inline float to_float(T v) {
+    if constexpr (std::is_same_v<T, bf16_t>) {
+        uint32_t bits = static_cast<uint32_t>(v._v) << 16;
+        float f;
+        std::memcpy(&f, &bits, sizeof(float));
+        return f;
+    } else {
+        return utils::cast<float>(v);
+    }
+}
+
+template <typename T>
+inline T from_float(float f) {
+    if constexpr (std::is_same_v<T, bf16_t>) {
+        uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(float));
+        return T{static_cast<uint16_t>((bits + 0x7FFFu + ((bits >> 16) & 1u)) >> 16)};
+    } else {
+        return utils::cast<T>(f);
+    }
+}
+
+// Widen / narrow a contiguous tile.
+template <typename T>
+inline void load(float *dst, const T *src, size_t n) {
+    if constexpr (std::is_same_v<T, float>) {
+        std::memcpy(dst, src, n * sizeof(float));
+    } else if constexpr (std::is_same_v<T, bf16_t>) {
+        const uint16_t *s = reinterpret_cast<const uint16_t *>(src);
+#pragma omp simd
+        for (size_t i = 0; i < n; ++i) {
+            uint32_t bits = static_cast<uint32_t>(s[i]) << 16;
+            std::memcpy(dst + i, &bits, sizeof(float));
+        }
+    } else {
+        for (size_t i = 0; i < n; ++i) dst[i] = utils::cast<float>(src[i]);
+    }
+}
+
+template <typename T>
+inline void store(T *dst, const float *src, size_t n) {
+    if constexpr (std::is_same_v<T, float>) {
+        std::memcpy(dst, src, n * sizeof(float));
+    } else if constexpr (std::is_same_v<T, bf16_t>) {
+        uint16_t *d = reinterpret_cast<uint16_t *>(dst);
+#pragma omp simd
+        for (size_t i = 0; i < n; ++i) {
+            uint32_t bits;
+            std::memcpy(&bits, src + i, sizeof(float));
+            d[i] = static_cast<uint16_t>((bits + 0x7FFFu + ((bits >> 16) & 1u)) >> 16);
+        }
+    } else {
+        for (size_t i = 0; i < n; ++i) dst[i] = utils::cast<T>(src[i]);
+    }
+}
+
+// Unit-stride fp32 operands are used in place; others are widened into `buf`.
+template <typename T>
+inline const float *widen(float *buf, const T *src, ptrdiff_t col, size_t n) {
+    if (col == 1) {
+        if constexpr (std::is_same_v<T, float>) {
+            return src;
+        } else {
+            load(buf, src, n);
+        }
+    } else if (col == 0) {
+        const float v = to_float(*src);
+#pragma omp simd
+        for (size_t i = 0; i < n; ++i) buf[i] = v;
+    } else {
+        for (size_t i = 0; i < n; ++i) buf[i] = to_float(src[static_cast<ptrdiff_t>(i) * col]);
+    }
+    return buf;
+}
+
+template <typename F, size_t N, size_t... Is>
+inline float invoke_at(const F &f, const float *const (&src)[N], size_t i, std::index_sequence<Is...>) {
+    return f(src[Is][i]...);
+}
+
+// One tile of one row: always inlined so it is compiled for the ISA of its caller.
+template <typename F, typename Out, typename... In>
+[[gnu::always_inline]] inline void tile(const F &f, size_t r, size_t c0, size_t n, Rows<Out> out, Rows<const In>... in) {
+    alignas(64) float buf[sizeof...(In)][kTile];
+    alignas(64) float res[kTile];
+    const auto row = static_cast<ptrdiff_t>(r);
+    size_t idx = 0;
+    const auto c = static_cast<ptrdiff_t>(c0);
+    const float *const src[] = {widen(buf[idx++], in.data + row * in.stride + c * in.col, in.col, n)...};
+    Out *dst = out.data + row * out.stride + c * out.col;
+    float *res_ptr = res;
+    bool in_place = false;
+    if constexpr (std::is_same_v<Out, float>) {
+        in_place = out.col == 1;
+        if (in_place) res_ptr = dst;
+    }
+#pragma omp simd
+    for (size_t i = 0; i < n; ++i) {
+        res_ptr[i] = invoke_at(f, src, i, std::index_sequence_for<In...>{});
+    }
+    if (in_place) return;
+    if (out.col == 1) {
+        store(dst, res, n);
+    } else {
+        for (size_t i = 0; i < n; ++i) dst[static_cast<ptrdiff_t>(i) * out.col] = from_float<Out>(res[i]);
+    }
+}
+
+template <typename F, typename Out, typename... In>
+void tile_generic(const F &f, size_t r, size_t c0, size_t n, Rows<Out> out, Rows<const In>... in) {
+    tile(f, r, c0, n, out, in...);
+}
+
+#if LLAISYS_X86_SIMD
+template <typename F, typename Out, typename... In>
+LLAISYS_TARGET("avx2,fma")
+void tile_avx2(const F &f, size_t r, size_t c0, size_t n, Rows<Out> out, Rows<const In>... in) {
+    tile(f, r, c0, n, out, in...);
+}
+#endif
+
+// out[r, c] = f(in[r, c]...) over a [rows, cols] grid. Out may differ from the inputs' types,
+// which is how a cast is fused into the pass. `out` may alias an input with the same layout,
+// but not a broadcast one.
+template <typename F, typename Out, typename... In>
+void map_rows(const F &f, size_t rows, size_t cols, Rows<Out> out, Rows<const In>... in) {
+    static_assert(sizeof...(In) > 0, "map_rows needs at least one input");
+    using tile_fn = void (*)(const F &, size_t, size_t, size_t, Rows<Out>, Rows<const In>...);
+    static const tile_fn run = [] {
+#if LLAISYS_X86_SIMD
+        const auto &features = utils::cpu_features();
+        if (features.avx2 && features.fma) return static_cast<tile_fn>(&tile_avx2<F, Out, In...>);
+#endif
+        return static_cast<tile_fn>(&tile_generic<F, Out, In...>);
+    }();
+
+    if (rows == 0 || cols == 0) return;
+    const size_t per_row = (cols + kTile - 1) / kTile;
+    const auto ntile = static_cast<ptrdiff_t>(rows * per_row);
+#pragma omp parallel for schedule(static) if (rows * cols >= kParallelElems)
+    for (ptrdiff_t t = 0; t < ntile; ++t) {
+        const size_t r = static_cast<size_t>(t) / per_row;
+        const size_t c0 = static_cast<size_t>(t) % per_row * kTile;
+        run(f, r, c0, std::min(kTile, cols - c0), out, in...);
+    }
+}
+
+// Calls fn(T{}) with the element type of a floating point dtype.
+template <typename Fn>
+void dispatch_float(llaisysDataType_t type, Fn &&fn) {
+    switch (type) {
+    case LLAISYS_DTYPE_F32:
+        return fn(float{});
+    case LLAISYS_DTYPE_BF16:
+        return fn(bf16_t{});
+    case LLAISYS_DTYPE_F16:
+        return fn(fp16_t{});
+    default:
+        EXCEPTION_UNSUPPORTED_DATATYPE(type);
+    }
+}
+
+// c = F(a, b) over a [rows, cols] block in any floating point dtype: the CPU kernel of a
+// broadcasting binary op (see binary.hpp).
+template <typename F>
+void binary(std::byte *c, const std::byte *a, const std::byte *b, llaisysDataType_t type, size_t rows, size_t cols,
+            MatStrides c_strides, MatStrides a_strides, MatStrides b_strides) {
+    dispatch_float(type, [&](auto tag) {
+        using T = decltype(tag);
+        map_rows(F{}, rows, cols, rows_of<T>(c, c_strides.row, c_strides.col),
+                 rows_of<T>(a, a_strides.row, a_strides.col), rows_of<T>(b, b_strides.row, b_strides.col));
+    });
+}
+
+// ---- functors ----
+
+struct Add {
+    float operator()(float a, float b) const { return a + b; }
+};
+
+struct Mul {
+    float operator()(float a, float b) const { return a * b; }
+};
+
+// up * silu(gate), evaluated in the order the reference kernel used.
+struct SwiGLU {
+    float operator()(float gate, float up) const {
+        float sigmoid = 1.0f / (1.0f + std::exp(-gate));
+        return up * gate * sigmoid;
+    }
+};
+
+// Rounds to T's precision, e.g. to reproduce a result that used to be stored in T between
+// two ops.
+template <typename T>
+struct RoundTo {
+    float operator()(float x) const {
+        if constexpr (std::is_same_v<T, float>) {
+            return x;
+        } else {
+            return utils::cast<float>(utils::cast<T>(x));
+        }
+    }
+};
+
+// ---- GEMM epilogues ----
+// Called with the fp32 accumulator of out[i, o] (row i, output feature o) before it is stored.
+
+template <typename T>
+struct Bias {
+    const T *bias;
+    float operator()(float acc, size_t, size_t o) const {
+        return bias ? acc + utils::cast<float>(bias[o]) : acc;
+    }
+};
+
+// residual + inner, with inner rounded to T first so the result is bit-identical to storing
+// the projection and adding the residual in a separate pass.
+template <typename T, typename E>
+struct AddResidual {
+    E inner;
+    const T *residual;
+    ptrdiff_t stride;
+    float operator()(float acc, size_t i, size_t o) const {
+        float y = RoundTo<T>{}(inner(acc, i, o));
+        return utils::cast<float>(residual[static_cast<ptrdiff_t>(i) * stride + static_cast<ptrdiff_t>(o)]) + y;
+    }
+};
+} // namespace llaisys::ops::cpu::elementwise
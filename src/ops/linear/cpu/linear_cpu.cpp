@@ -1,31 +1,116 @@
 #include "linear_cpu.hpp"
 
 #include "../../../utils.hpp"
+#include "../../../utils/cpu_features.hpp"
+#include "../../elementwise.hpp"
 
 #include <cstddef>
+#include <cstdint>
+#include <type_traits>
 
 namespace {
 	template <typename T>
-	void linear_impl(std::byte *out, const std::byte *in, const std::byte *weight, const std::byte *bias,
-	                 size_t m, size_t n, size_t k) {
+	float dot_scalar(const T *a, const T *b, size_t k) {
+		float acc = 0.f;
+		for (size_t j = 0; j < k; ++j) {
+			acc += llaisys::utils::cast<float>(a[j]) * llaisys::utils::cast<float>(b[j]);
+		}
+		return acc;
+	}
+
+	using dot_bf16_fn = float (*)(const llaisys::bf16_t *a, const llaisys::bf16_t *b, size_t k);
+
+#if LLAISYS_X86_SIMD
+	LLAISYS_TARGET("avx2,fma")
+	inline __m256 load_bf16x8(const llaisys::bf16_t *p) {
+		__m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+		return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(h), 16));
+	}
+
+	// bf16 -> f32 is a 16-bit shift, so AVX2 widens in registers and uses f32 FMAs.
+	LLAISYS_TARGET("avx2,fma")
+	float dot_bf16_avx2(const llaisys::bf16_t *a, const llaisys::bf16_t *b, size_t k) {
+		__m256 acc0 = _mm256_setzero_ps();
+		__m256 acc1 = _mm256_setzero_ps();
+		size_t j = 0;
+		for (; j + 16 <= k; j += 16) {
+			acc0 = _mm256_fmadd_ps(load_bf16x8(a + j), load_bf16x8(b + j), acc0);
+			acc1 = _mm256_fmadd_ps(load_bf16x8(a + j + 8), load_bf16x8(b + j + 8), acc1);
+		}
+		__m256 acc = _mm256_add_ps(acc0, acc1);
+		__m128 s = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+		s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+		s = _mm_add_ss(s, _mm_movehdup_ps(s));
+		float total = _mm_cvtss_f32(s);
+		for (; j < k; ++j) {
+			total += llaisys::utils::cast<float>(a[j]) * llaisys::utils::cast<float>(b[j]);
+		}
+		return total;
+	}
+
+	// vdpbf16ps multiplies bf16 pairs and accumulates in f32: 32 products per instruction,
+	// tail handled with a masked load.
+	LLAISYS_TARGET("avx512f,avx512bw,avx512bf16")
+	float dot_bf16_avx512(const llaisys::bf16_t *a, const llaisys::bf16_t *b, size_t k) {
+		__m512 acc0 = _mm512_setzero_ps();
+		__m512 acc1 = _mm512_setzero_ps();
+		size_t j = 0;
+		for (; j + 64 <= k; j += 64) {
+			acc0 = _mm512_dpbf16_ps(acc0, (__m512bh)_mm512_loadu_si512(a + j), (__m512bh)_mm512_loadu_si512(b + j));
+			acc1 = _mm512_dpbf16_ps(acc1, (__m512bh)_mm512_loadu_si512(a + j + 32),
+			                        (__m512bh)_mm512_loadu_si512(b + j + 32));
+		}
+		for (; j < k; j += 32) {
+			__mmask32 m = k - j >= 32 ? ~__mmask32(0) : static_cast<__mmask32>((1u << (k - j)) - 1);
+			acc0 = _mm512_dpbf16_ps(acc0, (__m512bh)_mm512_maskz_loadu_epi16(m, a + j),
+			                        (__m512bh)_mm512_maskz_loadu_epi16(m, b + j));
+		}
+		// _mm512_reduce_add_ps trips -Wuninitialized inside GCC 12 headers; reduce by hand.
+		alignas(64) float lanes[16];
+		_mm512_store_ps(lanes, _mm512_add_ps(acc0, acc1));
+		float total = 0.f;
+		for (float v : lanes) total += v;
+		return total;
+	}
+#endif
+
+	dot_bf16_fn select_dot_bf16() {
+#if LLAISYS_X86_SIMD
+		const auto &f = llaisys::utils::cpu_features();
+		if (f.avx512f && f.avx512bw && f.avx512bf16) return dot_bf16_avx512;
+		if (f.avx2 && f.fma) return dot_bf16_avx2;
+#endif
+		return dot_scalar<llaisys::bf16_t>;
+	}
+
+	template <typename T>
+	auto select_dot() {
+		if constexpr (std::is_same_v<T, llaisys::bf16_t>) {
+			return select_dot_bf16();
+		} else {
+			return &dot_scalar<T>;
+		}
+	}
+
+	// Output features are split across threads; each weight row is read once and reused for
+	// all m input rows while it is hot in cache. The epilogue finishes each fp32 accumulator.
+	template <typename T, typename E>
+	void linear_impl(std::byte *out, const std::byte *in, const std::byte *weight, const E &epilogue,
+	                 size_t m, size_t n, size_t k, ptrdiff_t out_stride, ptrdiff_t in_stride) {
+		static const auto dot = select_dot<T>();
 		const T *in_ptr = reinterpret_cast<const T *>(in);
 		const T *w_ptr = reinterpret_cast<const T *>(weight);
-		const T *bias_ptr = bias ? reinterpret_cast<const T *>(bias) : nullptr;
 		T *out_ptr = reinterpret_cast<T *>(out);
 
-		for (size_t i = 0; i < m; ++i) {
-			for (size_t o = 0; o < n; ++o) {
-                //计算第i行第o列
-				float acc = bias_ptr ? llaisys::utils::cast<float>(bias_ptr[o]) : 0.f;
-                //weight的第o行
-				const T *w_row = w_ptr + o * k; // weight shape [n, k]
-                //in的第i行
-				const T *in_row = in_ptr + i * k;
-                //点积计算
-				for (size_t j = 0; j < k; ++j) {
-					acc += llaisys::utils::cast<float>(in_row[j]) * llaisys::utils::cast<float>(w_row[j]);
-				}
-				out_ptr[i * n + o] = llaisys::utils::cast<T>(acc);
+#pragma omp parallel for schedule(static)
+		for (ptrdiff_t o = 0; o < static_cast<ptrdiff_t>(n); ++o) {
+			//weight的第o行
+			const T *w_row = w_ptr + o * k; // weight shape [n, k]
+			for (size_t i = 0; i < m; ++i) {
+				//第i行第o列 = in的第i行与weight第o行的点积
+				const auto r = static_cast<ptrdiff_t>(i);
+				out_ptr[r * out_stride + o] =
+				    llaisys::utils::cast<T>(epilogue(dot(in_ptr + r * in_stride, w_row, k), i, static_cast<size_t>(o)));
 			}
 		}
 	}
@@ -33,16 +118,22 @@ namespace {
 
 namespace llaisys::ops::cpu {
 void linear(std::byte *out, const std::byte *in, const std::byte *weight, const std::byte *bias,
-            llaisysDataType_t type, size_t m, size_t n, size_t k) {
-	switch (type) {
-	case LLAISYS_DTYPE_F32:
-		return linear_impl<float>(out, in, weight, bias, m, n, k);
-	case LLAISYS_DTYPE_BF16:
-		return linear_impl<llaisys::bf16_t>(out, in, weight, bias, m, n, k);
-	case LLAISYS_DTYPE_F16:
-		return linear_impl<llaisys::fp16_t>(out, in, weight, bias, m, n, k);
-	default:
-		EXCEPTION_UNSUPPORTED_DATATYPE(type);
-	}
+            llaisysDataType_t type, size_t m, size_t n, size_t k, ptrdiff_t out_stride, ptrdiff_t in_stride) {
+	elementwise::dispatch_float(type, [&](auto tag) {
+		using T = decltype(tag);
+		elementwise::Bias<T> epilogue{reinterpret_cast<const T *>(bias)};
+		linear_impl<T>(out, in, weight, epilogue, m, n, k, out_stride, in_stride);
+	});
+}
+
+void linear_add(std::byte *out, const std::byte *in, const std::byte *weight, const std::byte *bias,
+                const std::byte *residual, llaisysDataType_t type, size_t m, size_t n, size_t k,
+                ptrdiff_t out_stride, ptrdiff_t in_stride, ptrdiff_t residual_stride) {
+	elementwise::dispatch_float(type, [&](auto tag) {
+		using T = decltype(tag);
+		elementwise::AddResidual<T, elementwise::Bias<T>> epilogue{
+		    {reinterpret_cast<const T *>(bias)}, reinterpret_cast<const T *>(residual), residual_stride};
+		linear_impl<T>(out, in, weight, epilogue, m, n, k, out_stride, in_stride);
+	});
 }
 } // namespace llaisys::ops::cpu
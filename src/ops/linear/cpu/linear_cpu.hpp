@@ -4,6 +4,25 @@
 #include <cstddef>
 
 namespace llaisys::ops::cpu {
+// out [m, n] = in [m, k] x weight [n, k]^T (+ bias). Rows of out/in are `out_stride` / `in_stride`
+// elements apart; the weight is dense.
 void linear(std::byte *out, const std::byte *in, const std::byte *weight, const std::byte *bias,
-            llaisysDataType_t type, size_t m, size_t n, size_t k);
+            llaisysDataType_t type, size_t m, size_t n, size_t k, ptrdiff_t out_stride, ptrdiff_t in_stride);
+
+// out = residual + linear(in), fused into the GEMM epilogue. The projection is rounded to `type`
+// before the add, so the result equals linear followed by add. `residual` may alias `out`.
+void linear_add(std::byte *out, const std::byte *in, const std::byte *weight, const std::byte *bias,
+                const std::byte *residual, llaisysDataType_t type, size_t m, size_t n, size_t k,
+                ptrdiff_t out_stride, ptrdiff_t in_stride, ptrdiff_t residual_stride);
+
+// Weight-only quantized linear: weight is [n, k] in the quantized `wtype`,
+// in/out/bias are in the floating point `type`.
+void linear_quant(std::byte *out, const std::byte *in, const std::byte *weight, const std::byte *bias,
+                  llaisysDataType_t type, llaisysDataType_t wtype, size_t m, size_t n, size_t k,
+                  ptrdiff_t out_stride, ptrdiff_t in_stride);
+
+// Quantized counterpart of linear_add.
+void linear_quant_add(std::byte *out, const std::byte *in, const std::byte *weight, const std::byte *bias,
+                      const std::byte *residual, llaisysDataType_t type, llaisysDataType_t wtype, size_t m,
+                      size_t n, size_t k, ptrdiff_t out_stride, ptrdiff_t in_stride, ptrdiff_t residual_stride);
 }
@@ -0,0 +1,220 @@
+#include "linear_cpu.hpp"
+
+#include "../../../utils.hpp"
+#include "../../../utils/cpu_features.hpp"
+#include "../../elementwise.hpp"
+
+#include <cstring>
+#include <vector>
+
+namespace {
+	using dot_q8_fn = float (*)(const int8_t *q, const float *x, size_t k);
+
+	float dot_q8_scalar(const int8_t *q, const float *x, size_t k) {
+		float acc = 0.f;
+		for (size_t j = 0; j < k; ++j) {
+			acc += static_cast<float>(q[j]) * x[j];
+		}
+		return acc;
+	}
+
+#if LLAISYS_X86_SIMD
+	LLAISYS_TARGET("avx2,fma")
+	float dot_q8_avx2(const int8_t *q, const float *x, size_t k) {
+		__m256 acc0 = _mm256_setzero_ps();
+		__m256 acc1 = _mm256_setzero_ps();
+		size_t j = 0;
+		for (; j + 16 <= k; j += 16) {
+			__m128i q16 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(q + j));
+			__m256 lo = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(q16));
+			__m256 hi = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_srli_si128(q16, 8)));
+			acc0 = _mm256_fmadd_ps(lo, _mm256_loadu_ps(x + j), acc0);
+			acc1 = _mm256_fmadd_ps(hi, _mm256_loadu_ps(x + j + 8), acc1);
+		}
+		__m256 acc = _mm256_add_ps(acc0, acc1);
+		__m128 s = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+		s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+		s = _mm_add_ss(s, _mm_movehdup_ps(s));
+		float total = _mm_cvtss_f32(s);
+		for (; j < k; ++j) {
+			total += static_cast<float>(q[j]) * x[j];
+		}
+		return total;
+	}
+#endif
+
+	dot_q8_fn select_dot_q8() {
+#if LLAISYS_X86_SIMD
+		const auto &f = llaisys::utils::cpu_features();
+		if (f.avx2 && f.fma) return dot_q8_avx2;
+#endif
+		return dot_q8_scalar;
+	}
+
+	// One Q4 row: sum over blocks of scale * dot(q, x) + min * sum(x); the per-block sums of x are
+	// precomputed once per activation row in `xsum`.
+	using dot_q4_fn = float (*)(const std::byte *row, const float *x, const float *xsum, size_t nblock, size_t group);
+
+	inline float load_half(const std::byte *p) {
+		llaisys::fp16_t h;
+		std::memcpy(&h, p, sizeof(h));
+		return llaisys::utils::cast<float>(h);
+	}
+
+	float dot_q4_scalar(const std::byte *row, const float *x, const float *xsum, size_t nblock, size_t group) {
+		const size_t half = group / 2;
+		float acc = 0.f;
+		for (size_t b = 0; b < nblock; ++b, row += 4 + half, x += group) {
+			const uint8_t *q = reinterpret_cast<const uint8_t *>(row + 4);
+			float d = 0.f;
+			for (size_t j = 0; j < half; ++j) {
+				d += static_cast<float>(q[j] & 0x0F) * x[j] + static_cast<float>(q[j] >> 4) * x[j + half];
+			}
+			acc += load_half(row) * d + load_half(row + 2) * xsum[b];
+		}
+		return acc;
+	}
+
+#if LLAISYS_X86_SIMD
+	// Nibbles are widened in registers; each block scale is folded into the vector accumulator
+	// so there is a single horizontal sum per row.
+	LLAISYS_TARGET("avx2,fma,f16c")
+	float dot_q4_avx2(const std::byte *row, const float *x, const float *xsum, size_t nblock, size_t group) {
+		const size_t half = group / 2;
+		const __m128i mask = _mm_set1_epi8(0x0F);
+		__m256 acc = _mm256_setzero_ps();
+		float min_acc = 0.f;
+		for (size_t b = 0; b < nblock; ++b, row += 4 + half, x += group) {
+			const uint8_t *q = reinterpret_cast<const uint8_t *>(row + 4);
+			__m256 d0 = _mm256_setzero_ps();
+			__m256 d1 = _mm256_setzero_ps();
+			for (size_t c = 0; c < half; c += 16) {
+				__m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(q + c));
+				__m128i lo = _mm_and_si128(bytes, mask);
+				__m128i hi = _mm_and_si128(_mm_srli_epi16(bytes, 4), mask);
+				d0 = _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(lo)), _mm256_loadu_ps(x + c), d0);
+				d1 = _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(lo, 8))),
+				                     _mm256_loadu_ps(x + c + 8), d1);
+				d0 = _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(hi)), _mm256_loadu_ps(x + half + c), d0);
+				d1 = _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(hi, 8))),
+				                     _mm256_loadu_ps(x + half + c + 8), d1);
+			}
+			uint16_t sm[2];
+			std::memcpy(sm, row, sizeof(sm));
+			acc = _mm256_fmadd_ps(_mm256_set1_ps(_cvtsh_ss(sm[0])), _mm256_add_ps(d0, d1), acc);
+			min_acc += _cvtsh_ss(sm[1]) * xsum[b];
+		}
+		__m128 s = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+		s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+		s = _mm_add_ss(s, _mm_movehdup_ps(s));
+		return _mm_cvtss_f32(s) + min_acc;
+	}
+#endif
+
+	dot_q4_fn select_dot_q4() {
+#if LLAISYS_X86_SIMD
+		const auto &f = llaisys::utils::cpu_features();
+		if (f.avx2 && f.fma && f.f16c) return dot_q4_avx2;
+#endif
+		return dot_q4_scalar;
+	}
+
+	template <typename T, typename E>
+	void linear_q4_impl(std::byte *out, const std::byte *in, const std::byte *weight, const E &epilogue,
+	                    llaisysDataType_t wtype, size_t m, size_t n, size_t k, ptrdiff_t out_stride,
+	                    ptrdiff_t in_stride) {
+		static const dot_q4_fn dot = select_dot_q4();
+		const T *in_ptr = reinterpret_cast<const T *>(in);
+		T *out_ptr = reinterpret_cast<T *>(out);
+		const size_t group = llaisys::utils::quant_group(wtype);
+		const size_t nblock = k / group;
+		const size_t row_bytes = llaisys::utils::row_bytes(wtype, k);
+
+		std::vector<float> x(m * k);
+		std::vector<float> xsum(m * nblock, 0.f);
+		for (size_t i = 0; i < m; ++i) {
+			const T *row = in_ptr + static_cast<ptrdiff_t>(i) * in_stride;
+			for (size_t j = 0; j < k; ++j) {
+				x[i * k + j] = llaisys::utils::cast<float>(row[j]);
+				xsum[i * nblock + j / group] += x[i * k + j];
+			}
+		}
+
+#pragma omp parallel for schedule(static)
+		for (ptrdiff_t o = 0; o < static_cast<ptrdiff_t>(n); ++o) {
+			const std::byte *row = weight + o * row_bytes;
+			for (size_t i = 0; i < m; ++i) {
+				float v = dot(row, x.data() + i * k, xsum.data() + i * nblock, nblock, group);
+				out_ptr[static_cast<ptrdiff_t>(i) * out_stride + o] =
+				    llaisys::utils::cast<T>(epilogue(v, i, static_cast<size_t>(o)));
+			}
+		}
+	}
+
+	// Decode is bandwidth bound on the weights, so each int8 row is streamed once and
+	// reused for all m activation rows while it sits in L1.
+	template <typename T, typename E>
+	void linear_q8_impl(std::byte *out, const std::byte *in, const std::byte *weight, const E &epilogue,
+	                    size_t m, size_t n, size_t k, ptrdiff_t out_stride, ptrdiff_t in_stride) {
+		static const dot_q8_fn dot = select_dot_q8();
+		const T *in_ptr = reinterpret_cast<const T *>(in);
+		T *out_ptr = reinterpret_cast<T *>(out);
+		const size_t row_bytes = llaisys::utils::row_bytes(LLAISYS_DTYPE_Q8, k);
+
+		std::vector<float> x(m * k);
+		for (size_t i = 0; i < m; ++i) {
+			const T *row = in_ptr + static_cast<ptrdiff_t>(i) * in_stride;
+			for (size_t j = 0; j < k; ++j) x[i * k + j] = llaisys::utils::cast<float>(row[j]);
+		}
+
+#pragma omp parallel for schedule(static)
+		for (ptrdiff_t o = 0; o < static_cast<ptrdiff_t>(n); ++o) {
+			const std::byte *row = weight + o * row_bytes;
+			float scale;
+			std::memcpy(&scale, row, sizeof(float));
+			const int8_t *q = reinterpret_cast<const int8_t *>(row + sizeof(float));
+			for (size_t i = 0; i < m; ++i) {
+				out_ptr[static_cast<ptrdiff_t>(i) * out_stride + o] =
+				    llaisys::utils::cast<T>(epilogue(dot(q, x.data() + i * k, k) * scale, i, static_cast<size_t>(o)));
+			}
+		}
+	}
+
+	template <typename T, typename E>
+	void linear_quant_impl(std::byte *out, const std::byte *in, const std::byte *weight, const E &epilogue,
+	                       llaisysDataType_t wtype, size_t m, size_t n, size_t k, ptrdiff_t out_stride,
+	                       ptrdiff_t in_stride) {
+		switch (wtype) {
+		case LLAISYS_DTYPE_Q8:
+			return linear_q8_impl<T>(out, in, weight, epilogue, m, n, k, out_stride, in_stride);
+		case LLAISYS_DTYPE_Q4_32:
+		case LLAISYS_DTYPE_Q4_64:
+			return linear_q4_impl<T>(out, in, weight, epilogue, wtype, m, n, k, out_stride, in_stride);
+		default:
+			EXCEPTION_UNSUPPORTED_DATATYPE(wtype);
+		}
+	}
+}
+
+namespace llaisys::ops::cpu {
+void linear_quant(std::byte *out, const std::byte *in, const std::byte *weight, const std::byte *bias,
+                  llaisysDataType_t type, llaisysDataType_t wtype, size_t m, size_t n, size_t k,
+                  ptrdiff_t out_stride, ptrdiff_t in_stride) {
+	elementwise::dispatch_float(type, [&](auto tag) {
+		using T = decltype(tag);
+		elementwise::Bias<T> epilogue{reinterpret_cast<const T *>(bias)};
+		linear_quant_impl<T>(out, in, weight, epilogue, wtype, m, n, k, out_stride, in_stride);
+	});
+}
+
+void linear_quant_add(std::byte *out, const std::byte *in, const std::byte *weight, const std::byte *bias,
+                      const std::byte *residual, llaisysDataType_t type, llaisysDataType_t wtype, size_t m,
+                      size_t n, size_t k, ptrdiff_t out_stride, ptrdiff_t in_stride, ptrdiff_t residual_stride) {
+	elementwise::dispatch_float(type, [&](auto tag) {
+		using T = decltype(tag);
+		elementwise::AddResidual<T, elementwise::Bias<T>> epilogue{
+		    {reinterpret_cast<const T *>(bias)}, reinterpret_cast<const T *>(residual), residual_stride};
+		linear_quant_impl<T>(out, in, weight, epilogue, wtype, m, n, k, out_stride, in_stride);
+	});
+}
+} // namespace llaisys::ops::cpu
@@ -2,6 +2,7 @@
 
 #include "../../core/llaisys_core.hpp"
 #include "../../utils.hpp"
+#include "../strides.hpp"
 
 #include "cpu/linear_cpu.hpp"
 
@@ -12,7 +13,13 @@ void linear(tensor_t out, tensor_t in, tensor_t weight, tensor_t bias) {
         CHECK_SAME_DEVICE(out, bias);
         CHECK_SAME_DTYPE(out->dtype(), bias->dtype());
     }
-    CHECK_SAME_DTYPE(out->dtype(), in->dtype(), weight->dtype());
+    // Quantized weights are dequantized inside the kernel; activations stay in out's dtype.
+    const bool quant_weight = utils::is_quantized(weight->dtype());
+    if (quant_weight) {
+        CHECK_SAME_DTYPE(out->dtype(), in->dtype());
+    } else {
+        CHECK_SAME_DTYPE(out->dtype(), in->dtype(), weight->dtype());
+    }
 
     ASSERT(out->ndim() == 2, "Linear: out must be 2D.");
     ASSERT(in->ndim() == 2, "Linear: input must be 2D.");
@@ -28,21 +35,31 @@ void linear(tensor_t out, tensor_t in, tensor_t weight, tensor_t bias) {
         ASSERT(bias->ndim() == 1 && bias->shape()[0] == n, "Linear: bias must be 1D with length out_features.");
     }
 
-    ASSERT(out->isContiguous() && in->isContiguous() && weight->isContiguous()
-               && (!bias || bias->isContiguous()),
-           "Linear: all tensors must be contiguous.");
+    // activation rows may be strided (slices, interleaved outputs); weight and bias are dense
+    const ptrdiff_t out_stride = row_stride(*out);
+    const ptrdiff_t in_stride = row_stride(*in);
+    ASSERT(out_stride != 0 && in_stride != 0, "Linear: in/out rows must be contiguous.");
+    ASSERT(weight->isContiguous() && (!bias || bias->isContiguous()), "Linear: weight and bias must be contiguous.");
 
+    if (out->deviceType() == LLAISYS_DEVICE_CPU && quant_weight) {
+        return cpu::linear_quant(out->data(), in->data(), weight->data(), bias ? bias->data() : nullptr,
+                                 out->dtype(), weight->dtype(), m, n, k, out_stride, in_stride);
+    }
     if (out->deviceType() == LLAISYS_DEVICE_CPU) {
         return cpu::linear(out->data(), in->data(), weight->data(), bias ? bias->data() : nullptr,
-                           out->dtype(), m, n, k);
+                           out->dtype(), m, n, k, out_stride, in_stride);
     }
 
     llaisys::core::context().setDevice(out->deviceType(), out->deviceId());
 
     switch (out->deviceType()) {
     case LLAISYS_DEVICE_CPU:
+        if (quant_weight) {
+            return cpu::linear_quant(out->data(), in->data(), weight->data(), bias ? bias->data() : nullptr,
+                                     out->dtype(), weight->dtype(), m, n, k, out_stride, in_stride);
+        }
         return cpu::linear(out->data(), in->data(), weight->data(), bias ? bias->data() : nullptr,
-                           out->dtype(), m, n, k);
+                           out->dtype(), m, n, k, out_stride, in_stride);
 #ifdef ENABLE_NVIDIA_API
     case LLAISYS_DEVICE_NVIDIA:
         TO_BE_IMPLEMENTED();
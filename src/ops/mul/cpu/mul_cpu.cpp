@@ -0,0 +1,10 @@
+#include "mul_cpu.hpp"
+
+#include "../../elementwise.hpp"
+
+namespace llaisys::ops::cpu {
+    void mul(std::byte *c, const std::byte *a, const std::byte *b, llaisysDataType_t type, size_t rows, size_t cols,
+             MatStrides c_strides, MatStrides a_strides, MatStrides b_strides) {
+        elementwise::binary<elementwise::Mul>(c, a, b, type, rows, cols, c_strides, a_strides, b_strides);
+    }
+} // namespace llaisys::ops::cpu
@@ -0,0 +1,13 @@
+#pragma once
+#include "llaisys.h"
+
+#include "../../strides.hpp"
+
+#include <cstddef>
+
+namespace llaisys::ops::cpu {
+    // c/a/b are [rows, cols] blocks with their own row/col strides (in elements); a stride of 0
+    // broadcasts a/b along that dim. c may be a or b for an in-place multiply.
+    void mul(std::byte *c, const std::byte *a, const std::byte *b, llaisysDataType_t type, size_t rows, size_t cols,
+             MatStrides c_strides, MatStrides a_strides, MatStrides b_strides);
+}
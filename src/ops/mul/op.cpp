@@ -0,0 +1,11 @@
+#include "op.hpp"
+
+#include "../binary.hpp"
+
+#include "cpu/mul_cpu.hpp"
+
+namespace llaisys::ops {
+void mul(tensor_t c, tensor_t a, tensor_t b) {
+    binary_op("Mul", c, a, b, cpu::mul);
+}
+} // namespace llaisys::ops
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "../../tensor/tensor.hpp"
+
+namespace llaisys::ops {
+// c = a * b with NumPy broadcasting of a and b to c's shape. c may be a or b (same layout) to
+// multiply in place.
+void mul(tensor_t c, tensor_t a, tensor_t b);
+}
@@ -0,0 +1,104 @@
+#include "quantize_cpu.hpp"
+
+#include "../../../utils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+	// Symmetric per-row int8: scale = absmax / 127, q = round(x / scale).
+	template <typename T>
+	void quantize_q8_impl(std::byte *out, const std::byte *in, size_t rows, size_t cols) {
+		const T *in_ptr = reinterpret_cast<const T *>(in);
+		const size_t row_bytes = llaisys::utils::row_bytes(LLAISYS_DTYPE_Q8, cols);
+
+#pragma omp parallel for schedule(static)
+		for (ptrdiff_t r = 0; r < static_cast<ptrdiff_t>(rows); ++r) {
+			const T *x = in_ptr + r * cols;
+			std::byte *row = out + r * row_bytes;
+			int8_t *q = reinterpret_cast<int8_t *>(row + sizeof(float));
+
+			float amax = 0.f;
+			for (size_t j = 0; j < cols; ++j) {
+				amax = std::max(amax, std::fabs(llaisys::utils::cast<float>(x[j])));
+			}
+			float scale = amax / 127.f;
+			std::memcpy(row, &scale, sizeof(float));
+			for (size_t j = 0; j < cols; ++j) {
+				float v = scale > 0.f ? std::nearbyint(llaisys::utils::cast<float>(x[j]) / scale) : 0.f;
+				q[j] = static_cast<int8_t>(std::min(127.f, std::max(-127.f, v)));
+			}
+		}
+	}
+
+	// Asymmetric 4-bit per group of G: scale = (max - min) / 15, q = round((x - min) / scale).
+	// scale/min are rounded to fp16 before q is computed so the stored block decodes consistently.
+	template <typename T, size_t G>
+	void quantize_q4_impl(std::byte *out, const std::byte *in, llaisysDataType_t qtype, size_t rows, size_t cols) {
+		const T *in_ptr = reinterpret_cast<const T *>(in);
+		const size_t row_bytes = llaisys::utils::row_bytes(qtype, cols);
+		const size_t block_bytes = 2 * sizeof(llaisys::fp16_t) + G / 2;
+
+#pragma omp parallel for schedule(static)
+		for (ptrdiff_t r = 0; r < static_cast<ptrdiff_t>(rows); ++r) {
+			for (size_t g = 0; g < cols / G; ++g) {
+				const T *x = in_ptr + r * cols + g * G;
+				std::byte *block = out + r * row_bytes + g * block_bytes;
+				uint8_t *q = reinterpret_cast<uint8_t *>(block + 2 * sizeof(llaisys::fp16_t));
+
+				float v[G];
+				float lo = INFINITY, hi = -INFINITY;
+				for (size_t j = 0; j < G; ++j) {
+					v[j] = llaisys::utils::cast<float>(x[j]);
+					lo = std::min(lo, v[j]);
+					hi = std::max(hi, v[j]);
+				}
+				llaisys::fp16_t scale_h = llaisys::utils::cast<llaisys::fp16_t>((hi - lo) / 15.f);
+				llaisys::fp16_t min_h = llaisys::utils::cast<llaisys::fp16_t>(lo);
+				std::memcpy(block, &scale_h, sizeof(scale_h));
+				std::memcpy(block + sizeof(scale_h), &min_h, sizeof(min_h));
+
+				float scale = llaisys::utils::cast<float>(scale_h);
+				float min = llaisys::utils::cast<float>(min_h);
+				float inv = scale > 0.f ? 1.f / scale : 0.f;
+				auto code = [&](float val) {
+					return static_cast<uint8_t>(std::min(15.f, std::max(0.f, std::nearbyint((val - min) * inv))));
+				};
+				for (size_t j = 0; j < G / 2; ++j) {
+					q[j] = static_cast<uint8_t>(code(v[j]) | (code(v[j + G / 2]) << 4));
+				}
+			}
+		}
+	}
+
+	template <typename T>
+	void quantize_impl(std::byte *out, const std::byte *in, llaisysDataType_t qtype, size_t rows, size_t cols) {
+		switch (qtype) {
+		case LLAISYS_DTYPE_Q8:
+			return quantize_q8_impl<T>(out, in, rows, cols);
+		case LLAISYS_DTYPE_Q4_32:
+			return quantize_q4_impl<T, 32>(out, in, qtype, rows, cols);
+		case LLAISYS_DTYPE_Q4_64:
+			return quantize_q4_impl<T, 64>(out, in, qtype, rows, cols);
+		default:
+			EXCEPTION_UNSUPPORTED_DATATYPE(qtype);
+		}
+	}
+}
+
+namespace llaisys::ops::cpu {
+void quantize(std::byte *out, const std::byte *in, llaisysDataType_t qtype, llaisysDataType_t type,
+              size_t rows, size_t cols) {
+	switch (type) {
+	case LLAISYS_DTYPE_F32:
+		return quantize_impl<float>(out, in, qtype, rows, cols);
+	case LLAISYS_DTYPE_BF16:
+		return quantize_impl<llaisys::bf16_t>(out, in, qtype, rows, cols);
+	case LLAISYS_DTYPE_F16:
+		return quantize_impl<llaisys::fp16_t>(out, in, qtype, rows, cols);
+	default:
+		EXCEPTION_UNSUPPORTED_DATATYPE(type);
+	}
+}
+} // namespace llaisys::ops::cpu
@@ -0,0 +1,9 @@
+#pragma once
+#include "llaisys.h"
+
+#include <cstddef>
+
+namespace llaisys::ops::cpu {
+void quantize(std::byte *out, const std::byte *in, llaisysDataType_t qtype, llaisysDataType_t type,
+              size_t rows, size_t cols);
+}
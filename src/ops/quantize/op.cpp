@@ -0,0 +1,37 @@
+#include "op.hpp"
+
+#include "../../core/llaisys_core.hpp"
+#include "../../utils.hpp"
+
+#include "cpu/quantize_cpu.hpp"
+
+namespace llaisys::ops {
+void quantize(tensor_t out, tensor_t in) {
+    CHECK_SAME_DEVICE(out, in);
+    ASSERT(utils::is_quantized(out->dtype()), "Quantize: out must have a quantized dtype.");
+    ASSERT(!utils::is_quantized(in->dtype()), "Quantize: input must not be quantized.");
+    ASSERT(in->ndim() >= 1 && out->shape() == in->shape(), "Quantize: shapes must match.");
+    ASSERT(out->isContiguous() && in->isContiguous(), "Quantize: tensors must be contiguous.");
+
+    size_t cols = in->shape().back();
+    size_t rows = in->numel() / cols;
+
+    if (out->deviceType() == LLAISYS_DEVICE_CPU) {
+        return cpu::quantize(out->data(), in->data(), out->dtype(), in->dtype(), rows, cols);
+    }
+
+    llaisys::core::context().setDevice(out->deviceType(), out->deviceId());
+
+    switch (out->deviceType()) {
+    case LLAISYS_DEVICE_CPU:
+        return cpu::quantize(out->data(), in->data(), out->dtype(), in->dtype(), rows, cols);
+#ifdef ENABLE_NVIDIA_API
+    case LLAISYS_DEVICE_NVIDIA:
+        TO_BE_IMPLEMENTED();
+        return;
+#endif
+    default:
+        EXCEPTION_UNSUPPORTED_DEVICE;
+    }
+}
+} // namespace llaisys::ops
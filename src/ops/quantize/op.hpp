@@ -0,0 +1,8 @@
+#pragma once
+
+#include "../../tensor/tensor.hpp"
+
+namespace llaisys::ops {
+// Quantize a floating point tensor row by row (last dim) into a quantized dtype.
+void quantize(tensor_t out, tensor_t in);
+}
@@ -1,36 +1,241 @@
 #include "rearrange_cpu.hpp"
 
+#include "../../../utils.hpp"
+#include "../../../utils/cpu_features.hpp"
+
+#include <algorithm>
+#include <cstdint>
 #include <cstring>
+#include <type_traits>
 
 namespace {
-void rearrange_recursive(std::byte *out,
-                         const std::byte *in,
-                         const std::vector<size_t> &shape,
-                         const std::vector<ptrdiff_t> &out_strides,
-                         const std::vector<ptrdiff_t> &in_strides,
-                         size_t elem_size,
-                         size_t dim,
-                         ptrdiff_t out_off,
-                         ptrdiff_t in_off) {
-    if (dim == shape.size()) {
-        std::memcpy(out + out_off * elem_size, in + in_off * elem_size, elem_size);
-        return;
+constexpr size_t kMaxDims = 16;
+// Below this many bytes a copy is not worth waking the OpenMP team.
+constexpr size_t kParallelBytes = size_t(1) << 16;
+// Transposes go tile by tile so both the strided reads and the strided writes stay in L1.
+constexpr size_t kTile = 32;
+
+// Shape and strides with size-1 dims dropped and mergeable neighbours fused, so that a
+// contiguous copy becomes one run and a permuted copy keeps only the dims that really move.
+struct Layout {
+    size_t ndim = 0;
+    size_t shape[kMaxDims];
+    ptrdiff_t os[kMaxDims];
+    ptrdiff_t is[kMaxDims];
+};
+
+// Returns false if there is nothing to copy (some dim is 0).
+bool normalize(Layout &l, const size_t *shape, const ptrdiff_t *os, const ptrdiff_t *is, size_t ndim) {
+    ASSERT(ndim <= kMaxDims, "rearrange: too many dims");
+    for (size_t d = 0; d < ndim; ++d) {
+        if (shape[d] == 0) return false;
+        if (shape[d] == 1) continue;
+        if (l.ndim > 0) {
+            const size_t p = l.ndim - 1;
+            const auto n = static_cast<ptrdiff_t>(shape[d]);
+            if (l.os[p] == os[d] * n && l.is[p] == is[d] * n) {
+                l.shape[p] *= shape[d];
+                l.os[p] = os[d];
+                l.is[p] = is[d];
+                continue;
+            }
+        }
+        l.shape[l.ndim] = shape[d];
+        l.os[l.ndim] = os[d];
+        l.is[l.ndim] = is[d];
+        ++l.ndim;
+    }
+    return true;
+}
+
+// Removes dim `d` from the layout and returns its (shape, out stride, in stride).
+void take_dim(Layout &l, size_t d, size_t &n, ptrdiff_t &os, ptrdiff_t &is) {
+    n = l.shape[d];
+    os = l.os[d];
+    is = l.is[d];
+    for (size_t i = d + 1; i < l.ndim; ++i) {
+        l.shape[i - 1] = l.shape[i];
+        l.os[i - 1] = l.os[i];
+        l.is[i - 1] = l.is[i];
+    }
+    --l.ndim;
+}
+
+size_t outer_count(const Layout &l) {
+    size_t n = 1;
+    for (size_t d = 0; d < l.ndim; ++d) n *= l.shape[d];
+    return n;
+}
+
+// Element offsets (out, in) of flat index `n` over the remaining dims.
+void outer_offsets(const Layout &l, size_t n, ptrdiff_t &o, ptrdiff_t &i) {
+    o = 0;
+    i = 0;
+    for (size_t d = l.ndim; d-- > 0;) {
+        const auto k = static_cast<ptrdiff_t>(n % l.shape[d]);
+        n /= l.shape[d];
+        o += k * l.os[d];
+        i += k * l.is[d];
     }
+}
 
-    const size_t len = shape[dim];
-    const ptrdiff_t os = out_strides[dim];
-    const ptrdiff_t is = in_strides[dim];
+template <size_t N>
+struct Elem {
+    unsigned char b[N];
+};
+template <size_t N>
+using elem_t = std::conditional_t<N == 1, uint8_t,
+               std::conditional_t<N == 2, uint16_t,
+               std::conditional_t<N == 4, uint32_t,
+               std::conditional_t<N == 8, uint64_t, Elem<N>>>>>;
+
+#if LLAISYS_X86_SIMD
+// 8x8 block of 16-bit elements: three rounds of unpacks (SSE2, always available on x86-64).
+LLAISYS_TARGET("sse2")
+void transpose8x8_16(uint16_t *out, ptrdiff_t ld_out, const uint16_t *in, ptrdiff_t ld_in) {
+    __m128i r[8];
+    for (int k = 0; k < 8; ++k) r[k] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + k * ld_in));
+    __m128i t[8];
+    for (int k = 0; k < 4; ++k) {
+        t[2 * k] = _mm_unpacklo_epi16(r[2 * k], r[2 * k + 1]);
+        t[2 * k + 1] = _mm_unpackhi_epi16(r[2 * k], r[2 * k + 1]);
+    }
+    __m128i u[8];
+    u[0] = _mm_unpacklo_epi32(t[0], t[2]);
+    u[1] = _mm_unpackhi_epi32(t[0], t[2]);
+    u[2] = _mm_unpacklo_epi32(t[1], t[3]);
+    u[3] = _mm_unpackhi_epi32(t[1], t[3]);
+    u[4] = _mm_unpacklo_epi32(t[4], t[6]);
+    u[5] = _mm_unpackhi_epi32(t[4], t[6]);
+    u[6] = _mm_unpacklo_epi32(t[5], t[7]);
+    u[7] = _mm_unpackhi_epi32(t[5], t[7]);
+    for (int k = 0; k < 4; ++k) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + (2 * k) * ld_out), _mm_unpacklo_epi64(u[k], u[k + 4]));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + (2 * k + 1) * ld_out), _mm_unpackhi_epi64(u[k], u[k + 4]));
+    }
+}
 
-    for (size_t i = 0; i < len; ++i) {
-        rearrange_recursive(out,
-                            in,
-                            shape,
-                            out_strides,
-                            in_strides,
-                            elem_size,
-                            dim + 1,
-                            out_off + static_cast<ptrdiff_t>(i) * os,
-                            in_off + static_cast<ptrdiff_t>(i) * is);
+// 8x8 block of 32-bit elements; only moves bits, so floats and ints alike.
+LLAISYS_TARGET("avx2")
+void transpose8x8_32(uint32_t *out, ptrdiff_t ld_out, const uint32_t *in, ptrdiff_t ld_in) {
+    __m256 r[8];
+    for (int k = 0; k < 8; ++k) r[k] = _mm256_loadu_ps(reinterpret_cast<const float *>(in + k * ld_in));
+    __m256 t[8];
+    for (int k = 0; k < 4; ++k) {
+        t[2 * k] = _mm256_unpacklo_ps(r[2 * k], r[2 * k + 1]);
+        t[2 * k + 1] = _mm256_unpackhi_ps(r[2 * k], r[2 * k + 1]);
+    }
+    __m256 s[8];
+    s[0] = _mm256_shuffle_ps(t[0], t[2], 0x44);
+    s[1] = _mm256_shuffle_ps(t[0], t[2], 0xEE);
+    s[2] = _mm256_shuffle_ps(t[1], t[3], 0x44);
+    s[3] = _mm256_shuffle_ps(t[1], t[3], 0xEE);
+    s[4] = _mm256_shuffle_ps(t[4], t[6], 0x44);
+    s[5] = _mm256_shuffle_ps(t[4], t[6], 0xEE);
+    s[6] = _mm256_shuffle_ps(t[5], t[7], 0x44);
+    s[7] = _mm256_shuffle_ps(t[5], t[7], 0xEE);
+    for (int k = 0; k < 4; ++k) {
+        _mm256_storeu_ps(reinterpret_cast<float *>(out + k * ld_out), _mm256_permute2f128_ps(s[k], s[k + 4], 0x20));
+        _mm256_storeu_ps(reinterpret_cast<float *>(out + (k + 4) * ld_out), _mm256_permute2f128_ps(s[k], s[k + 4], 0x31));
+    }
+}
+#endif
+
+// out[j * ld_out + i] = in[i * ld_in + j] for i < rows, j < cols.
+template <typename T>
+void transpose_tile(T *out, ptrdiff_t ld_out, const T *in, ptrdiff_t ld_in, size_t rows, size_t cols, bool simd) {
+    size_t i0 = 0;
+#if LLAISYS_X86_SIMD
+    if constexpr (sizeof(T) == 2 || sizeof(T) == 4) {
+        if (simd) {
+            for (; i0 + 8 <= rows; i0 += 8) {
+                size_t j = 0;
+                for (; j + 8 <= cols; j += 8) {
+                    if constexpr (sizeof(T) == 2) {
+                        transpose8x8_16(out + j * ld_out + i0, ld_out, in + i0 * ld_in + j, ld_in);
+                    } else {
+                        transpose8x8_32(out + j * ld_out + i0, ld_out, in + i0 * ld_in + j, ld_in);
+                    }
+                }
+                for (; j < cols; ++j) {
+                    for (size_t i = i0; i < i0 + 8; ++i) out[j * ld_out + i] = in[i * ld_in + j];
+                }
+            }
+        }
+    }
+#else
+    (void)simd;
+#endif
+    for (size_t j = 0; j < cols; ++j) {
+        for (size_t i = i0; i < rows; ++i) out[j * ld_out + i] = in[i * ld_in + j];
+    }
+}
+
+template <size_t N>
+void copy_strided(std::byte *out, const std::byte *in, Layout l) {
+    using T = elem_t<N>;
+    T *dst = reinterpret_cast<T *>(out);
+    const T *src = reinterpret_cast<const T *>(in);
+
+    // Unit-stride dims on each side; if they differ the copy is a transpose between them.
+    size_t out_unit = l.ndim;
+    size_t in_unit = l.ndim;
+    for (size_t d = 0; d < l.ndim; ++d) {
+        if (l.os[d] == 1 && out_unit == l.ndim) out_unit = d;
+        if (l.is[d] == 1 && in_unit == l.ndim) in_unit = d;
+    }
+
+    if (out_unit != l.ndim && in_unit != l.ndim && out_unit != in_unit) {
+        size_t na, nb;
+        ptrdiff_t osa, isa, osb, isb;
+        // take the higher index first so the lower one stays put
+        if (out_unit > in_unit) {
+            take_dim(l, out_unit, na, osa, isa);
+            take_dim(l, in_unit, nb, osb, isb);
+        } else {
+            take_dim(l, in_unit, nb, osb, isb);
+            take_dim(l, out_unit, na, osa, isa);
+        }
+        // out is contiguous along a, in along b: in viewed as [na, nb] with row stride isa
+        const bool simd =
+#if LLAISYS_X86_SIMD
+            sizeof(T) == 2 || (sizeof(T) == 4 && llaisys::utils::cpu_features().avx2);
+#else
+            false;
+#endif
+        const size_t outer = outer_count(l);
+        const size_t ta = (na + kTile - 1) / kTile;
+        const size_t tb = (nb + kTile - 1) / kTile;
+        const size_t tasks = outer * ta * tb;
+        const bool parallel = outer * na * nb * N >= kParallelBytes;
+#pragma omp parallel for schedule(static) if (parallel)
+        for (ptrdiff_t t = 0; t < static_cast<ptrdiff_t>(tasks); ++t) {
+            const size_t bt = static_cast<size_t>(t) % tb;
+            const size_t at = static_cast<size_t>(t) / tb % ta;
+            ptrdiff_t o, i;
+            outer_offsets(l, static_cast<size_t>(t) / tb / ta, o, i);
+            const size_t a0 = at * kTile;
+            const size_t b0 = bt * kTile;
+            transpose_tile(dst + o + static_cast<ptrdiff_t>(a0) + static_cast<ptrdiff_t>(b0) * osb, osb,
+                           src + i + static_cast<ptrdiff_t>(a0) * isa + static_cast<ptrdiff_t>(b0), isa,
+                           std::min(kTile, na - a0), std::min(kTile, nb - b0), simd);
+        }
+        return;
+    }
+
+    // Otherwise walk the innermost dim as a strided loop (a unit stride on both sides only
+    // survives normalization as the last dim, and is handled by the memcpy path).
+    size_t n;
+    ptrdiff_t os, is;
+    take_dim(l, l.ndim - 1, n, os, is);
+    const size_t outer = outer_count(l);
+#pragma omp parallel for schedule(static) if (outer * n * N >= kParallelBytes)
+    for (ptrdiff_t r = 0; r < static_cast<ptrdiff_t>(outer); ++r) {
+        ptrdiff_t o, i;
+        outer_offsets(l, static_cast<size_t>(r), o, i);
+        T *d = dst + o;
+        const T *s = src + i;
+        for (size_t k = 0; k < n; ++k) d[static_cast<ptrdiff_t>(k) * os] = s[static_cast<ptrdiff_t>(k) * is];
     }
 }
 } // namespace
@@ -38,10 +243,56 @@ void rearrange_recursive(std::byte *out,
 namespace llaisys::ops::cpu {
 void rearrange(std::byte *out,
                const std::byte *in,
-               const std::vector<size_t> &shape,
-               const std::vector<ptrdiff_t> &out_strides,
-               const std::vector<ptrdiff_t> &in_strides,
+               const size_t *shape,
+               const ptrdiff_t *out_strides,
+               const ptrdiff_t *in_strides,
+               size_t ndim,
                size_t elem_size) {
-    rearrange_recursive(out, in, shape, out_strides, in_strides, elem_size, 0, 0, 0);
+    Layout l;
+    if (!normalize(l, shape, out_strides, in_strides, ndim)) return;
+    if (l.ndim == 0) {
+        std::memcpy(out, in, elem_size);
+        return;
+    }
+
+    // Contiguous innermost run on both sides: bulk memcpy per run.
+    if (l.os[l.ndim - 1] == 1 && l.is[l.ndim - 1] == 1) {
+        size_t n;
+        ptrdiff_t os, is;
+        take_dim(l, l.ndim - 1, n, os, is);
+        const size_t run = n * elem_size;
+        const size_t outer = outer_count(l);
+        const auto es = static_cast<ptrdiff_t>(elem_size);
+#pragma omp parallel for schedule(static) if (outer > 1 && outer * run >= kParallelBytes)
+        for (ptrdiff_t r = 0; r < static_cast<ptrdiff_t>(outer); ++r) {
+            ptrdiff_t o, i;
+            outer_offsets(l, static_cast<size_t>(r), o, i);
+            std::memcpy(out + o * es, in + i * es, run);
+        }
+        return;
+    }
+
+    switch (elem_size) {
+    case 1:
+        return copy_strided<1>(out, in, l);
+    case 2:
+        return copy_strided<2>(out, in, l);
+    case 4:
+        return copy_strided<4>(out, in, l);
+    case 8:
+        return copy_strided<8>(out, in, l);
+    case 16:
+        return copy_strided<16>(out, in, l);
+    default:
+        break;
+    }
+    // Odd element sizes: per-element memcpy over the normalized layout.
+    const size_t outer = outer_count(l);
+    const auto es = static_cast<ptrdiff_t>(elem_size);
+    for (size_t r = 0; r < outer; ++r) {
+        ptrdiff_t o, i;
+        outer_offsets(l, r, o, i);
+        std::memcpy(out + o * es, in + i * es, elem_size);
+    }
 }
 } // namespace llaisys::ops::cpu
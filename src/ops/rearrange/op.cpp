@@ -16,14 +16,16 @@ void rearrange(tensor_t out, tensor_t in) {
     const auto &in_strides = in->strides();
 
     if (out->deviceType() == LLAISYS_DEVICE_CPU) {
-        return cpu::rearrange(out->data(), in->data(), shape, out_strides, in_strides, elem_size);
+        return cpu::rearrange(out->data(), in->data(), shape.data(), out_strides.data(), in_strides.data(), shape.size(),
+                              elem_size);
     }
 
     llaisys::core::context().setDevice(out->deviceType(), out->deviceId());
 
     switch (out->deviceType()) {
     case LLAISYS_DEVICE_CPU:
-        return cpu::rearrange(out->data(), in->data(), shape, out_strides, in_strides, elem_size);
+        return cpu::rearrange(out->data(), in->data(), shape.data(), out_strides.data(), in_strides.data(), shape.size(),
+                              elem_size);
 #ifdef ENABLE_NVIDIA_API
     case LLAISYS_DEVICE_NVIDIA:
         TO_BE_IMPLEMENTED();
@@ -7,14 +7,14 @@
 namespace {
 	template <typename T>
 	void rms_norm_impl(std::byte *out, const std::byte *in, const std::byte *weight, size_t rows, size_t cols,
-	                  float eps) {
+	                  float eps, ptrdiff_t out_stride, ptrdiff_t in_stride) {
 		const T *in_ptr = reinterpret_cast<const T *>(in);
 		const T *w_ptr = reinterpret_cast<const T *>(weight);
 		T *out_ptr = reinterpret_cast<T *>(out);
 
 		for (size_t i = 0; i < rows; ++i) {
-			const T *row_in = in_ptr + i * cols;
-			T *row_out = out_ptr + i * cols;
+			const T *row_in = in_ptr + static_cast<ptrdiff_t>(i) * in_stride;
+			T *row_out = out_ptr + static_cast<ptrdiff_t>(i) * out_stride;
 
 			float sum_sq = 0.f;
 			for (size_t j = 0; j < cols; ++j) {
@@ -35,14 +35,14 @@ namespace {
 
 namespace llaisys::ops::cpu {
 void rms_norm(std::byte *out, const std::byte *in, const std::byte *weight, llaisysDataType_t type,
-              size_t rows, size_t cols, float eps) {
+              size_t rows, size_t cols, float eps, ptrdiff_t out_stride, ptrdiff_t in_stride) {
 	switch (type) {
 	case LLAISYS_DTYPE_F32:
-		return rms_norm_impl<float>(out, in, weight, rows, cols, eps);
+		return rms_norm_impl<float>(out, in, weight, rows, cols, eps, out_stride, in_stride);
 	case LLAISYS_DTYPE_BF16:
-		return rms_norm_impl<llaisys::bf16_t>(out, in, weight, rows, cols, eps);
+		return rms_norm_impl<llaisys::bf16_t>(out, in, weight, rows, cols, eps, out_stride, in_stride);
 	case LLAISYS_DTYPE_F16:
-		return rms_norm_impl<llaisys::fp16_t>(out, in, weight, rows, cols, eps);
+		return rms_norm_impl<llaisys::fp16_t>(out, in, weight, rows, cols, eps, out_stride, in_stride);
 	default:
 		EXCEPTION_UNSUPPORTED_DATATYPE(type);
 	}
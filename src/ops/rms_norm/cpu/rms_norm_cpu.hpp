@@ -4,6 +4,7 @@
 #include <cstddef>
 
 namespace llaisys::ops::cpu {
+// out/in rows are `out_stride` / `in_stride` elements apart.
 void rms_norm(std::byte *out, const std::byte *in, const std::byte *weight, llaisysDataType_t type,
-              size_t rows, size_t cols, float eps);
+              size_t rows, size_t cols, float eps, ptrdiff_t out_stride, ptrdiff_t in_stride);
 }
@@ -2,6 +2,7 @@
 
 #include "../../core/llaisys_core.hpp"
 #include "../../utils.hpp"
+#include "../strides.hpp"
 
 #include "cpu/rms_norm_cpu.hpp"
 
@@ -19,18 +20,23 @@ void rms_norm(tensor_t out, tensor_t in, tensor_t weight, float eps) {
     ASSERT(out->shape()[0] == rows && out->shape()[1] == cols, "RMSNorm: output shape mismatch.");
     ASSERT(weight->shape()[0] == cols, "RMSNorm: weight length must match input last dim.");
 
-    ASSERT(out->isContiguous() && in->isContiguous() && weight->isContiguous(),
-           "RMSNorm: tensors must be contiguous.");
+    // rows may be strided (e.g. a slice of a wider buffer), each row itself must be contiguous
+    const ptrdiff_t out_stride = row_stride(*out);
+    const ptrdiff_t in_stride = row_stride(*in);
+    ASSERT(out_stride != 0 && in_stride != 0 && weight->isContiguous(),
+           "RMSNorm: rows and weight must be contiguous.");
 
     if (out->deviceType() == LLAISYS_DEVICE_CPU) {
-        return cpu::rms_norm(out->data(), in->data(), weight->data(), out->dtype(), rows, cols, eps);
+        return cpu::rms_norm(out->data(), in->data(), weight->data(), out->dtype(), rows, cols, eps, out_stride,
+                             in_stride);
     }
 
     llaisys::core::context().setDevice(out->deviceType(), out->deviceId());
 
     switch (out->deviceType()) {
     case LLAISYS_DEVICE_CPU:
-        return cpu::rms_norm(out->data(), in->data(), weight->data(), out->dtype(), rows, cols, eps);
+        return cpu::rms_norm(out->data(), in->data(), weight->data(), out->dtype(), rows, cols, eps, out_stride,
+                             in_stride);
 #ifdef ENABLE_NVIDIA_API
     case LLAISYS_DEVICE_NVIDIA:
         TO_BE_IMPLEMENTED();
@@ -1,9 +1,12 @@
 #pragma once
 #include "llaisys.h"
 
+#include "../../strides.hpp"
+
 #include <cstddef>
 
 namespace llaisys::ops::cpu {
+// out/in are [seqlen, nhead, dim] with arbitrary seq/head strides.
 void rope(std::byte *out, const std::byte *in, const std::byte *pos_ids, llaisysDataType_t type,
-          size_t seqlen, size_t nhead, size_t dim, float theta);
+          size_t seqlen, size_t nhead, size_t dim, float theta, HeadStrides out_strides, HeadStrides in_strides);
 }
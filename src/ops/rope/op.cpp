@@ -25,17 +25,22 @@ void rope(tensor_t out, tensor_t in, tensor_t pos_ids, float theta) {
            "ROPE: output shape mismatch.");
     ASSERT(pos_ids->shape()[0] == seqlen, "ROPE: pos_ids length must equal seqlen.");
 
-    ASSERT(out->isContiguous() && in->isContiguous() && pos_ids->isContiguous(), "ROPE: tensors must be contiguous.");
+    // heads may sit at any seq/head stride (e.g. inside a fused QKV row); head_dim must be contiguous
+    const HeadStrides out_strides = head_strides(*out);
+    const HeadStrides in_strides = head_strides(*in);
+    ASSERT(pos_ids->isContiguous(), "ROPE: pos_ids must be contiguous.");
 
     if (out->deviceType() == LLAISYS_DEVICE_CPU) {
-        return cpu::rope(out->data(), in->data(), pos_ids->data(), out->dtype(), seqlen, nhead, dim, theta);
+        return cpu::rope(out->data(), in->data(), pos_ids->data(), out->dtype(), seqlen, nhead, dim, theta,
+                         out_strides, in_strides);
     }
 
     llaisys::core::context().setDevice(out->deviceType(), out->deviceId());
 
     switch (out->deviceType()) {
     case LLAISYS_DEVICE_CPU:
-        return cpu::rope(out->data(), in->data(), pos_ids->data(), out->dtype(), seqlen, nhead, dim, theta);
+        return cpu::rope(out->data(), in->data(), pos_ids->data(), out->dtype(), seqlen, nhead, dim, theta,
+                         out_strides, in_strides);
 #ifdef ENABLE_NVIDIA_API
     case LLAISYS_DEVICE_NVIDIA:
         TO_BE_IMPLEMENTED();
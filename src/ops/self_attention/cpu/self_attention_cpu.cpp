@@ -10,21 +10,14 @@
 namespace {
 	template <typename T>
 	void self_attn_impl(std::byte *out, const std::byte *q, const std::byte *k, const std::byte *v,
-	                   size_t qlen, size_t kvlen, size_t nhead, size_t nkvh, size_t dim, size_t dv, float scale) {
+	                   size_t qlen, size_t kvlen, size_t nhead, size_t nkvh, size_t dim, size_t dv, float scale,
+	                   llaisys::ops::HeadStrides os, llaisys::ops::HeadStrides qs, llaisys::ops::HeadStrides ks,
+	                   llaisys::ops::HeadStrides vs) {
 		const T *q_ptr = reinterpret_cast<const T *>(q);
 		const T *k_ptr = reinterpret_cast<const T *>(k);
 		const T *v_ptr = reinterpret_cast<const T *>(v);
 		T *out_ptr = reinterpret_cast<T *>(out);
 
-		const size_t q_head_stride = dim;
-		const size_t k_head_stride = dim;
-		const size_t v_head_stride = dv;
-		const size_t q_seq_stride = nhead * dim;
-		const size_t k_seq_stride = nkvh * dim;
-		const size_t v_seq_stride = nkvh * dv;
-		const size_t out_head_stride = dv;
-		const size_t out_seq_stride = nhead * dv;
-
 		const int head_factor = static_cast<int>(nhead / nkvh);
 
 		std::vector<float> logits(kvlen);
@@ -32,10 +25,11 @@ namespace {
 
 		for (size_t s = 0; s < qlen; ++s) {
 			for (size_t h = 0; h < nhead; ++h) {
-				const T *q_vec = q_ptr + s * q_seq_stride + h * q_head_stride;
-				int kh = static_cast<int>(h / head_factor);
-				const T *k_base = k_ptr + kh * k_head_stride;
-				const T *v_base = v_ptr + kh * v_head_stride;
+				const auto si = static_cast<ptrdiff_t>(s), hi = static_cast<ptrdiff_t>(h);
+				const T *q_vec = q_ptr + si * qs.seq + hi * qs.head;
+				const auto kh = static_cast<ptrdiff_t>(h / head_factor);
+				const T *k_base = k_ptr + kh * ks.head;
+				const T *v_base = v_ptr + kh * vs.head;
 				float max_logit = -std::numeric_limits<float>::infinity();
 
 				int allow_upto = static_cast<int>(s + kvlen - qlen);
@@ -44,7 +38,7 @@ namespace {
 					if (static_cast<int>(t) > allow_upto) {
 						logit = -1e20f;
 					} else {
-						const T *k_vec = k_base + t * k_seq_stride;
+						const T *k_vec = k_base + static_cast<ptrdiff_t>(t) * ks.seq;
 						float dot = 0.f;
 						for (size_t j = 0; j < dim; ++j) {
 							dot += llaisys::utils::cast<float>(q_vec[j]) * llaisys::utils::cast<float>(k_vec[j]);
@@ -63,11 +57,11 @@ namespace {
 				}
 				float inv_sum = 1.0f / sum_exp;
 
-				T *y = out_ptr + s * out_seq_stride + h * out_head_stride;
+				T *y = out_ptr + si * os.seq + hi * os.head;
 				for (size_t d = 0; d < dv; ++d) {
 					float acc = 0.f;
 					for (size_t t = 0; t < kvlen; ++t) {
-						const T *v_vec = v_base + t * v_seq_stride;
+						const T *v_vec = v_base + static_cast<ptrdiff_t>(t) * vs.seq;
 						acc += (probs[t] * inv_sum) * llaisys::utils::cast<float>(v_vec[d]);
 					}
 					y[d] = llaisys::utils::cast<T>(acc);
@@ -80,14 +74,18 @@ namespace {
 namespace llaisys::ops::cpu {
 void self_attention(std::byte *out, const std::byte *q, const std::byte *k, const std::byte *v,
                     llaisysDataType_t type, size_t qlen, size_t kvlen, size_t nhead, size_t nkvh,
-                    size_t dim, size_t dv, float scale) {
+                    size_t dim, size_t dv, float scale, HeadStrides out_strides, HeadStrides q_strides,
+                    HeadStrides k_strides, HeadStrides v_strides) {
 	switch (type) {
 	case LLAISYS_DTYPE_F32:
-		return self_attn_impl<float>(out, q, k, v, qlen, kvlen, nhead, nkvh, dim, dv, scale);
+		return self_attn_impl<float>(out, q, k, v, qlen, kvlen, nhead, nkvh, dim, dv, scale, out_strides, q_strides,
+		                              k_strides, v_strides);
 	case LLAISYS_DTYPE_BF16:
-		return self_attn_impl<llaisys::bf16_t>(out, q, k, v, qlen, kvlen, nhead, nkvh, dim, dv, scale);
+		return self_attn_impl<llaisys::bf16_t>(out, q, k, v, qlen, kvlen, nhead, nkvh, dim, dv, scale, out_strides, q_strides,
+		                              k_strides, v_strides);
 	case LLAISYS_DTYPE_F16:
-		return self_attn_impl<llaisys::fp16_t>(out, q, k, v, qlen, kvlen, nhead, nkvh, dim, dv, scale);
+		return self_attn_impl<llaisys::fp16_t>(out, q, k, v, qlen, kvlen, nhead, nkvh, dim, dv, scale, out_strides, q_strides,
+		                              k_strides, v_strides);
 	default:
 		EXCEPTION_UNSUPPORTED_DATATYPE(type);
 	}
@@ -1,10 +1,21 @@
 #pragma once
 #include "llaisys.h"
 
+#include "../../strides.hpp"
+
 #include <cstddef>
 
 namespace llaisys::ops::cpu {
+// out/q are [qlen, nhead, *], k/v are [kvlen, nkvh, *], each with its own seq/head strides, so a
+// KV-cache prefix or heads inside a fused projection are read in place.
 void self_attention(std::byte *out, const std::byte *q, const std::byte *k, const std::byte *v,
                     llaisysDataType_t type, size_t qlen, size_t kvlen, size_t nhead, size_t nkvh,
-                    size_t dim, size_t dv, float scale);
+                    size_t dim, size_t dv, float scale, HeadStrides out_strides, HeadStrides q_strides,
+                    HeadStrides k_strides, HeadStrides v_strides);
+
+// Dense variant with k/v stored in the quantized `kvtype` (one quantized row per token and kv head);
+// q/out stay in the floating point `type`.
+void self_attention_quant(std::byte *out, const std::byte *q, const std::byte *k, const std::byte *v,
+                          llaisysDataType_t type, llaisysDataType_t kvtype, size_t qlen, size_t kvlen,
+                          size_t nhead, size_t nkvh, size_t dim, size_t dv, float scale);
 }
@@ -0,0 +1,173 @@
+#include "self_attention_cpu.hpp"
+
+#include "../../../utils.hpp"
+#include "../../../utils/cpu_features.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace {
+	// Tokens per dequantized K/V tile: 64 rows of a 128-wide head are 32 KB of fp32, so a tile
+	// stays in L1/L2 while every query head of the group reads it.
+	constexpr size_t kTokenTile = 64;
+
+	// One kv head of a Q8 cache ([float scale][int8 q[dim]] per row): token t is at base + t * stride.
+	struct Q8Rows {
+		const std::byte *base;
+		size_t stride;
+	};
+
+	[[gnu::always_inline]] inline void dequant_row(float *dst, const std::byte *row, size_t n) {
+		float s;
+		std::memcpy(&s, row, sizeof(float));
+		const int8_t *q = reinterpret_cast<const int8_t *>(row + sizeof(float));
+#pragma omp simd
+		for (size_t j = 0; j < n; ++j) dst[j] = static_cast<float>(q[j]) * s;
+	}
+
+	// The `group` query heads sharing one kv head (qf: [group, dim]) against its first `visible`
+	// rows; acc receives [group, dv]. K and V are walked one tile of tokens at a time and each
+	// tile is dequantized once for the whole group. `tile` holds kTokenTile rows of max(dim, dv),
+	// `probs` [group, visible]. Always inlined so it is compiled for the ISA of its caller.
+	[[gnu::always_inline]] inline void attend_group(float *acc, const float *qf, size_t group, Q8Rows k, Q8Rows v,
+	                                                size_t visible, size_t dim, size_t dv, float scale, float *tile,
+	                                                float *probs) {
+		for (size_t t0 = 0; t0 < visible; t0 += kTokenTile) {
+			const size_t n = std::min(kTokenTile, visible - t0);
+			for (size_t i = 0; i < n; ++i) dequant_row(tile + i * dim, k.base + (t0 + i) * k.stride, dim);
+			for (size_t g = 0; g < group; ++g) {
+				const float *qg = qf + g * dim;
+				float *pg = probs + g * visible + t0;
+				for (size_t i = 0; i < n; ++i) {
+					const float *kr = tile + i * dim;
+					float dot = 0.f;
+#pragma omp simd reduction(+ : dot)
+					for (size_t j = 0; j < dim; ++j) dot += qg[j] * kr[j];
+					pg[i] = dot * scale;
+				}
+			}
+		}
+
+		for (size_t g = 0; g < group; ++g) {
+			float *pg = probs + g * visible;
+			float max_logit = -std::numeric_limits<float>::infinity();
+			for (size_t t = 0; t < visible; ++t) max_logit = std::max(max_logit, pg[t]);
+			float sum_exp = 0.f;
+			for (size_t t = 0; t < visible; ++t) {
+				pg[t] = std::exp(pg[t] - max_logit);
+				sum_exp += pg[t];
+			}
+			const float inv_sum = 1.0f / sum_exp;
+			for (size_t t = 0; t < visible; ++t) pg[t] *= inv_sum;
+		}
+
+		std::fill(acc, acc + group * dv, 0.f);
+		for (size_t t0 = 0; t0 < visible; t0 += kTokenTile) {
+			const size_t n = std::min(kTokenTile, visible - t0);
+			for (size_t i = 0; i < n; ++i) dequant_row(tile + i * dv, v.base + (t0 + i) * v.stride, dv);
+			for (size_t g = 0; g < group; ++g) {
+				float *ag = acc + g * dv;
+				const float *pg = probs + g * visible + t0;
+				for (size_t i = 0; i < n; ++i) {
+					const float *vr = tile + i * dv;
+					const float w = pg[i];
+#pragma omp simd
+					for (size_t d = 0; d < dv; ++d) ag[d] += w * vr[d];
+				}
+			}
+		}
+	}
+
+	using attend_fn = void (*)(float *, const float *, size_t, Q8Rows, Q8Rows, size_t, size_t, size_t, float, float *,
+	                           float *);
+
+	void attend_generic(float *acc, const float *qf, size_t group, Q8Rows k, Q8Rows v, size_t visible, size_t dim,
+	                    size_t dv, float scale, float *tile, float *probs) {
+		attend_group(acc, qf, group, k, v, visible, dim, dv, scale, tile, probs);
+	}
+
+#if LLAISYS_X86_SIMD
+	LLAISYS_TARGET("avx2,fma")
+	void attend_avx2(float *acc, const float *qf, size_t group, Q8Rows k, Q8Rows v, size_t visible, size_t dim,
+	                 size_t dv, float scale, float *tile, float *probs) {
+		attend_group(acc, qf, group, k, v, visible, dim, dv, scale, tile, probs);
+	}
+#endif
+
+	attend_fn select_attend() {
+#if LLAISYS_X86_SIMD
+		const auto &f = llaisys::utils::cpu_features();
+		if (f.avx2 && f.fma) return attend_avx2;
+#endif
+		return attend_generic;
+	}
+
+	// K/V rows are Q8, one row per (token, kv head), so the scale is per-token-per-head; it is
+	// applied when a tile is dequantized. The query heads of a GQA group are served together.
+	template <typename T>
+	void self_attn_q8kv_impl(std::byte *out, const std::byte *q, const std::byte *k, const std::byte *v,
+	                         size_t qlen, size_t kvlen, size_t nhead, size_t nkvh, size_t dim, size_t dv,
+	                         float scale) {
+		static const attend_fn attend = select_attend();
+		const T *q_ptr = reinterpret_cast<const T *>(q);
+		T *out_ptr = reinterpret_cast<T *>(out);
+		const size_t k_row_bytes = llaisys::utils::row_bytes(LLAISYS_DTYPE_Q8, dim);
+		const size_t v_row_bytes = llaisys::utils::row_bytes(LLAISYS_DTYPE_Q8, dv);
+		const size_t group = nhead / nkvh;
+
+		std::vector<float> qf(group * dim);
+		std::vector<float> probs(group * kvlen);
+		std::vector<float> tile(kTokenTile * std::max(dim, dv));
+		std::vector<float> acc(group * dv);
+
+		for (size_t s = 0; s < qlen; ++s) {
+			// causal: query s sees keys [0, s + kvlen - qlen]
+			const size_t visible = std::min(kvlen, s + kvlen - qlen + 1);
+			for (size_t kh = 0; kh < nkvh; ++kh) {
+				// the group's query heads are adjacent rows of q and out
+				const size_t row = s * nhead + kh * group;
+				const T *q_vec = q_ptr + row * dim;
+				for (size_t j = 0; j < group * dim; ++j) qf[j] = llaisys::utils::cast<float>(q_vec[j]);
+
+				attend(acc.data(), qf.data(), group, Q8Rows{k + kh * k_row_bytes, nkvh * k_row_bytes},
+				       Q8Rows{v + kh * v_row_bytes, nkvh * v_row_bytes}, visible, dim, dv, scale, tile.data(),
+				       probs.data());
+
+				T *y = out_ptr + row * dv;
+				for (size_t d = 0; d < group * dv; ++d) y[d] = llaisys::utils::cast<T>(acc[d]);
+			}
+		}
+	}
+
+	template <typename T>
+	void self_attn_quant_impl(std::byte *out, const std::byte *q, const std::byte *k, const std::byte *v,
+	                          llaisysDataType_t kvtype, size_t qlen, size_t kvlen, size_t nhead, size_t nkvh,
+	                          size_t dim, size_t dv, float scale) {
+		switch (kvtype) {
+		case LLAISYS_DTYPE_Q8:
+			return self_attn_q8kv_impl<T>(out, q, k, v, qlen, kvlen, nhead, nkvh, dim, dv, scale);
+		default:
+			EXCEPTION_UNSUPPORTED_DATATYPE(kvtype);
+		}
+	}
+}
+
+namespace llaisys::ops::cpu {
+void self_attention_quant(std::byte *out, const std::byte *q, const std::byte *k, const std::byte *v,
+                          llaisysDataType_t type, llaisysDataType_t kvtype, size_t qlen, size_t kvlen,
+                          size_t nhead, size_t nkvh, size_t dim, size_t dv, float scale) {
+	switch (type) {
+	case LLAISYS_DTYPE_F32:
+		return self_attn_quant_impl<float>(out, q, k, v, kvtype, qlen, kvlen, nhead, nkvh, dim, dv, scale);
+	case LLAISYS_DTYPE_BF16:
+		return self_attn_quant_impl<llaisys::bf16_t>(out, q, k, v, kvtype, qlen, kvlen, nhead, nkvh, dim, dv, scale);
+	case LLAISYS_DTYPE_F16:
+		return self_attn_quant_impl<llaisys::fp16_t>(out, q, k, v, kvtype, qlen, kvlen, nhead, nkvh, dim, dv, scale);
+	default:
+		EXCEPTION_UNSUPPORTED_DATATYPE(type);
+	}
+}
+} // namespace llaisys::ops::cpu
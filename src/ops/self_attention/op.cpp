@@ -8,7 +8,14 @@
 namespace llaisys::ops {
 void self_attention(tensor_t attn_val, tensor_t q, tensor_t k, tensor_t v, float scale) {
     CHECK_SAME_DEVICE(attn_val, q, k, v);
-    CHECK_SAME_DTYPE(attn_val->dtype(), q->dtype(), k->dtype(), v->dtype());
+    // A quantized KV-cache is dequantized inside the kernel; q and the output stay in floating point.
+    const bool quant_kv = utils::is_quantized(k->dtype());
+    if (quant_kv) {
+        CHECK_SAME_DTYPE(attn_val->dtype(), q->dtype());
+        CHECK_SAME_DTYPE(k->dtype(), v->dtype());
+    } else {
+        CHECK_SAME_DTYPE(attn_val->dtype(), q->dtype(), k->dtype(), v->dtype());
+    }
 
     ASSERT(attn_val->ndim() == 3 && q->ndim() == 3 && k->ndim() == 3 && v->ndim() == 3,
            "SelfAttention: all tensors must be 3D.");
@@ -27,21 +34,36 @@ void self_attention(tensor_t attn_val, tensor_t q, tensor_t k, tensor_t v, float
     ASSERT(attn_val->shape()[0] == qlen && attn_val->shape()[1] == nhead && attn_val->shape()[2] == vdim,
            "SelfAttention: output shape mismatch.");
     ASSERT(nhead % nkvh == 0, "SelfAttention: nhead must be divisible by nkvh.");
+    ASSERT(!quant_kv || kvlen >= qlen, "SelfAttention: quantized k/v must cover every query position.");
 
-    ASSERT(attn_val->isContiguous() && q->isContiguous() && k->isContiguous() && v->isContiguous(),
-           "SelfAttention: tensors must be contiguous.");
+    // The quantized kernel reads packed cache rows; the dense one takes any seq/head strides
+    // with a contiguous head dim.
+    ASSERT(!quant_kv || (attn_val->isContiguous() && q->isContiguous() && k->isContiguous() && v->isContiguous()),
+           "SelfAttention: tensors must be contiguous with a quantized KV-cache.");
+    const HeadStrides out_strides = head_strides(*attn_val);
+    const HeadStrides q_strides = head_strides(*q);
+    const HeadStrides k_strides = head_strides(*k);
+    const HeadStrides v_strides = head_strides(*v);
 
+    if (attn_val->deviceType() == LLAISYS_DEVICE_CPU && quant_kv) {
+        return cpu::self_attention_quant(attn_val->data(), q->data(), k->data(), v->data(), attn_val->dtype(),
+                                         k->dtype(), qlen, kvlen, nhead, nkvh, dim, vdim, scale);
+    }
     if (attn_val->deviceType() == LLAISYS_DEVICE_CPU) {
         return cpu::self_attention(attn_val->data(), q->data(), k->data(), v->data(), attn_val->dtype(), qlen,
-                                   kvlen, nhead, nkvh, dim, vdim, scale);
+                                   kvlen, nhead, nkvh, dim, vdim, scale, out_strides, q_strides, k_strides, v_strides);
     }
 
     llaisys::core::context().setDevice(attn_val->deviceType(), attn_val->deviceId());
 
     switch (attn_val->deviceType()) {
     case LLAISYS_DEVICE_CPU:
+        if (quant_kv) {
+            return cpu::self_attention_quant(attn_val->data(), q->data(), k->data(), v->data(), attn_val->dtype(),
+                                             k->dtype(), qlen, kvlen, nhead, nkvh, dim, vdim, scale);
+        }
         return cpu::self_attention(attn_val->data(), q->data(), k->data(), v->data(), attn_val->dtype(), qlen,
-                                   kvlen, nhead, nkvh, dim, vdim, scale);
+                                   kvlen, nhead, nkvh, dim, vdim, scale, out_strides, q_strides, k_strides, v_strides);
 #ifdef ENABLE_NVIDIA_API
     case LLAISYS_DEVICE_NVIDIA:
         TO_BE_IMPLEMENTED();
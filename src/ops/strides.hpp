@@ -0,0 +1,133 @@
+#pragma once
+
+#include "../tensor/tensor.hpp"
+#include "../utils.hpp"
+
+#include <cstddef>
+
+namespace llaisys::ops {
+// Element strides of a [len, nhead, dim] operand. The last dim is always unit-stride; the
+// other two are free, so KV-cache slices, heads interleaved with other outputs and
+// head-major layouts can be read in place.
+struct HeadStrides {
+    ptrdiff_t seq;
+    ptrdiff_t head;
+};
+
+inline HeadStrides dense_head_strides(size_t nhead, size_t dim) {
+    return {static_cast<ptrdiff_t>(nhead * dim), static_cast<ptrdiff_t>(dim)};
+}
+
+// Row stride of `t` viewed as [numel / last dim, last dim]: the last dim must be unit-stride
+// and the outer dims must collapse into one stride. Returns 0 if `t` is not addressable that way.
+inline ptrdiff_t row_stride(const Tensor &t) {
+    const auto &shape = t.shape();
+    const auto &strides = t.strides();
+    if (shape.empty()) return 1;
+    const size_t last = shape.size() - 1;
+    if (shape[last] != 1 && strides[last] != 1) return 0;
+    ptrdiff_t row = 0;
+    ptrdiff_t expect = 0;
+    for (size_t d = last; d-- > 0;) {
+        if (shape[d] == 1) continue;
+        if (row == 0) {
+            row = strides[d];
+        } else if (strides[d] != expect) {
+            return 0;
+        }
+        expect = strides[d] * static_cast<ptrdiff_t>(shape[d]);
+    }
+    return row != 0 ? row : static_cast<ptrdiff_t>(shape[last]);
+}
+
+// Element strides of a [rows, cols] operand; 0 broadcasts along that dim.
+struct MatStrides {
+    ptrdiff_t row;
+    ptrdiff_t col;
+};
+
+// c = f(a, b) with NumPy broadcasting, reduced to as few dims as possible: size-1 dims are
+// dropped and neighbours that are contiguous in all three operands are merged, with stride 0
+// wherever an operand is broadcast. The last two dims form the [rows, cols] block a kernel
+// handles; any dims before them are walked by for_each_block.
+struct BroadcastLayout {
+    TensorShape shape;
+    TensorStrides c, a, b;
+
+    size_t rows() const { return shape.size() >= 2 ? shape[shape.size() - 2] : 1; }
+    size_t cols() const { return shape.empty() ? 1 : shape.back(); }
+    MatStrides mat(const TensorStrides &s) const {
+        const size_t n = s.size();
+        return {n >= 2 ? s[n - 2] : 0, n >= 1 ? s[n - 1] : 1};
+    }
+};
+
+inline BroadcastLayout broadcast_layout(const Tensor &c, const Tensor &a, const Tensor &b) {
+    const size_t nd = c.ndim();
+    ASSERT(a.ndim() <= nd && b.ndim() <= nd, "broadcast: inputs must not have more dims than the output");
+    // size and stride of `t` along output dim d, right-aligned; missing and size-1 dims broadcast
+    auto dim = [nd](const Tensor &t, size_t d, size_t &size, ptrdiff_t &stride) {
+        const size_t off = nd - t.ndim();
+        size = d < off ? 1 : t.shape()[d - off];
+        stride = size == 1 ? 0 : t.strides()[d - off];
+    };
+
+    BroadcastLayout l;
+    for (size_t d = 0; d < nd; ++d) {
+        const size_t n = c.shape()[d];
+        size_t as, bs;
+        ptrdiff_t ast, bst;
+        dim(a, d, as, ast);
+        dim(b, d, bs, bst);
+        ASSERT((as == n || as == 1) && (bs == n || bs == 1) && n == (as != 1 ? as : bs),
+               "broadcast: output shape must be the broadcast of the input shapes");
+        if (n == 1) continue;
+        const ptrdiff_t cst = c.strides()[d];
+        const auto sn = static_cast<ptrdiff_t>(n);
+        if (!l.shape.empty() && l.c.back() == cst * sn && l.a.back() == ast * sn && l.b.back() == bst * sn) {
+            l.shape.back() *= n;
+            l.c.back() = cst;
+            l.a.back() = ast;
+            l.b.back() = bst;
+            continue;
+        }
+        l.shape.push_back(n);
+        l.c.push_back(cst);
+        l.a.push_back(ast);
+        l.b.push_back(bst);
+    }
+    return l;
+}
+
+// Calls fn(c_off, a_off, b_off), offsets in elements, once per [rows, cols] block of `l`.
+template <typename Fn>
+void for_each_block(const BroadcastLayout &l, Fn &&fn) {
+    const size_t nd = l.shape.size();
+    if (nd <= 2) return fn(ptrdiff_t(0), ptrdiff_t(0), ptrdiff_t(0));
+    const size_t outer = nd - 2;
+    TensorShape idx(outer, 0);
+    ptrdiff_t co = 0, ao = 0, bo = 0;
+    while (true) {
+        fn(co, ao, bo);
+        size_t d = outer;
+        while (d-- > 0) {
+            co += l.c[d];
+            ao += l.a[d];
+            bo += l.b[d];
+            if (++idx[d] < l.shape[d]) break;
+            const auto n = static_cast<ptrdiff_t>(l.shape[d]);
+            co -= l.c[d] * n;
+            ao -= l.a[d] * n;
+            bo -= l.b[d] * n;
+            idx[d] = 0;
+            if (d == 0) return;
+        }
+    }
+}
+
+// seq/head strides of a 3D [len, nhead, dim] tensor; asserts the last dim is unit-stride.
+inline HeadStrides head_strides(const Tensor &t) {
+    ASSERT(t.ndim() == 3 && (t.shape()[2] == 1 || t.strides()[2] == 1), "head_strides: last dim must be unit-stride.");
+    return {t.strides()[0], t.strides()[1]};
+}
+} // namespace llaisys::ops
@@ -1,36 +1,13 @@
 #include "swiglu_cpu.hpp"
 
-#include "../../../utils.hpp"
-
-#include <cmath>
-
-namespace {
-	template <typename T>
-	void swiglu_impl(std::byte *out, const std::byte *gate, const std::byte *up, size_t numel) {
-		const T *g_ptr = reinterpret_cast<const T *>(gate);
-		const T *u_ptr = reinterpret_cast<const T *>(up);
-		T *o_ptr = reinterpret_cast<T *>(out);
-
-		for (size_t i = 0; i < numel; ++i) {
-			float g = llaisys::utils::cast<float>(g_ptr[i]);
-			float u = llaisys::utils::cast<float>(u_ptr[i]);
-			float sigmoid = 1.0f / (1.0f + std::exp(-g));
-			o_ptr[i] = llaisys::utils::cast<T>(u * g * sigmoid);
-		}
-	}
-}
+#include "../../elementwise.hpp"
 
 namespace llaisys::ops::cpu {
 void swiglu(std::byte *out, const std::byte *gate, const std::byte *up, llaisysDataType_t type, size_t numel) {
-	switch (type) {
-	case LLAISYS_DTYPE_F32:
-		return swiglu_impl<float>(out, gate, up, numel);
-	case LLAISYS_DTYPE_BF16:
-		return swiglu_impl<llaisys::bf16_t>(out, gate, up, numel);
-	case LLAISYS_DTYPE_F16:
-		return swiglu_impl<llaisys::fp16_t>(out, gate, up, numel);
-	default:
-		EXCEPTION_UNSUPPORTED_DATATYPE(type);
-	}
+	using namespace elementwise;
+	dispatch_float(type, [&](auto tag) {
+		using T = decltype(tag);
+		map_rows(SwiGLU{}, 1, numel, rows_of<T>(out, 0), rows_of<T>(gate, 0), rows_of<T>(up, 0));
+	});
 }
 } // namespace llaisys::ops::cpu
@@ -1,5 +1,6 @@
 #include "tensor.hpp"
 
+#include "../ops/rearrange/cpu/rearrange_cpu.hpp"
 #include "../utils.hpp"
 
 #include <cstring>
@@ -7,37 +8,90 @@
 #include <sstream>
 
 namespace llaisys {
+namespace {
+//按行计算字节数：量化类型的每一行（最后一维）带有自己的 scale 头
+size_t storage_bytes(llaisysDataType_t dtype, const TensorShape &shape) {
+    size_t cols = shape.empty() ? 1 : shape.back();
+    size_t rows = 1;
+    for (size_t i = 0; i + 1 < shape.size(); ++i) rows *= shape[i];
+    return rows * utils::row_bytes(dtype, cols);
+}
+
+//行优先的连续步长（以元素为单位）
+TensorStrides contiguous_strides(const TensorShape &shape) {
+    TensorStrides strides(shape.size());
+    ptrdiff_t stride = 1;
+    for (size_t i = shape.size(); i-- > 0;) {
+        strides[i] = stride;
+        stride *= static_cast<ptrdiff_t>(shape[i]);
+    }
+    return strides;
+}
+
+size_t shape_numel(const TensorShape &shape) {
+    return std::accumulate(shape.begin(), shape.end(), size_t(1), std::multiplies<size_t>());
+}
+} // namespace
+
 //构造器
 Tensor::Tensor(TensorMeta meta, core::storage_t storage, size_t offset)
     : _meta(std::move(meta)), _storage(std::move(storage)), _offset(offset) {}
 //创建一个新的张量
-tensor_t Tensor::create(const std::vector<size_t> &shape,
+tensor_t Tensor::create(const TensorShape &shape,
                         llaisysDataType_t dtype,
                         llaisysDeviceType_t device_type,
                         int device) {
-    size_t ndim_ = shape.size();
-    //计算步长
-    std::vector<ptrdiff_t> strides(ndim_);
-    size_t stride = 1;
-    //后面所有维长度的乘积
-    for (size_t i = 1; i <= ndim_; i++) {
-        strides[ndim_ - i] = stride;
-        stride *= shape[ndim_ - i];
-    }
+    //计算步长：后面所有维长度的乘积
+    TensorStrides strides = contiguous_strides(shape);
+    ASSERT(shape.empty() || shape.back() % utils::quant_group(dtype) == 0,
+           "create: last dim must be a multiple of the quantization group");
     TensorMeta meta{dtype, shape, strides};
-    size_t total_elems = stride;
-    //计算数据类型大小
-    size_t dtype_size = utils::dsize(dtype);
+    //计算存储所需字节数（量化类型按行计入 scale 头）
+    size_t bytes = storage_bytes(dtype, shape);
 
     if (device_type == LLAISYS_DEVICE_CPU && core::context().runtime().deviceType() != LLAISYS_DEVICE_CPU) {
-        auto storage = core::context().runtime().allocateHostStorage(total_elems * dtype_size);
+        auto storage = core::context().runtime().allocateHostStorage(bytes);
         return std::shared_ptr<Tensor>(new Tensor(meta, storage));
     } else {
         core::context().setDevice(device_type, device);
-        auto storage = core::context().runtime().allocateDeviceStorage(total_elems * dtype_size);
+        auto storage = core::context().runtime().allocateDeviceStorage(bytes);
         return std::shared_ptr<Tensor>(new Tensor(meta, storage));
     }
 }
+//在已有存储上创建连续张量（不拷贝）
+tensor_t Tensor::create(const TensorShape &shape,
+                        llaisysDataType_t dtype,
+                        core::storage_t storage,
+                        size_t offset) {
+    ASSERT(storage != nullptr, "create: storage must not be null");
+    ASSERT(shape.empty() || shape.back() % utils::quant_group(dtype) == 0,
+           "create: last dim must be a multiple of the quantization group");
+    ASSERT(offset + storage_bytes(dtype, shape) <= storage->size(), "create: storage is too small");
+    return std::shared_ptr<Tensor>(
+        new Tensor(TensorMeta{dtype, shape, contiguous_strides(shape)}, std::move(storage), offset));
+}
+//在已有存储上按给定步长创建张量（不拷贝）
+tensor_t Tensor::create(const TensorShape &shape,
+                        const TensorStrides &strides,
+                        llaisysDataType_t dtype,
+                        core::storage_t storage,
+                        size_t offset) {
+    ASSERT(storage != nullptr, "create: storage must not be null");
+    ASSERT(shape.size() == strides.size(), "create: shape and strides must have the same length");
+    if (utils::is_quantized(dtype)) {
+        //量化张量按行打包，只能是连续布局
+        ASSERT(strides == contiguous_strides(shape), "create: quantized tensors must be contiguous");
+        return create(shape, dtype, std::move(storage), offset);
+    }
+    //最远元素的位置决定了需要的存储大小
+    size_t extent = shape_numel(shape) == 0 ? 0 : 1;
+    for (size_t i = 0; i < shape.size(); ++i) {
+        ASSERT(strides[i] >= 0, "create: negative strides are not supported");
+        if (shape[i] > 0) extent += (shape[i] - 1) * static_cast<size_t>(strides[i]);
+    }
+    ASSERT(offset + extent * utils::dsize(dtype) <= storage->size(), "create: storage is too small");
+    return std::shared_ptr<Tensor>(new Tensor(TensorMeta{dtype, shape, strides}, std::move(storage), offset));
+}
 //返回指向张量数据的指针        
 std::byte *Tensor::data() {
     return _storage->memory() + _offset;
@@ -46,16 +100,20 @@ std::byte *Tensor::data() {
 const std::byte *Tensor::data() const {
     return _storage->memory() + _offset;
 }
+//返回张量所在的存储对象
+const core::storage_t &Tensor::storage() const {
+    return _storage;
+}
 //返回张量的维度数
 size_t Tensor::ndim() const {
     return _meta.shape.size();
 }
 //返回张量的形状
-const std::vector<size_t> &Tensor::shape() const {
+const TensorShape &Tensor::shape() const {
     return _meta.shape;
 }
 //返回张量的步长
-const std::vector<ptrdiff_t> &Tensor::strides() const {
+const TensorStrides &Tensor::strides() const {
     return _meta.strides;
 }
 //返回张量的数据类型
@@ -73,7 +131,7 @@ int Tensor::deviceId() const {
 }
 //返回张量中的元素数量
 size_t Tensor::numel() const {
-    return std::accumulate(_meta.shape.begin(), _meta.shape.end(), size_t(1), std::multiplies<size_t>());
+    return shape_numel(_meta.shape);
 }
 //返回张量中每个元素的大小（以字节为单位）
 size_t Tensor::elementSize() const {
@@ -98,7 +156,7 @@ std::string Tensor::info() const {
 }
 
 template <typename T>
-void print_data(const T *data, const std::vector<size_t> &shape, const std::vector<ptrdiff_t> &strides, size_t dim) {
+void print_data(const T *data, const TensorShape &shape, const TensorStrides &strides, size_t dim) {
     if (dim == shape.size() - 1) {
         for (size_t i = 0; i < shape[dim]; i++) {
             if constexpr (std::is_same_v<T, bf16_t> || std::is_same_v<T, fp16_t>) {
@@ -115,7 +173,7 @@ void print_data(const T *data, const std::vector<size_t> &shape, const std::vect
     }
 }
 
-void debug_print(const std::byte *data, const std::vector<size_t> &shape, const std::vector<ptrdiff_t> &strides, llaisysDataType_t dtype) {
+void debug_print(const std::byte *data, const TensorShape &shape, const TensorStrides &strides, llaisysDataType_t dtype) {
     switch (dtype) {
     case LLAISYS_DTYPE_BYTE:
         return print_data(reinterpret_cast<const char *>(data), shape, strides, 0);
@@ -185,37 +243,33 @@ void Tensor::debug() const {
         return true;
     }
 //创建一个新张量，改变原始张量维度的顺序
-tensor_t Tensor::permute(const std::vector<size_t> &order) const {
+tensor_t Tensor::permute(const TensorShape &order) const {
     //检查order是否合法
     if (order.size() != ndim()) {
         throw std::invalid_argument("permute: order length mismatch");
     }
 
-    std::vector<size_t> new_shape(ndim());
-    std::vector<ptrdiff_t> new_strides(ndim());
+    TensorMeta new_meta{dtype(), TensorShape(ndim()), TensorStrides(ndim())};
     for (size_t i = 0; i < ndim(); ++i) {
         size_t j = order[i];
         if (j >= ndim()) throw std::out_of_range("permute index");
-        new_shape[i]   = shape()[j];
-        new_strides[i] = strides()[j];
+        new_meta.shape[i] = shape()[j];
+        new_meta.strides[i] = strides()[j];
     }
-
-    TensorMeta new_meta{dtype(), new_shape, new_strides};
-    return tensor_t(new Tensor(new_meta, _storage, _offset));   // 零拷贝
-
-
-    return std::shared_ptr<Tensor>(new Tensor(_meta, _storage));
+    return tensor_t(new Tensor(new_meta, _storage, _offset)); // 零拷贝
 }
-//改变张量的视图
-tensor_t Tensor::view(const std::vector<size_t> &shape) const {
-    if(isContiguous() == true){
-        tensor_t tmp = create(shape, this->dtype(), this->deviceType(), this->deviceId()); 
-        tmp->_storage = this->_storage;
-        return tmp;
-    }else{
+//改变张量的视图：连续张量只换一套形状和步长，共享存储和偏移
+tensor_t Tensor::view(const TensorShape &shape) const {
+    ASSERT(shape_numel(shape) == numel(), "view: number of elements must not change");
+    if (utils::is_quantized(dtype())) {
+        ASSERT(!shape.empty() && shape.back() == this->shape().back(),
+               "view: quantized tensors must keep their last dim");
+    }
+    if (!isContiguous()) {
         //非连续存储
         return contiguous()->view(shape);
     }
+    return tensor_t(new Tensor(TensorMeta{dtype(), shape, contiguous_strides(shape)}, _storage, _offset));
 }
 
 tensor_t Tensor::slice(size_t dim, size_t start, size_t end) const {
@@ -224,19 +278,23 @@ tensor_t Tensor::slice(size_t dim, size_t start, size_t end) const {
     if (start > end || end > shape()[dim])
         throw std::out_of_range("slice range");
 
-    auto new_shape   = shape();
-    auto new_strides = strides();
-    new_shape[dim]   = end - start;
+    TensorMeta new_meta = _meta;
+    new_meta.shape[dim] = end - start;
 
-    size_t new_offset = _offset + start * new_strides[dim] * elementSize();
+    size_t new_offset = _offset + start * new_meta.strides[dim] * elementSize();
+    if (utils::is_quantized(dtype())) {
+        //量化张量的最后一维是一个整体打包的行，只能按行切片
+        ASSERT(dim + 1 < ndim(), "slice: quantized tensors cannot be sliced along the last dim");
+        size_t cols = shape().back();
+        new_offset = _offset + start * new_meta.strides[dim] / cols * utils::row_bytes(dtype(), cols);
+    }
 
-    TensorMeta new_meta{dtype(), new_shape, new_strides};
     return tensor_t(new Tensor(new_meta, _storage, new_offset));
 }
 //从主机内存加载数据
 void Tensor::load(const void *src_) {
     //计算要复制的字节数
-    size_t bytes = numel()*elementSize();
+    size_t bytes = storage_bytes(dtype(), shape());
     //拿到目标数据指针
     std::byte *dst =data();
 
@@ -253,51 +311,149 @@ void Tensor::load(const void *src_) {
 
 //创建一个连续存储的张量
 tensor_t Tensor::contiguous() const {
-    if(isContiguous()){
-        return std::shared_ptr<Tensor>(new Tensor(_meta, _storage));
-    }else{
-        //形状
-        const auto& sh  = shape();
-        //维度
-        const auto  dim = sh.size();    
-
-        //创建一个新的连续步长数组
-        std::vector<ptrdiff_t> c_str(dim, 1);
-        for (size_t i = dim - 1; i-- > 0;) {
-            c_str[i] = c_str[i + 1] * sh[i + 1];
+    if (isContiguous()) {
+        return std::shared_ptr<Tensor>(new Tensor(_meta, _storage, _offset));
+    }
+    ASSERT(!utils::is_quantized(dtype()), "contiguous: quantized tensors are always row-contiguous");
+    ASSERT(deviceType() == LLAISYS_DEVICE_CPU, "contiguous: only CPU tensors can be compacted for now");
+
+    //按元素步长拷贝到新的连续存储（合并可合并的维度，必要时分块转置）
+    tensor_t dst = create(shape(), dtype(), deviceType(), deviceId());
+    ops::cpu::rearrange(dst->data(), data(), shape().data(), dst->strides().data(), strides().data(), ndim(),
+                        elementSize());
+    return dst;
+}
+
+namespace {
+//为新形状推导视图步长：把原张量按内存连续的块划分，新形状的每一段必须恰好铺满一个块
+bool view_strides(const TensorShape &old_shape, const TensorStrides &old_strides, const TensorShape &shape,
+                  TensorStrides &strides) {
+    strides = TensorStrides(shape.size());
+    if (old_shape.empty()) {
+        //标量：新形状全为 1
+        for (size_t i = 0; i < shape.size(); ++i) strides[i] = 1;
+        return true;
+    }
+    ptrdiff_t view_d = static_cast<ptrdiff_t>(shape.size()) - 1;
+    ptrdiff_t chunk_base = old_strides.back();
+    size_t tensor_numel = 1;
+    size_t view_numel = 1;
+    for (size_t d = old_shape.size(); d-- > 0;) {
+        tensor_numel *= old_shape[d];
+        //块在 d 处结束：上一维不能与当前块合并
+        if (d == 0 || (old_shape[d - 1] != 1
+                       && old_strides[d - 1] != static_cast<ptrdiff_t>(tensor_numel) * chunk_base)) {
+            while (view_d >= 0 && (view_numel < tensor_numel || shape[view_d] == 1)) {
+                strides[view_d] = static_cast<ptrdiff_t>(view_numel) * chunk_base;
+                view_numel *= shape[view_d];
+                --view_d;
+            }
+            if (view_numel != tensor_numel) return false;
+            if (d > 0) {
+                chunk_base = old_strides[d - 1];
+                tensor_numel = 1;
+                view_numel = 1;
+            }
         }
+    }
+    return view_d == -1;
+}
+} // namespace
 
-        //申请同设备新存储
-        size_t bytes = numel() * elementSize();
-        core::storage_t st = (deviceType() == LLAISYS_DEVICE_CPU)
-                             ? core::context().runtime().allocateHostStorage(bytes)
-                             : core::context().runtime().allocateDeviceStorage(bytes);
+tensor_t Tensor::reshape(const TensorShape &shape) const {
+    ASSERT(shape_numel(shape) == numel(), "reshape: number of elements must not change");
+    if (utils::is_quantized(dtype()) || numel() == 0) {
+        //量化张量总是按行连续，空张量没有可保留的布局
+        return view(shape);
+    }
+    TensorStrides strides;
+    if (view_strides(this->shape(), this->strides(), shape, strides)) {
+        return tensor_t(new Tensor(TensorMeta{dtype(), shape, strides}, _storage, _offset));
+    }
+    //步长无法表达新形状：按新形状拷贝一次，拷贝结果直接作为连续张量
+    return contiguous()->view(shape);
+}
 
-        //创建新连续张量
-        tensor_t dst(new Tensor(TensorMeta{dtype(), sh, c_str}, st, 0));
+tensor_t Tensor::to(llaisysDeviceType_t device_type, int device, bool non_blocking) const {
+    const llaisysDeviceType_t src_type = deviceType();
+    const int src_id = deviceId();
+    if (device_type == LLAISYS_DEVICE_CPU) {
+        device = 0;
+    } else if (device < 0) {
+        device = src_type == device_type ? src_id : 0;
+    }
+    if (src_type == device_type && src_id == device) {
+        //已在目标位置：共享存储，不拷贝
+        return tensor_t(new Tensor(_meta, _storage, _offset));
+    }
 
-        // 4. 拷贝数据（H2H 或 H2D 视设备而定）
-        core::context().setDevice(deviceType(), deviceId());
-        core::context().runtime().api()->memcpy_sync(
-        dst->data(), data(), bytes,
-        deviceType() == LLAISYS_DEVICE_CPU ? LLAISYS_MEMCPY_H2H : LLAISYS_MEMCPY_H2D);
+    const size_t bytes = storage_bytes(dtype(), shape());
+    const bool src_host = src_type == LLAISYS_DEVICE_CPU;
+    const bool dst_host = device_type == LLAISYS_DEVICE_CPU;
+    ASSERT(src_host || isContiguous(), "to: device tensors must be contiguous");
 
-        return dst;          // 新的连续张量
-            
+    if (src_host) {
+        //主机到设备：可分页内存或非连续张量先写入锁页中转缓冲（非连续时这一步就是按步长的拷贝）
+        core::context().setDevice(device_type, device);
+        auto &runtime = core::context().runtime();
+        tensor_t dst = create(shape(), dtype(), device_type, device);
+        core::storage_t host = _storage;
+        const std::byte *src = data();
+        if (!isContiguous() || !_storage->isPinned()) {
+            host = runtime.allocateHostStorage(bytes);
+            if (isContiguous()) {
+                std::memcpy(host->memory(), src, bytes);
+            } else {
+                ops::cpu::rearrange(host->memory(), src, shape().data(), dst->strides().data(), strides().data(),
+                                    ndim(), elementSize());
+            }
+            src = host->memory();
+        }
+        runtime.api()->memcpy_async(dst->data(), src, bytes, LLAISYS_MEMCPY_H2D, runtime.stream());
+        if (non_blocking) {
+            runtime.retainUntilComplete(std::move(host));
+        } else {
+            runtime.synchronize();
+        }
+        return dst;
     }
 
+    if (dst_host) {
+        //设备到主机：目标分配为锁页内存，拷贝排在源设备流上，跟在产生该数据的计算之后
+        core::context().setDevice(src_type, src_id);
+        auto &runtime = core::context().runtime();
+        tensor_t dst = create(shape(), dtype(), LLAISYS_DEVICE_CPU);
+        runtime.api()->memcpy_async(dst->data(), data(), bytes, LLAISYS_MEMCPY_D2H, runtime.stream());
+        if (non_blocking) {
+            runtime.retainUntilComplete(_storage);
+        } else {
+            runtime.synchronize();
+        }
+        return dst;
+    }
 
-    
-}
+    if (src_type != device_type) {
+        //不同类型的设备之间经由主机中转
+        return to(LLAISYS_DEVICE_CPU)->to(device_type, device, non_blocking);
+    }
 
-tensor_t Tensor::reshape(const std::vector<size_t> &shape) const {
-    TO_BE_IMPLEMENTED();
-    return std::shared_ptr<Tensor>(new Tensor(_meta, _storage));
-}
+    //同类设备之间：目标流先等待源流上已提交的计算，再做设备间拷贝
+    core::context().setDevice(src_type, src_id);
+    auto &src_runtime = core::context().runtime();
+    llaisysEvent_t ready = src_runtime.api()->create_event();
+    src_runtime.api()->event_record(ready, src_runtime.stream());
 
-tensor_t Tensor::to(llaisysDeviceType_t device_type, int device) const {
-    TO_BE_IMPLEMENTED();
-    return std::shared_ptr<Tensor>(new Tensor(_meta, _storage));
+    tensor_t dst = create(shape(), dtype(), device_type, device);
+    auto &runtime = core::context().runtime();
+    runtime.api()->stream_wait_event(runtime.stream(), ready);
+    runtime.api()->memcpy_async(dst->data(), data(), bytes, LLAISYS_MEMCPY_D2D, runtime.stream());
+    runtime.api()->destroy_event(ready);
+    if (non_blocking) {
+        runtime.retainUntilComplete(_storage);
+    } else {
+        runtime.synchronize();
+    }
+    return dst;
 }
 
 } // namespace llaisys
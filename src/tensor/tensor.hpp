@@ -1,8 +1,14 @@
 #pragma once
 #include "../core/llaisys_core.hpp"
+#include "../utils/small_vector.hpp"
 
 #include <vector>
 namespace llaisys {
+    //张量的最大维度数，形状和步长就地存放，创建视图不需要分配内存
+    constexpr size_t kMaxTensorDims = 8;
+    using TensorShape = utils::SmallVector<size_t, kMaxTensorDims>;
+    using TensorStrides = utils::SmallVector<ptrdiff_t, kMaxTensorDims>;
+
     //前向声明张量类
     class Tensor;
     //张量的共享指针类型
@@ -13,9 +19,9 @@ namespace llaisys {
         //数据类型
         llaisysDataType_t dtype;
         //形状
-        std::vector<size_t> shape;
+        TensorShape shape;
         //步长
-        std::vector<ptrdiff_t> strides;
+        TensorStrides strides;
     };
 
     //张量
@@ -35,13 +41,26 @@ namespace llaisys {
         //创建一个新的张量
         static tensor_t create(
             //张量形状
-            const std::vector<size_t> &shape,
+            const TensorShape &shape,
             //数据类型
             llaisysDataType_t dtype,
             //默认在CPU上创建张量
             llaisysDeviceType_t device_type = LLAISYS_DEVICE_CPU,
             //设备ID，默认为0
             int device = 0);
+        //在已有存储上创建张量（不拷贝），offset 以字节为单位
+        static tensor_t create(
+            const TensorShape &shape,
+            llaisysDataType_t dtype,
+            core::storage_t storage,
+            size_t offset = 0);
+        //在已有存储上按给定步长（以元素为单位，不能为负）创建张量，用于借用外部内存
+        static tensor_t create(
+            const TensorShape &shape,
+            const TensorStrides &strides,
+            llaisysDataType_t dtype,
+            core::storage_t storage,
+            size_t offset = 0);
         //析构器
         ~Tensor() = default;
         // Info
@@ -49,12 +68,14 @@ namespace llaisys {
         std::byte *data();
         //返回指向张量数据的常量指针
         const std::byte *data() const;
+        //返回张量所在的存储对象（可能被多个张量共享）
+        const core::storage_t &storage() const;
         //返回张量的维度数
         size_t ndim() const;
         //返回张量的形状
-        const std::vector<size_t> &shape() const;
+        const TensorShape &shape() const;
         //返回张量的步长    
-        const std::vector<ptrdiff_t> &strides() const;
+        const TensorStrides &strides() const;
         //返回张量的数据类型
         llaisysDataType_t dtype() const;
         //返回张量所存储数据的存储对象
@@ -74,17 +95,21 @@ namespace llaisys {
         bool isContiguous() const;
 
         // Meta Transform
-        tensor_t permute(const std::vector<size_t> &order) const;
+        //以下三个操作只改变元数据，与原张量共享存储，不分配新内存
+        tensor_t permute(const TensorShape &order) const;
         tensor_t slice(size_t dim, size_t start, size_t end) const;
-        tensor_t view(const std::vector<size_t> &shape) const;
+        tensor_t view(const TensorShape &shape) const;
 
         // Load data from host memory
         void load(const void *src);
 
         // Challenging features
         tensor_t contiguous() const;
-        tensor_t reshape(const std::vector<size_t> &shape) const;
-        tensor_t to(llaisysDeviceType_t device_type, int device = -1) const;
+        //步长允许时返回零拷贝视图，否则做一次带步长的拷贝
+        tensor_t reshape(const TensorShape &shape) const;
+        //拷贝到其他设备；目标与当前位置相同时直接共享存储。
+        //拷贝在运行时的流上异步进行，non_blocking 为 false 时返回前等待完成
+        tensor_t to(llaisysDeviceType_t device_type, int device = -1, bool non_blocking = false) const;
     };
 
 } // namespace llaisys
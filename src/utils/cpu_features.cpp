@@ -0,0 +1,30 @@
+#include "cpu_features.hpp"
+
+namespace llaisys::utils {
+namespace {
+CpuFeatures detect() {
+    CpuFeatures f;
+#if LLAISYS_X86_SIMD
+    __builtin_cpu_init();
+    f.avx2 = __builtin_cpu_supports("avx2");
+    f.fma = __builtin_cpu_supports("fma");
+    f.f16c = __builtin_cpu_supports("f16c");
+    f.avx512f = __builtin_cpu_supports("avx512f");
+    f.avx512bw = __builtin_cpu_supports("avx512bw");
+    f.avx512bf16 = __builtin_cpu_supports("avx512bf16");
+#endif
+    return f;
+}
+} // namespace
+
+const CpuFeatures &cpu_features() {
+    static const CpuFeatures features = detect();
+    return features;
+}
+
+uint32_t cpu_isa_tag() {
+    const CpuFeatures &f = cpu_features();
+    return (f.avx2 ? 1u : 0u) | (f.fma ? 2u : 0u) | (f.f16c ? 4u : 0u) | (f.avx512f ? 8u : 0u) |
+           (f.avx512bw ? 16u : 0u) | (f.avx512bf16 ? 32u : 0u);
+}
+} // namespace llaisys::utils
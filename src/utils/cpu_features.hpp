@@ -0,0 +1,35 @@
+#pragma once
+
+// SIMD kernels are compiled per function with target attributes and selected at runtime,
+// so the library still builds and runs on CPUs (and compilers) without these extensions.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define LLAISYS_X86_SIMD 1
+#define LLAISYS_TARGET(isa) __attribute__((target(isa)))
+// llaisys.h defines __C, which intrinsic headers use as a parameter name.
+#pragma push_macro("__C")
+#undef __C
+#include <immintrin.h>
+#pragma pop_macro("__C")
+#else
+#define LLAISYS_X86_SIMD 0
+#define LLAISYS_TARGET(isa)
+#endif
+
+#include <cstdint>
+
+namespace llaisys::utils {
+struct CpuFeatures {
+    bool avx2 = false;
+    bool fma = false;
+    bool f16c = false;
+    bool avx512f = false;
+    bool avx512bw = false;
+    bool avx512bf16 = false;
+};
+
+// Features of the host CPU, detected once.
+const CpuFeatures &cpu_features();
+
+// Bitmask of the features above, used to tag data laid out for a particular CPU.
+uint32_t cpu_isa_tag();
+} // namespace llaisys::utils
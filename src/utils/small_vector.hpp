@@ -0,0 +1,76 @@
+#pragma once
+
+#include "check.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+#include <vector>
+
+namespace llaisys::utils {
+// Fixed-capacity vector stored inline. Used for tensor shapes and strides so that creating
+// views, slices and permutes never allocates; exceeding N is an error, not a reallocation.
+template <typename T, size_t N>
+class SmallVector {
+public:
+    using value_type = T;
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    SmallVector() = default;
+
+    explicit SmallVector(size_t n, const T &value = T()) {
+        resize(n, value);
+    }
+
+    // Integral arguments are (n, value), as with std::vector.
+    template <typename It, typename = std::enable_if_t<!std::is_integral_v<It>>>
+    SmallVector(It first, It last) {
+        for (; first != last; ++first) push_back(static_cast<T>(*first));
+    }
+
+    SmallVector(std::initializer_list<T> init) : SmallVector(init.begin(), init.end()) {}
+
+    // Implicit so existing call sites can keep passing std::vector shapes.
+    SmallVector(const std::vector<T> &v) : SmallVector(v.begin(), v.end()) {}
+
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    static constexpr size_t capacity() { return N; }
+
+    T *data() { return _data; }
+    const T *data() const { return _data; }
+    iterator begin() { return _data; }
+    iterator end() { return _data + _size; }
+    const_iterator begin() const { return _data; }
+    const_iterator end() const { return _data + _size; }
+
+    T &operator[](size_t i) { return _data[i]; }
+    const T &operator[](size_t i) const { return _data[i]; }
+    T &back() { return _data[_size - 1]; }
+    const T &back() const { return _data[_size - 1]; }
+
+    void push_back(const T &v) {
+        ASSERT(_size < N, "SmallVector: capacity exceeded");
+        _data[_size++] = v;
+    }
+
+    void resize(size_t n, const T &value = T()) {
+        ASSERT(n <= N, "SmallVector: capacity exceeded");
+        for (size_t i = _size; i < n; ++i) _data[i] = value;
+        _size = n;
+    }
+
+    std::vector<T> vec() const { return std::vector<T>(begin(), end()); }
+
+    friend bool operator==(const SmallVector &a, const SmallVector &b) {
+        return a._size == b._size && std::equal(a.begin(), a.end(), b.begin());
+    }
+    friend bool operator!=(const SmallVector &a, const SmallVector &b) { return !(a == b); }
+
+private:
+    T _data[N]{};
+    size_t _size{0};
+};
+} // namespace llaisys::utils
@@ -55,6 +55,11 @@ inline size_t dsize(llaisysDataType_t dtype) {
         return 8; // 8 bytes complex
     case LLAISYS_DTYPE_C128:
         return 16; // 16 bytes complex
+    case LLAISYS_DTYPE_Q8:
+        return 1; // int8 payload, the per-row scale is accounted in row_bytes()
+    case LLAISYS_DTYPE_Q4_32:
+    case LLAISYS_DTYPE_Q4_64:
+        return 1; // packed nibbles, storage must be sized with row_bytes()
     case LLAISYS_DTYPE_INVALID:
     default:
         throw std::invalid_argument("Unsupported or invalid data type.");
@@ -101,12 +106,48 @@ inline const char *dtype_to_str(llaisysDataType_t dtype) {
         return "complex64";
     case LLAISYS_DTYPE_C128:
         return "complex128";
+    case LLAISYS_DTYPE_Q8:
+        return "q8";
+    case LLAISYS_DTYPE_Q4_32:
+        return "q4_32";
+    case LLAISYS_DTYPE_Q4_64:
+        return "q4_64";
     case LLAISYS_DTYPE_INVALID:
     default:
         throw std::invalid_argument("Unsupported or invalid data type.");
     }
 }
 
+inline bool is_quantized(llaisysDataType_t dtype) {
+    return dtype == LLAISYS_DTYPE_Q8 || dtype == LLAISYS_DTYPE_Q4_32 || dtype == LLAISYS_DTYPE_Q4_64;
+}
+
+// Number of elements sharing one scale/min block; the last dim must be a multiple of it.
+inline size_t quant_group(llaisysDataType_t dtype) {
+    switch (dtype) {
+    case LLAISYS_DTYPE_Q4_32:
+        return 32;
+    case LLAISYS_DTYPE_Q4_64:
+        return 64;
+    default:
+        return 1;
+    }
+}
+
+// Bytes taken by one row of `cols` elements along the last dimension.
+// Quantized rows carry their own scale header, so this is not always cols * dsize().
+inline size_t row_bytes(llaisysDataType_t dtype, size_t cols) {
+    switch (dtype) {
+    case LLAISYS_DTYPE_Q8:
+        return sizeof(float) + cols;
+    case LLAISYS_DTYPE_Q4_32:
+    case LLAISYS_DTYPE_Q4_64:
+        return cols / quant_group(dtype) * (2 * sizeof(uint16_t) + quant_group(dtype) / 2);
+    default:
+        return cols * dsize(dtype);
+    }
+}
+
 float _f16_to_f32(fp16_t val);
 fp16_t _f32_to_f16(float val);
 
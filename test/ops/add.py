@@ -12,6 +12,21 @@ def torch_add(ans, a, b):
     torch.add(a, b, out=ans)
 
 
+def test_op_add_broadcast(shape, b_shape, dtype_name="f32", atol=1e-5, rtol=1e-5, device_name="cpu"):
+    print(f"   shape {shape} + {b_shape} dtype <{dtype_name}>")
+    a, a_ = random_tensor(shape, dtype_name, device_name)
+    b, b_ = random_tensor(b_shape, dtype_name, device_name)
+
+    c, c_ = random_tensor(shape, dtype_name, device_name)
+    torch_add(c, a, b)
+    llaisys.Ops.add(c_, a_, b_)
+    assert check_equal(c_, c, atol=atol, rtol=rtol)
+
+    # in place: a += b
+    llaisys.Ops.add_(a_, b_)
+    assert check_equal(a_, c, atol=atol, rtol=rtol)
+
+
 def test_op_add(
     shape,
     dtype_name="f32",
@@ -57,4 +72,9 @@ if __name__ == "__main__":
         for dtype_name, atol, rtol in testDtypePrec:
             test_op_add(shape, dtype_name, atol, rtol, args.device, args.profile)
 
+    testBroadcastShapes = [((2, 3), (3,)), ((512, 4096), (512, 1)), ((2, 3, 4), (1, 3, 1))]
+    for shape, b_shape in testBroadcastShapes:
+        for dtype_name, atol, rtol in testDtypePrec:
+            test_op_add_broadcast(shape, b_shape, dtype_name, atol, rtol, args.device)
+
     print("\033[92mTest passed!\033[0m\n")
@@ -0,0 +1,98 @@
+import sys
+import os
+
+parent_dir = os.path.abspath(os.path.join(os.path.dirname(__file__), ".."))
+sys.path.insert(0, parent_dir)
+import llaisys
+import torch
+from test_utils import random_tensor, check_equal, benchmark
+
+
+def torch_dequantize(w, qtype_name):
+    w = w.float()
+    if qtype_name == "q8":
+        # per-output-channel symmetric int8: w ~= q * scale, scale = max|w| / 127
+        scale = w.abs().amax(dim=1, keepdim=True) / 127.0
+        return torch.round(w / scale).clamp(-127, 127) * scale
+    # q4_<G>: per group of G, w ~= q * scale + min with q in [0, 15] and fp16 scale / min
+    group = int(qtype_name.split("_")[1])
+    g = w.reshape(w.shape[0], -1, group)
+    lo, hi = g.amin(dim=2, keepdim=True), g.amax(dim=2, keepdim=True)
+    scale = ((hi - lo) / 15.0).half().float()
+    lo = lo.half().float()
+    q = torch.round((g - lo) * (1.0 / scale)).clamp(0, 15)
+    return (q * scale + lo).reshape(w.shape)
+
+
+def torch_quant_linear(out, x, w, bias, qtype_name):
+    w = torch_dequantize(w, qtype_name)
+    out.copy_(torch.nn.functional.linear(x.float(), w, bias.float()).to(out.dtype))
+
+
+def test_op_quant_linear(
+    out_shape,
+    x_shape,
+    w_shape,
+    qtype_name="q8",
+    dtype_name="f32",
+    atol=1e-5,
+    rtol=1e-5,
+    device_name="cpu",
+    profile=False,
+):
+    print(f"   out {out_shape}, x {x_shape}, w {w_shape}, dtype <{dtype_name}> weight <{qtype_name}>")
+    x, x_ = random_tensor(x_shape, dtype_name, device_name, scale=0.1)
+    w, w_ = random_tensor(w_shape, dtype_name, device_name, scale=0.01, bias=-0.005)
+    bias, bias_ = random_tensor((w_shape[0],), dtype_name, device_name)
+
+    qtype = {
+        "q8": llaisys.DataType.Q8,
+        "q4_32": llaisys.DataType.Q4_32,
+        "q4_64": llaisys.DataType.Q4_64,
+    }[qtype_name]
+    wq_ = llaisys.Tensor(w_shape, dtype=qtype, device=w_.device_type())
+    llaisys.Ops.quantize(wq_, w_)
+
+    out, out_ = random_tensor(out_shape, dtype_name, device_name)
+    torch_quant_linear(out, x, w, bias, qtype_name)
+    llaisys.Ops.linear(out_, x_, wq_, bias_)
+
+    assert check_equal(out_, out, atol=atol, rtol=rtol)
+
+    if profile:
+        benchmark(
+            lambda: torch.nn.functional.linear(x, w, bias, out=out),
+            lambda: llaisys.Ops.linear(out_, x_, wq_, bias_),
+            device_name,
+        )
+
+
+if __name__ == "__main__":
+    import argparse
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--device", default="cpu", choices=["cpu", "nvidia"], type=str)
+    parser.add_argument("--profile", action="store_true")
+    args = parser.parse_args()
+    testShapes = [
+        ((2, 3), (2, 64), (3, 64)),
+        ((1, 4096), (1, 4096), (4096, 4096)),
+        ((64, 1536), (64, 1536), (1536, 1536)),
+    ]
+    testDtypePrec = [
+        # type, atol, rtol
+        ("f32", 1e-4, 1e-4),
+        ("f16", 1e-3, 1e-3),
+        ("bf16", 1e-2, 1e-2),
+    ]
+    # a q4 value that lands exactly between two codes may round either way
+    testQuantTypes = [("q8", 1), ("q4_32", 10), ("q4_64", 10)]
+    print(f"Testing Ops.quantize + quantized Ops.linear on {args.device}")
+    for shapes in testShapes:
+        for qtype_name, slack in testQuantTypes:
+            for dtype_name, atol, rtol in testDtypePrec:
+                test_op_quant_linear(
+                    *shapes, qtype_name, dtype_name, atol * slack, rtol, args.device, args.profile
+                )
+
+    print("\033[92mTest passed!\033[0m\n")
@@ -0,0 +1,76 @@
+import sys
+import os
+
+parent_dir = os.path.abspath(os.path.join(os.path.dirname(__file__), ".."))
+sys.path.insert(0, parent_dir)
+import llaisys
+import torch
+from test_utils import random_tensor, check_equal, benchmark
+
+
+def test_op_rearrange(
+    shape,
+    order,
+    dtype_name="f32",
+    device_name="cpu",
+    profile=False,
+):
+    print(f"   shape {shape} order {order} dtype <{dtype_name}>")
+    inp, inp_ = random_tensor(shape, dtype_name, device_name)
+    src = inp.permute(*order)
+    src_ = inp_.permute(*order)
+
+    out, out_ = random_tensor(tuple(src.shape), dtype_name, device_name)
+    out.copy_(src)
+    llaisys.Ops.rearrange(out_, src_)
+
+    # copies are exact
+    assert check_equal(out_, out, atol=0, rtol=0)
+
+    if profile:
+        benchmark(
+            lambda: out.copy_(src),
+            lambda: llaisys.Ops.rearrange(out_, src_),
+            device_name,
+        )
+
+
+def test_op_rearrange_slice(shape, dim, start, end, dtype_name="f32", device_name="cpu"):
+    print(f"   shape {shape} slice dim {dim} [{start}, {end}) dtype <{dtype_name}>")
+    inp, inp_ = random_tensor(shape, dtype_name, device_name)
+    src = inp.narrow(dim, start, end - start)
+    src_ = inp_.slice(dim, start, end)
+
+    out, out_ = random_tensor(tuple(src.shape), dtype_name, device_name)
+    out.copy_(src)
+    llaisys.Ops.rearrange(out_, src_)
+    assert check_equal(out_, out, atol=0, rtol=0)
+
+
+if __name__ == "__main__":
+    import argparse
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--device", default="cpu", choices=["cpu", "nvidia"], type=str)
+    parser.add_argument("--profile", action="store_true")
+    args = parser.parse_args()
+    testCases = [
+        # shape, permute order
+        ((2, 3), (0, 1)),
+        ((2, 3), (1, 0)),
+        ((7, 33, 9), (2, 0, 1)),
+        ((64, 16, 128), (1, 0, 2)),
+        ((512, 1024), (1, 0)),
+        ((4, 128, 8, 64), (0, 2, 1, 3)),
+        ((4, 128, 8, 64), (0, 3, 2, 1)),
+    ]
+    testDtypes = ["f32", "f16", "bf16"]
+    print(f"Testing Ops.rearrange on {args.device}")
+    for shape, order in testCases:
+        for dtype_name in testDtypes:
+            test_op_rearrange(shape, order, dtype_name, args.device, args.profile)
+    for dtype_name in testDtypes:
+        test_op_rearrange_slice((16, 8, 64), 1, 2, 7, dtype_name, args.device)
+        test_op_rearrange_slice((16, 8, 64), 2, 5, 37, dtype_name, args.device)
+
+    print("\033[92mTest passed!\033[0m\n")
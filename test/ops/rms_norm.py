@@ -44,6 +44,27 @@ def test_op_rms_norm(
         )
 
 
+def test_op_rms_norm_strided(
+    shape,
+    dtype_name="f32",
+    atol=1e-5,
+    rtol=1e-5,
+    device_name="cpu",
+):
+    # input rows are the left half of a wider buffer, output rows the right half
+    print(f"   shape {shape} dtype <{dtype_name}> strided rows")
+    rows, cols = shape
+    buf, buf_ = random_tensor((rows, 2 * cols), dtype_name, device_name)
+    w, w_ = random_tensor((cols, ), dtype_name, device_name)
+    eps = 1e-5
+
+    c = torch.empty(shape, dtype=buf.dtype)
+    torch_rms_norm(c, buf[:, :cols], w, eps)
+    llaisys.Ops.rms_norm(buf_.slice(1, cols, 2 * cols), buf_.slice(1, 0, cols), w_, eps)
+
+    assert check_equal(buf_.slice(1, cols, 2 * cols), c, atol=atol, rtol=rtol)
+
+
 if __name__ == "__main__":
     import argparse
 
@@ -62,5 +83,6 @@ if __name__ == "__main__":
     for shape in testShapes:
         for dtype_name, atol, rtol in testDtypePrec:
             test_op_rms_norm(shape, dtype_name, atol, rtol, args.device, args.profile)
+            test_op_rms_norm_strided(shape, dtype_name, atol, rtol, args.device)
 
     print("\033[92mTest passed!\033[0m\n")
@@ -28,6 +28,42 @@ def torch_self_attention(attn_val, query, key, value, scale):
     attn_val.copy_((attn_weight @ value).transpose(-2, -3))
 
 
+def torch_q8_dequantize(x):
+    # per-row (token, kv head) symmetric int8, matching Ops.quantize into Q8
+    scale = x.float().abs().amax(dim=-1, keepdim=True) / 127.0
+    return (torch.round(x.float() / scale).clamp(-127, 127) * scale).to(x.dtype)
+
+
+def test_op_self_attention_q8kv(
+    qlen,
+    kvlen,
+    nh,
+    nkvh,
+    hd,
+    dtype_name="f32",
+    atol=1e-5,
+    rtol=1e-5,
+    device_name="cpu",
+):
+    print(
+        f"   qlen={qlen} kvlen={kvlen} nh={nh} nkvh={nkvh} hd={hd} dtype <{dtype_name}> kv <q8>"
+    )
+    q, q_ = random_tensor((qlen, nh, hd), dtype_name, device_name)
+    k, k_ = random_tensor((kvlen, nkvh, hd), dtype_name, device_name, bias=-0.5)
+    v, v_ = random_tensor((kvlen, nkvh, hd), dtype_name, device_name)
+    scale = 1.0 / (hd**0.5)
+
+    kq_ = llaisys.Tensor((kvlen, nkvh, hd), dtype=llaisys.DataType.Q8, device=k_.device_type())
+    vq_ = llaisys.Tensor((kvlen, nkvh, hd), dtype=llaisys.DataType.Q8, device=v_.device_type())
+    llaisys.Ops.quantize(kq_, k_)
+    llaisys.Ops.quantize(vq_, v_)
+
+    attn_val, attn_val_ = random_tensor((qlen, nh, hd), dtype_name, device_name)
+    torch_self_attention(attn_val, q, torch_q8_dequantize(k), torch_q8_dequantize(v), scale)
+    llaisys.Ops.self_attention(attn_val_, q_, kq_, vq_, scale)
+    assert check_equal(attn_val_, attn_val, atol=atol, rtol=rtol)
+
+
 def test_op_self_attention(
     qlen,
     kvlen,
@@ -61,6 +97,36 @@ def test_op_self_attention(
         )
 
 
+def test_op_self_attention_strided(
+    qlen,
+    kvlen,
+    nh,
+    nkvh,
+    hd,
+    dtype_name="f32",
+    atol=1e-5,
+    rtol=1e-5,
+    device_name="cpu",
+):
+    # q/k/v are head ranges of one fused [kvlen, nh + 2 * nkvh, hd] projection, read in place
+    print(
+        f"   qlen={qlen} kvlen={kvlen} nh={nh} nkvh={nkvh} hd={hd} dtype <{dtype_name}> fused qkv"
+    )
+    qkv, qkv_ = random_tensor((kvlen, nh + 2 * nkvh, hd), dtype_name, device_name)
+    q = qkv[kvlen - qlen :, :nh]
+    k = qkv[:, nh : nh + nkvh]
+    v = qkv[:, nh + nkvh :]
+    q_ = qkv_.slice(0, kvlen - qlen, kvlen).slice(1, 0, nh)
+    k_ = qkv_.slice(1, nh, nh + nkvh)
+    v_ = qkv_.slice(1, nh + nkvh, nh + 2 * nkvh)
+    scale = 1.0 / (hd**0.5)
+
+    attn_val, attn_val_ = random_tensor((qlen, nh, hd), dtype_name, device_name)
+    torch_self_attention(attn_val, q, k, v, scale)
+    llaisys.Ops.self_attention(attn_val_, q_, k_, v_, scale)
+    assert check_equal(attn_val_, attn_val, atol=atol, rtol=rtol)
+
+
 if __name__ == "__main__":
     import argparse
 
@@ -85,5 +151,7 @@ if __name__ == "__main__":
             test_op_self_attention(
                 *shape, dtype_name, atol, rtol, args.device, args.profile
             )
+            test_op_self_attention_q8kv(*shape, dtype_name, atol, rtol, args.device)
+            test_op_self_attention_strided(*shape, dtype_name, atol, rtol, args.device)
 
     print("\033[92mTest passed!\033[0m\n")
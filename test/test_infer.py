@@ -146,4 +146,13 @@ if __name__ == "__main__":
 
     if args.test:
         assert llaisys_tokens == tokens
+
+        # Roll the KV-cache back into the answer and regenerate the tail;
+        # only the positions after the cut are recomputed.
+        cut = max(1, len(llaisys_tokens) - max(1, args.max_steps // 2))
+        model.truncate_kv_cache(cut - 1)
+        regenerated = model.generate(
+            llaisys_tokens[:cut], max_new_tokens=len(llaisys_tokens) - cut
+        )
+        assert regenerated == llaisys_tokens
         print("\033[92mTest passed!\033[0m\n")
@@ -0,0 +1,64 @@
+import llaisys
+import torch
+from test_utils import *
+import argparse
+import json
+import os
+import tempfile
+
+
+def run_ops(device_name: str):
+    a, a_ = random_tensor((64, 128), "f32", device_name)
+    b, b_ = random_tensor((64, 128), "f32", device_name)
+    c, c_ = random_tensor((64, 128), "f32", device_name)
+    w, w_ = random_tensor((32, 128), "f32", device_name)
+    bias, bias_ = random_tensor((32,), "f32", device_name)
+    y, y_ = random_tensor((64, 32), "f32", device_name)
+    llaisys.Ops.add(c_, a_, b_)
+    llaisys.Ops.add(c_, a_, b_)
+    llaisys.Ops.linear(y_, a_, w_, bias_)
+
+
+def test_profiler(device_name: str = "cpu"):
+    profiler = llaisys.Profiler
+
+    # nothing is recorded while stopped
+    profiler.reset()
+    run_ops(device_name)
+    assert profiler.summary().splitlines()[1:] == []
+
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, "trace.json")
+        with profiler.profile(path):
+            run_ops(device_name)
+        with open(path) as f:
+            trace = json.load(f)
+
+    events = [e for e in trace["traceEvents"] if e["ph"] == "X"]
+    assert [e["name"] for e in events] == ["add", "add", "linear"]
+    for e in events:
+        assert e["dur"] >= 0 and e["ts"] >= 0
+    add, linear = events[0]["args"], events[2]["args"]
+    assert add["bytes"] == 3 * 64 * 128 * 4 and add["flops"] == 64 * 128
+    assert linear["flops"] == 2 * 64 * 32 * 128
+    assert linear["bytes"] == (64 * 128 + 32 * 128 + 64 * 32 + 32) * 4
+
+    rows = {line.split()[0]: line.split() for line in profiler.summary().splitlines()[1:]}
+    assert set(rows) == {"add", "linear"}
+    assert rows["add"][1] == "2" and rows["linear"][1] == "1"
+
+    # stopped again: totals stay put until reset
+    run_ops(device_name)
+    rows = {line.split()[0]: line.split() for line in profiler.summary().splitlines()[1:]}
+    assert rows["add"][1] == "2"
+    profiler.reset()
+    assert profiler.summary().splitlines()[1:] == []
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--device", default="cpu", choices=["cpu", "nvidia"], type=str)
+    args = parser.parse_args()
+    test_profiler(args.device)
+
+    print("\033[92mTest passed!\033[0m\n")
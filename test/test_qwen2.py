@@ -0,0 +1,128 @@
+import llaisys
+from llaisys.libllaisys import LIB_LLAISYS, DataType, DeviceType
+import argparse
+import ctypes
+import json
+import struct
+import sys
+import tempfile
+from pathlib import Path
+
+import numpy as np
+
+# the synthetic checkpoint writer of the end-to-end benchmark
+sys.path.insert(0, str(Path(__file__).resolve().parents[1] / "bench"))
+from bench_qwen2 import write_checkpoint
+
+# small enough to run in seconds, with dims that q4_32 blocks divide
+TINY = dict(hs=64, nlayer=2, nh=4, nkvh=2, di=128, voc=256, tied=False)
+PROMPT = [3, 17, 5, 88, 42, 7, 1, 60]
+QUANT_MODES = [(None, None), ("q8", None), ("q4_32", "q8"), (None, "q8")]
+
+
+def write_model(root, dtype, tied=False):
+    path = Path(root) / f"{dtype}-{'tied' if tied else 'untied'}"
+    write_checkpoint(path, dict(TINY, tied=tied), dtype, maxseq=64)
+    return path
+
+
+def read_weight(model_path, name):
+    """One float32 tensor of the synthetic checkpoint."""
+    with open(Path(model_path) / "model.safetensors", "rb") as f:
+        (size,) = struct.unpack("<Q", f.read(8))
+        header = json.loads(f.read(size))
+        begin, end = header[name]["data_offsets"]
+        assert header[name]["dtype"] == "F32"
+        f.seek(8 + size + begin)
+        return np.frombuffer(f.read(end - begin), np.float32).reshape(header[name]["shape"])
+
+
+def replace_weight(model, table, layer, values):
+    """Swaps a layer weight for a new tensor, as a caller editing the weight table would."""
+    weights = model._model_weights.contents
+    entries = getattr(weights, table)
+    old = entries[layer]
+    shape = (ctypes.c_size_t * values.ndim)(*values.shape)
+    new = LIB_LLAISYS.tensorCreate(shape, values.ndim, LIB_LLAISYS.tensorGetDataType(old), DeviceType.CPU, 0)
+    LIB_LLAISYS.tensorLoad(new, values.ctypes.data)
+    entries[layer] = new
+    # the model owns its table entries
+    LIB_LLAISYS.tensorDestroy(old)
+
+
+def test_decode_plan(model_path):
+    for quantize, kv in QUANT_MODES:
+        outputs = []
+        for plan in (False, True):
+            model = llaisys.models.Qwen2(model_path, quantize=quantize, kv_cache_quantize=kv, decode_plan=plan)
+            outputs.append(model.generate(PROMPT, max_new_tokens=16))
+            del model
+        assert outputs[0] == outputs[1], f"{model_path.name} quantize={quantize} kv={kv}: {outputs}"
+
+
+def test_decode_plan_weight_edit(model_path):
+    models = [llaisys.models.Qwen2(model_path, decode_plan=plan) for plan in (False, True)]
+    before = []
+    for model in models:
+        # captures the plan on the plan model
+        model.generate(PROMPT, max_new_tokens=4)
+        model.forward(PROMPT)
+        before.append(model.forward([9], append=True))
+
+    meta = models[0]._meta
+    # raw element bits: all-zero is 0.0 in f32 and bf16 alike
+    zeros = np.zeros((meta.hs, meta.nh * meta.dh), np.float32 if meta.dtype == DataType.F32 else np.uint16)
+    after = []
+    for model in models:
+        replace_weight(model, "attn_o_w", 0, zeros)
+        model.forward(PROMPT)
+        after.append(model.forward([9], append=True))
+
+    assert np.array_equal(before[0], before[1])
+    assert not np.array_equal(before[1], after[1]), "the edit had no effect"
+    # a stale plan would still run the old projection
+    assert np.array_equal(after[0], after[1])
+
+
+def test_position_outputs(model_path, atol):
+    model = llaisys.models.Qwen2(model_path)
+    logits = model.forward(PROMPT)
+    assert logits.shape == (len(PROMPT), TINY["voc"])
+    # the last row is what prefill samples from
+    model.truncate_kv_cache(0)
+    assert model.generate(PROMPT, max_new_tokens=1)[-1] == int(np.argmax(logits[-1]))
+
+    # row i must be what stepping the tokens one by one gives at position i
+    stepped = model.forward(PROMPT[:1])
+    stepped = np.concatenate([stepped] + [model.forward([t], append=True) for t in PROMPT[1:]])
+    assert np.allclose(logits, stepped, atol=atol), np.abs(logits - stepped).max()
+
+    hidden = model.forward(PROMPT, hidden=True)
+    assert hidden.shape == (len(PROMPT), TINY["hs"])
+    # after the output norm (weights of ones) every row has unit RMS
+    assert np.allclose(np.sqrt(np.mean(hidden**2, axis=1)), 1.0, atol=1e-2)
+    if model._meta.dtype != DataType.F32:
+        return
+    head = read_weight(model_path, "lm_head.weight")
+    assert np.allclose(hidden @ head.T, logits, atol=atol)
+    # appended positions too
+    model.truncate_kv_cache(4)
+    tail = model.forward(PROMPT[4:], append=True, hidden=True)
+    assert np.allclose(tail, hidden[4:], atol=atol)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--device", default="cpu", choices=["cpu"], type=str)
+    args = parser.parse_args()
+
+    with tempfile.TemporaryDirectory() as tmp:
+        for dtype, tied in (("float32", False), ("bfloat16", True)):
+            path = write_model(tmp, dtype, tied)
+            print(f"Testing Qwen2 decode plan on {path.name}")
+            test_decode_plan(path)
+            test_decode_plan_weight_edit(path)
+            print(f"Testing Qwen2 per-position outputs on {path.name}")
+            test_position_outputs(path, 1e-4 if dtype == "float32" else 2e-2)
+
+    print("\033[92mTest passed!\033[0m\n")
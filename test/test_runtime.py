@@ -2,6 +2,8 @@ import llaisys
 import torch
 from test_utils import *
 import argparse
+import threading
+import time
 
 
 def test_basic_runtime_api(device_name: str = "cpu"):
@@ -18,6 +20,10 @@ def test_basic_runtime_api(device_name: str = "cpu"):
         print("Testing device {i}...")
         api.set_device(i)
         test_memcpy(api, 1024 * 1024)
+        test_stream_event(api, 1024 * 1024)
+        if device_name == "cpu":
+            test_event_rerecord(api)
+            test_synchronize_reentry(api)
 
         print("     Passed")
 
@@ -53,6 +59,77 @@ def test_memcpy(api, size_bytes: int):
     torch.testing.assert_close(a, b)
 
 
+def test_stream_event(api, size_bytes: int):
+    # a -> device_a on s1, then device_a -> b on s2 once s1 has reached `copied`
+    a = torch.randint(0, 255, (size_bytes,), dtype=torch.uint8, device=torch_device("cpu"))
+    b = torch.zeros_like(a)
+    device_a = api.malloc_device(size_bytes)
+    s1 = api.create_stream()
+    s2 = api.create_stream()
+    copied = api.create_event()
+
+    api.memcpy_async(device_a, a.data_ptr(), size_bytes, llaisys.MemcpyKind.H2D, s1)
+    api.event_record(copied, s1)
+    api.stream_wait_event(s2, copied)
+    api.memcpy_async(b.data_ptr(), device_a, size_bytes, llaisys.MemcpyKind.D2H, s2)
+    api.stream_synchronize(s2)
+    torch.testing.assert_close(a, b)
+
+    # host work runs in stream order
+    order = []
+    fn = llaisys.libllaisys.llaisysHostFn_t(lambda _: order.append(len(order)))
+    for _ in range(3):
+        api.launch_host_func(s1, fn, None)
+    api.event_record(copied, s1)
+    api.event_synchronize(copied)
+    assert order == [0, 1, 2]
+
+    api.destroy_event(copied)
+    api.destroy_stream(s1)
+    api.destroy_stream(s2)
+    api.free_device(device_a)
+
+
+def test_event_rerecord(api):
+    # a wait issued before the event is re-recorded elsewhere still waits for the old point
+    gate = threading.Event()
+    order = []
+    block = llaisys.libllaisys.llaisysHostFn_t(lambda _: gate.wait())
+    mark = llaisys.libllaisys.llaisysHostFn_t(lambda _: order.append("waiter"))
+    slow, fast, waiter = api.create_stream(), api.create_stream(), api.create_stream()
+    event = api.create_event()
+
+    api.launch_host_func(slow, block, None)
+    api.event_record(event, slow)
+    api.stream_wait_event(waiter, event)
+    api.launch_host_func(waiter, mark, None)
+    api.event_record(event, fast)
+    api.event_synchronize(event)
+    time.sleep(0.05)
+    assert order == [], "waiter ran before the point it waited for"
+
+    gate.set()
+    api.stream_synchronize(waiter)
+    assert order == ["waiter"]
+
+    api.destroy_event(event)
+    for stream in (slow, fast, waiter):
+        api.destroy_stream(stream)
+
+
+def test_synchronize_reentry(api):
+    # device_synchronize must not hold up tasks that create or destroy streams
+    def task(_):
+        time.sleep(0.05)
+        api.destroy_stream(api.create_stream())
+
+    fn = llaisys.libllaisys.llaisysHostFn_t(task)
+    stream = api.create_stream()
+    api.launch_host_func(stream, fn, None)
+    api.device_synchronize()
+    api.destroy_stream(stream)
+
+
 if __name__ == "__main__":
     parser = argparse.ArgumentParser()
     parser.add_argument("--device", default="cpu", choices=["cpu", "nvidia"], type=str)
@@ -1,5 +1,6 @@
 import llaisys
 
+import numpy as np
 import torch
 from test_utils import *
 import argparse
@@ -48,8 +49,79 @@ def test_tensor():
     assert llaisys_tensor.is_contiguous() == torch_tensor.is_contiguous()
     assert check_equal(llaisys_tensor_slice, torch_tensor_slice)
 
+    # Test view of a slice: metadata only, shares storage and offset
+    print("===Test view of slice===")
+    torch_tensor_rows = torch_tensor[1:3].view(8, 5)
+    llaisys_tensor_rows = llaisys_tensor.slice(0, 1, 3).view(8, 5)
+    assert llaisys_tensor_rows.shape() == torch_tensor_rows.shape
+    assert llaisys_tensor_rows.strides() == torch_tensor_rows.stride()
+    assert llaisys_tensor_rows.data_ptr() == llaisys_tensor.data_ptr() + 20 * 8
+    assert check_equal(llaisys_tensor_rows, torch_tensor_rows)
+
+    # Test reshape: a view whenever the strides allow it, a copy otherwise
+    print("===Test reshape===")
+    torch_tensor_split = torch_tensor_perm.reshape(5, 3, 2, 2)
+    llaisys_tensor_split = llaisys_tensor_perm.reshape(5, 3, 2, 2)
+    assert llaisys_tensor_split.shape() == torch_tensor_split.shape
+    assert llaisys_tensor_split.strides() == torch_tensor_split.stride()
+    assert llaisys_tensor_split.data_ptr() == llaisys_tensor.data_ptr()
+    assert check_equal(llaisys_tensor_split, torch_tensor_split)
+
+    torch_tensor_flat = torch_tensor_perm.reshape(60)
+    llaisys_tensor_flat = llaisys_tensor_perm.reshape(60)
+    assert llaisys_tensor_flat.is_contiguous()
+    assert llaisys_tensor_flat.data_ptr() != llaisys_tensor.data_ptr()
+    assert check_equal(llaisys_tensor_flat, torch_tensor_flat)
+
+    # Test to: same device shares storage
+    print("===Test to===")
+    llaisys_tensor_to = llaisys_tensor.to(llaisys_device("cpu"))
+    assert llaisys_tensor_to.data_ptr() == llaisys_tensor.data_ptr()
+    assert check_equal(llaisys_tensor_to, torch_tensor)
+
+
+def test_interop():
+    # Test from_dlpack: borrows torch memory without copying
+    print("===Test from_dlpack===")
+    torch_tensor = torch.arange(60, dtype=torch_dtype("f32")).reshape(3, 4, 5)
+    llaisys_tensor = llaisys.Tensor.from_dlpack(torch_tensor)
+    assert llaisys_tensor.data_ptr() == torch_tensor.data_ptr()
+    assert llaisys_tensor.strides() == torch_tensor.stride()
+    torch_tensor_perm = torch_tensor.permute(2, 0, 1)
+    llaisys_tensor_perm = llaisys.Tensor.from_dlpack(torch_tensor_perm)
+    assert llaisys_tensor_perm.strides() == torch_tensor_perm.stride()
+    assert check_equal(llaisys_tensor_perm, torch_tensor_perm)
+
+    # Test __dlpack__: torch sees llaisys memory, which outlives the llaisys handle
+    print("===Test __dlpack__===")
+    llaisys_bf16 = llaisys.Tensor((4, 8), dtype=llaisys_dtype("bf16"))
+    torch_bf16 = torch.from_dlpack(llaisys_bf16)
+    assert torch_bf16.dtype == torch.bfloat16
+    assert torch_bf16.data_ptr() == llaisys_bf16.data_ptr()
+    torch_bf16.fill_(1.5)
+    del llaisys_bf16
+    assert torch.all(torch_bf16 == 1.5)
+
+    # Test __array_interface__ and from_numpy
+    print("===Test numpy===")
+    numpy_view = np.asarray(llaisys_tensor_perm)
+    assert numpy_view.ctypes.data == llaisys_tensor_perm.data_ptr()
+    assert np.array_equal(numpy_view, torch_tensor_perm.numpy())
+    numpy_array = np.arange(12, dtype=np.int64).reshape(3, 4)
+    llaisys_from_numpy = llaisys.Tensor.from_numpy(numpy_array)
+    del numpy_array
+    assert np.array_equal(np.asarray(llaisys_from_numpy), np.arange(12).reshape(3, 4))
+    read_only = np.zeros(4, dtype=np.float32)
+    read_only.flags.writeable = False
+    try:
+        llaisys.Tensor.from_numpy(read_only)
+        assert False, "from_numpy must reject read-only buffers"
+    except ValueError:
+        pass
+
 
 if __name__ == "__main__":
     test_tensor()
+    test_interop()
 
     print("\n\033[92mTest passed!\033[0m\n")
@@ -3,6 +3,9 @@ set_encodings("utf-8")
 
 add_includedirs("include")
 
+-- CPU kernels parallelize with OpenMP pragmas
+add_requires("openmp")
+
 -- CPU --
 includes("xmake/cpu.lua")
 
@@ -111,10 +114,16 @@ target("llaisys")
 
     set_languages("cxx17")
     set_warnings("all", "error")
+    add_packages("openmp")
+    if is_plat("linux") then
+        -- CPU streams run on std::thread workers
+        add_syslinks("pthread")
+    end
     add_files("src/llaisys/*.cc")
     add_files("src/llaisys/*/*.cpp")
     add_files("src/models/*/*.cpp")
     add_files("src/models/*/*/*.cpp")
+    add_files("src/loader/*/*.cpp")
     add_files("src/tokenizer/*/*.cpp")
     set_installdir(".")
 
@@ -134,4 +143,27 @@ target("llaisys")
             os.cp("lib/*.so", "python/llaisys/libllaisys/")
         end
     end)
-target_end()
\ No newline at end of file
+target_end()
+
+-- Native micro-benchmarks of the CPU kernels (not built by default):
+--   xmake build llaisys-bench && xmake run llaisys-bench --help
+target("llaisys-bench")
+    set_kind("binary")
+    set_default(false)
+    add_deps("llaisys-ops")
+
+    set_languages("cxx17")
+    set_warnings("all", "error")
+    add_packages("openmp")
+    if not is_plat("windows") then
+        add_cxflags("-Wno-unknown-pragmas")
+    end
+    if is_plat("linux") then
+        add_syslinks("pthread")
+    end
+    add_files("bench/*.cpp")
+    -- the core context resolves device runtimes through the C entry point
+    add_files("src/llaisys/runtime.cc")
+
+    on_install(function (target) end)
+target_end()
@@ -14,6 +14,7 @@ target_end()
 target("llaisys-ops-cpu")
     set_kind("static")
     add_deps("llaisys-tensor")
+    add_packages("openmp")
     set_languages("cxx17")
     set_warnings("all", "error")
     if not is_plat("windows") then